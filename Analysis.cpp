@@ -13,6 +13,64 @@
  * 28-Jan-24   CBL Might as well create the NTuple as well. 
  * 13-Feb-24       K Index ntuple
  * 14-Mar-24       Error in Day index. 
+ * 19-Oct-26   CBL Split ProcessData into read, compute and write 
+ *                 stages over RowBlocks, optionally pipelined on 
+ *                 three threads. DSEC is now filled. 
+ * 19-Oct-26   CBL StreamOutput, graphs go to disk file by file. 
+ * 19-Oct-26   CBL Checkpoint every CheckpointEvery files, resume 
+ *                 with -r/--resume. 
+ * 19-Oct-26   CBL ExtractStart/ExtractEnd, process only the rows in
+ *                 a time window using the H5Index. 
+ * 19-Oct-26   CBL Input from a cached Manifest, built from data 
+ *                 directories or the file list, replaces CountFiles.
+ *                 Histogram days sized from it. 
+ * 19-Oct-26   CBL Scheduler, row range tasks with work stealing and
+ *                 an ordered merge. 
+ * 19-Oct-26   CBL t-digest quantile sketches per time bin and per 
+ *                 day and time bin, P05/P50/P95 histograms. 
+ * 19-Oct-26   CBL Despike, median/MAD spike rejection on Mx, My, Mz
+ *                 ahead of the magnitude. DESPIKE counts per day. 
+ * 19-Oct-26   CBL PSD, Welch spectra of Mx, My, Mz and |M| per day,
+ *                 PSD_MX.. day by frequency. 
+ * 19-Oct-26   CBL SqBaseline, median of the quietest days, cached in
+ *                 SqFile. ABSMAG2D_SQ and Z2D_SQ. 
+ * 19-Oct-26   CBL Tilt, Mx, My, Mz in a level frame from the 
+ *                 accelerometer, H2D, D2D and I2D. TiltApply uses 
+ *                 the level components for Z2D, KINDEX, PSD and Sq.
+ * 19-Oct-26   CBL TempFit, one pass least squares of Mx, My, Mz on 
+ *                 Temp, coefficients kept in the TempComp group and
+ *                 applied ahead of the magnitude. 
+ * 19-Oct-26   CBL Products list, the outputs asked for resolved to 
+ *                 stages and input columns, the rest are skipped. 
+ * 19-Oct-26   CBL Sites, several PiDA series merged on Time through
+ *                 a MultiStream, differences to the first site. 
+ * 19-Oct-26   CBL Resample, rows onto a uniform time grid with gaps
+ *                 and duplicates found from UTC. ABSMAG2D and the 
+ *                 other day maps are then divided by the rows in 
+ *                 each bin, COUNT2D, not by 1 per second. COVERAGE.
+ * 19-Oct-26   CBL Rollup, per time bin sum, min, max and count of
+ *                 |M| and Z for each day, month and year, kept in 
+ *                 RollupFile and added to a day at a time. 
+ * 19-Oct-26   CBL Zones, IMUTuple flushed every ZoneCluster entries
+ *                 and the min and max of JD, DSEC, the field and 
+ *                 Temp of each cluster kept in IMUZones. 
+ * 19-Oct-26   CBL FLOAT32 build, samples are float in the blocks 
+ *                 and IMUTuple, time columns and sums stay double. 
+ * 19-Oct-26   CBL Checkpoints keep the run's file list and a resume
+ *                 over other files or another day axis is refused.
+ *                 StreamOutput forced by checkpoints is not saved. 
+ * 19-Oct-26   CBL Sq and Rollup days keyed by the block's own date, 
+ *                 and the days added so far kept in checkpoints. 
+ * 19-Oct-26   CBL Quantiles off by default. Only the open day has 
+ *                 sketches, a day is kept as its quantiles once the
+ *                 rows move to another day. 
+ * 19-Oct-26   CBL LargestFirst is ignored with Zones on. 
+ * 19-Oct-26   CBL Extract indexes from the manifest's sizes and 
+ *                 times, without a stat of each file. 
+ * 19-Oct-26   CBL fNDays for the day axis, NBins is not overwritten.
+ * 19-Oct-26   CBL Calendar from NOAA in place of YearDay. 
+ * 19-Oct-26   CBL Closed sketch days kept as centroids, a day seen
+ *                 again is merged digest to digest. 
  *
  * Classification : Unclassified
  *
@@ -29,6 +87,12 @@ using namespace std;
 #include <string>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <condition_variable>
 #include <libconfig.h++>
 using namespace libconfig;
 
@@ -38,11 +102,16 @@ using namespace libconfig;
 #include <TGraph.h>
 #include <TMultiGraph.h>
 #include <TLegend.h>
+#include <TLegendEntry.h>
 #include <TString.h>
 #include <TObjString.h>
 #include <TNtupleD.h>
 #include <TProfile.h>
+#include <TH1D.h>
 #include <TH2D.h>
+#include <TObjArray.h>
+#include <TNamed.h>
+#include <TVectorD.h>
 
 /// Local Includes.
 #include "Analysis.hh"
@@ -51,10 +120,72 @@ using namespace libconfig;
 #include "UTC2Sec.hh"
 #include "debug.h"
 #include "SFilter.hh"
-#include "YearDay.hh"
+#include "NOAA/Calendar.hh"
+#include "SPSCQueue.hh"
+#include "H5Index.hh"
+#include "Manifest.hh"
+#include "Scheduler.hh"
+#include "H5Lock.hh"
+#include "TDigest.hh"
+#include "SqBaseline.hh"
+#include "Tilt.hh"
+#include "TempFit.hh"
+#include "Products.hh"
+#include "MultiStream.hh"
+
+/// Seconds since an arbitrary start, for stage timing. 
+static inline double Now(void)
+{
+    return std::chrono::duration<double>(
+	std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// IMUTuple columns, also used when it is trimmed on resume. 
+static const char *kNtupleNames = 
+    "Time:AX:AY:AZ:GX:GY:GZ:MX:MY:MZ:Temp:Lat:Lon:Z:UTC:JD:DSEC";
+
+/// Quantile points written. 
+static const uint32_t kNQ        = 3;
+static const double   kQ[kNQ]    = {0.05, 0.50, 0.95};
+static const char    *kQName[kNQ] = {"P05", "P50", "P95"};
 
 Analysis* Analysis::fAnalysis = NULL;
 
+/// Legend label from the file name, the date part. 
+static TString FileTitle(const char *Filename)
+{
+    TString Name = Filename;
+    Ssiz_t  n1   = Name.First("202");
+    Ssiz_t  n2   = Name.Last('_');
+    return Name(n1,n2-n1);
+}
+
+/// FNV-1a over n bytes, carried on from h. 
+static uint64_t Hash64(const void *p, size_t n, uint64_t h)
+{
+    const unsigned char *c = (const unsigned char *) p;
+    for (size_t i=0; i<n; i++)
+    {
+	h ^= c[i];
+	h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/// Same bins and limits on both axes, so Add will take it. 
+static bool SameAxes(const TH1 *a, const TH1 *b)
+{
+    const TAxis *ax[2] = {a->GetXaxis(), a->GetYaxis()};
+    const TAxis *bx[2] = {b->GetXaxis(), b->GetYaxis()};
+    for (uint32_t i=0; i<2; i++)
+    {
+	if ((ax[i]->GetNbins() != bx[i]->GetNbins()) ||
+	    (ax[i]->GetXmin()  != bx[i]->GetXmin())  ||
+	    (ax[i]->GetXmax()  != bx[i]->GetXmax())) return false;
+    }
+    return true;
+}
+
 /**
  ******************************************************************
  *
@@ -62,7 +193,8 @@ Analysis* Analysis::fAnalysis = NULL;
  *
  * Description : initialize CObject variables
  *
- * Inputs : currently none. 
+ * Inputs : ConfigFile - configuration file name
+ *          Resume     - continue from the last checkpoint
  *
  * Returns : none
  *
@@ -75,7 +207,7 @@ Analysis* Analysis::fAnalysis = NULL;
  *
  *******************************************************************
  */
-Analysis::Analysis(const char* ConfigFile) : CObject()
+Analysis::Analysis(const char* ConfigFile, bool Resume) : CObject()
 {
     CLogger *Logger = CLogger::GetThis();
 
@@ -85,13 +217,77 @@ Analysis::Analysis(const char* ConfigFile) : CObject()
     SetError(); // No error.
 
     fRun           = true;
-    fInputFileList = NULL;
+    fManifest      = NULL;
+    fManifestFile  = "Manifest.txt";
+    fScanThreads   = 4;
+    fLargestFirst  = false;
+    fScheduler     = false;
+    fWorkers       = 4;
+    fTaskRows      = 262144;
+    fQuantiles     = false;
+    fSketchCompression    = 100.0;
+    fDaySketchCompression = 25.0;
+    fDespikeOn        = false;
+    fDespikeWindow    = 61;
+    fDespikeThreshold = 5.0;
+    fDespikeFloor     = 1.0;
+    fDespike          = NULL;
+    fRejected         = NULL;
+    fSpectra          = false;
+    fPSDLength        = 4096;
+    fPSDOverlap       = 0.5;
+    fPSDRate          = 1.0;
+    fWelch            = NULL;
+    fPSDSeg           = NULL;
+    fBufDay           = -1;
+    fSketchDay        = -1;
+    for (uint32_t i=0; i<kNPSD; i++) fPSD[i] = NULL;
+    fSq               = false;
+    fSqFile           = "Baseline.root";
+    fSqQuietDays      = 5;
+    fSqWindow         = 27;
+    fSqCoverage       = 0.8;
+    fBaseline         = NULL;
+    fSqKey            = -1;
+    fSqDoy            = 0;
+    fRollOn           = false;
+    fRollFile         = "Rollup.root";
+    fRollup           = NULL;
+    fRollKey          = -1;
+    fZonesOn          = false;
+    fZoneCluster      = 21600;
+    fZones            = NULL;
+    fTiltOn           = false;
+    fTiltPerSample    = false;
+    fTiltApply        = false;
+    fTilt             = NULL;
+    fH2D = fD2D = fI2D = NULL;
+    fTempFitOn        = false;
+    fTempApply        = false;
+    fTempRate         = false;
+    fTempSpan         = 60;
+    fTempRef          = 25.0;
+    fTempRows         = 0.0;
+    fTempFit          = NULL;
+    fSiteTolerance    = 0.5;
+    fSiteNtuple       = true;
+    fResampleOn       = false;
+    fResampleStep     = 1.0;
+    fResampleMaxFill  = 30;
+    fResampleFill     = "linear";
+    fResample         = NULL;
+    fCount            = NULL;
+    fCoverage         = NULL;
+    memset(fTempCoef, 0, sizeof(fTempCoef));
+    memset(fTempRMS , 0, sizeof(fTempRMS));
     fInputFileName = strdup("Default.txt");
     fRootFile      = NULL;
     fFilter        = NULL;
     ftmg           = NULL;
     fLegend        = NULL;
     fNtuple        = NULL;
+    memset(fTupleD, 0, sizeof(fTupleD));
+    memset(fTupleF, 0, sizeof(fTupleF));
     fGraph         = NULL;
     fProfile       = NULL;
     f2D            = NULL;
@@ -99,6 +295,26 @@ Analysis::Analysis(const char* ConfigFile) : CObject()
     f2DK           = NULL;
     fExpected      = 0;
     fNBins         = 10;       // Number of bins or days
+    fNDays         = fNBins;
+    fDayMin        = 0.0;
+    fPipeline      = true;
+    fBlockRows     = 4096;
+    fPipelineDepth = 8;
+    fStreamOutput  = false;
+    fStreamGraphs  = false;
+    fResume        = Resume;
+    fRefused       = false;
+    fCheckpointEvery = 0;
+    fCheckpointFile  = "Analysis.ckp.root";
+    fFilterWarmup  = 1000;
+    fStartFile     = 0;
+    fCheckpoint    = NULL;
+    fIndexFile     = "H5Index.txt";
+    fIndexStep     = 600.0;
+    fIndex         = NULL;
+    fiUTC = fiMx = fiMy = fiMz = 0;
+    fStageWall     = 0.0;
+    for (uint32_t i=0; i<kNStage; i++) fStageBusy[i] = 0.0;
 
     if(!ConfigFile)
     {
@@ -117,6 +333,15 @@ Analysis::Analysis(const char* ConfigFile) : CObject()
 
     f5InputFile = NULL;
 
+    if ((fCheckpointEvery > 0) || fResume)
+    {
+	fCheckpoint = new Checkpoint(fCheckpointFile.c_str(), fFilterWarmup);
+	if (fResume)
+	{
+	    Restore();
+	}
+    }
+
     Logger->Log("# Analysis constructed.\n");
 
     SET_DEBUG_STACK;
@@ -146,6 +371,9 @@ Analysis::~Analysis(void)
     SET_DEBUG_STACK;
     CLogger *Logger = CLogger::GetThis();
 
+    // New coefficients go out with the configuration. 
+    EndTempFit();
+
     // Do some other stuff as well. 
     if(!WriteConfiguration())
     {
@@ -155,38 +383,100 @@ Analysis::~Analysis(void)
     }
     free(fConfigFileName);
 
-    if(fInputFileList) 
-    {
-	fInputFileList->close();
-	delete fInputFileList;
-    }
+    delete fManifest;
 
     /* Clean up */
     delete f5InputFile;
     f5InputFile = NULL;
-    if (ftmg)
+    LogUtilization("Run", fStageBusy, fStageWall);
+    if (fResample)
     {
-	ftmg->Write("IMUData");
+	Logger->Log("# Resample: %ld rows, %ld filled, %ld duplicates, "
+		    "%ld gaps, %ld breaks.\n", 
+		    (long) fResample->Rows(), (long) fResample->Filled(),
+		    (long) fResample->Duplicates(), (long) fResample->Gaps(),
+		    (long) fResample->Breaks());
     }
-    else
+    if (fRefused)
     {
-	fGraph->Write("IMUData");     // flush this. 
+	// Output as the checkpoint left it. 
+	Logger->Log("# Resume refused, %s not written.\n", 
+		    fOutputFileName.c_str());
+    }
+    else if (fRootFile)
+    {
+	WriteOutput();
     }
-    fLegend->Write("IMULegend");
-
 
     /* close root file. */
-    fRootFile->Write();
-    fRootFile->Close();
+    if (fRootFile) fRootFile->Close();
     delete fRootFile;
     fRootFile = NULL;
 
     delete fFilter;
+    delete fCheckpoint;
+    delete fDespike;
+    delete fWelch;
+    delete fBaseline;
+    delete fRollup;
+    delete fZones;
+    delete fTilt;
+    delete fTempFit;
+    delete fResample;
+    delete fIndex;
 
     // Make sure all file streams are closed
     Logger->Log("# Analysis closed.\n");
     SET_DEBUG_STACK;
 }
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteOutput
+ *
+ * Description : Graphs, legend and the end of run products to the
+ *               root file, then the file itself. On resume what 
+ *               was there is replaced. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::WriteOutput(void)
+{
+    SET_DEBUG_STACK;
+    if (fStreamGraphs)
+    {
+	WriteGraphIndex();
+    }
+    else if (ftmg)
+    {
+	ftmg->Write("IMUData");
+    }
+    else if (fGraph)
+    {
+	fGraph->Write("IMUData");     // flush this. 
+    }
+    if (fLegend) fLegend->Write("IMULegend");
+    WriteQuantiles();
+    WriteSpectra();
+    WriteBaseline();
+    WriteRollup();
+    NormalizeCounts();
+    if (fZones) fZones->Write(fRootFile);
+
+    fRootFile->Write(0, fResume ? TObject::kOverwrite : 0);
+    SET_DEBUG_STACK;
+}
 /**
  ******************************************************************
  *
@@ -222,9 +512,15 @@ bool Analysis::OpenOutputFile(const char *Filename)
      * We just need to initialize it. 
      */
     ::new TROOT("HDF5","HDF5 Data analysis");
+    if (fPipeline)
+    {
+	// Histograms and the ntuple are filled from different threads.
+	ROOT::EnableThreadSafety();
+    }
 
-    /* Create disk file */
-    fRootFile = new TFile( Filename, "RECREATE","generic data analysis");
+    /* Create disk file, or continue the one being resumed. */
+    fRootFile = new TFile( Filename, fResume ? "UPDATE" : "RECREATE",
+			   "generic data analysis");
     fRootFile->cd();
     Logger->LogTime(" Output file %s opened.\n", Filename);
 
@@ -257,10 +553,42 @@ bool Analysis::OpenOutputFile(const char *Filename)
 bool Analysis::CreateNTuple(void)
 {
     SET_DEBUG_STACK;
-    const char *Names="Time:AX:AY:AZ:GX:GY:GZ:MX:MY:MZ:Temp:Lat:Lon:Z:UTC:JD:DSEC";
-    fNtuple = new TNtupleD("IMUTuple", "Raspberry Pi DA", Names);
+    if (fResume && fProducts.Has(Products::kNtuple))
+    {
+	// Restore trims it back to the checkpoint. 
+	fNtuple = (TTree *) fRootFile->Get("IMUTuple");
+	// Only a TNtupleD is double, and only a double build writes one.
+	if (fNtuple && (fNtuple->InheritsFrom("TNtupleD") != 
+			(sizeof(Sample_t) == sizeof(double))))
+	{
+	    CLogger::GetThis()->Log("# IMUTuple is from a %s build, "
+				    "it is started over.\n", 
+				    fNtuple->InheritsFrom("TNtupleD") ? 
+				    "double" : "FLOAT32");
+	    delete fNtuple;
+	    fRootFile->Delete("IMUTuple;*");
+	    fNtuple = NULL;
+	}
+	else if (fNtuple)
+	{
+	    BindTuple(fNtuple, false);
+	}
+    }
+    if ((fNtuple == NULL) && fProducts.Has(Products::kNtuple))
+    {
+	fNtuple = NewTuple("IMUTuple");
+    }
+    if (fNtuple && fZonesOn)
+    {
+	// A cluster on disk is a zone. Restore rebuilds them on resume.
+	fNtuple->SetAutoFlush(fZoneCluster);
+	fZones = new ZoneMap(fZoneCluster);
+    }
 
-    Double_t XMax = (Double_t) fNBins;
+    Int_t    NBins = fNBins;
+    Double_t XMin  = 0.0;
+    Double_t XMax  = (Double_t) fNBins;
+    int32_t  DayFirst, DayLast;
 
     /*
      *  Create 2D plot as well. 
@@ -271,19 +599,118 @@ bool Analysis::CreateNTuple(void)
      * fExpected was a good way to specify the limits on X when
      * we were plotting against file number, but when plotting against 
      * real day this does not work. Try something different. 
+     *
+     * The manifest has the header date of every file, use the 
+     * days actually present. NBins only if that is not known. 
      */
-    fExpected = CountFiles();
-    f2D = new TH2D("ABSMAG2D","Day by Day ABSMAG", 
-		   fNBins, 0.0, XMax,    // Day is X
-		   kNTimeBin, 0.0, (double) kSecPerDay);  // Time is Y
-
-    f2DZ = new TH2D("Z2D","Day by Day Z high res", 
-		    fNBins, 0.0, XMax,    // Day is X
-		    kNTimeBin, 0.0, (double) kSecPerDay);  // Time is Y
+    fExpected = fManifest->Size();
+    if (fManifest->DayRange(DayFirst, DayLast))
+    {
+	NBins = DayLast - DayFirst + 1;
+	XMin  = (Double_t) DayFirst;
+	XMax  = (Double_t) (DayLast + 1);
+    }
+    // One day per bin, the other day maps use the same axis. NBins
+    // in the configuration is left as the user set it. 
+    fNDays  = NBins;
+    fDayMin = XMin;
+    if (fProducts.Has(Products::kAbsMag2D))
+    {
+	f2D = new TH2D("ABSMAG2D","Day by Day ABSMAG", 
+		       NBins, XMin, XMax,    // Day is X
+		       kNTimeBin, 0.0, (double) kSecPerDay);  // Time is Y
+    }
+    if (fProducts.Has(Products::kZ2D))
+    {
+	f2DZ = new TH2D("Z2D","Day by Day Z high res", 
+			NBins, XMin, XMax,    // Day is X
+			kNTimeBin, 0.0, (double) kSecPerDay);  // Time is Y
+    }
+    if (fProducts.Has(Products::kKIndex))
+    {
+	f2DK = new TH2D("KINDEX", "K index day by day", 
+			NBins, XMin, XMax,    // Day is X
+			8, 0.0,  (double) kSecPerDay);
+    }
 
-    f2DK = new TH2D("KINDEX", "K index day by day", 
-		   fNBins, 0.0, XMax,    // Day is X
-		    8, 0.0,  (double) kSecPerDay);
+    if (fDespikeOn)
+    {
+	fRejected = new TH1D("DESPIKE", "Samples despiked per day", 
+			     NBins, XMin, XMax);
+	fDespike  = new Despike(fDespikeWindow, fDespikeThreshold, 
+				fDespikeFloor);
+    }
+    if (fQuantiles)
+    {
+	/*
+	 * No memory is taken until a bin gets data. Only one day has 
+	 * sketches, about 700 kB, a closed day keeps its packed 
+	 * centroids, at most about 2*DaySketchCompression pairs a 
+	 * time bin. 
+	 */
+	fSketch.assign(kNTimeBin, TDigest(fSketchCompression));
+	fDaySketch.assign(kNTimeBin, TDigest(fDaySketchCompression));
+	fDayPacked.assign(NBins*kNTimeBin, vector<double>());
+    }
+    if (fSpectra)
+    {
+	const char *Name[kNPSD] = {"MX", "MY", "MZ", "MAG"};
+	fWelch = new Welch(fPSDLength, fPSDOverlap, fPSDRate);
+	// Bin k is centered on k*df, 0 to Nyquist. 
+	double df = fWelch->Resolution();
+	for (uint32_t i=0; i<kNPSD; i++)
+	{
+	    fPSD[i] = new TH2D(Form("PSD_%s", Name[i]), 
+			       Form("Day by Day PSD %s", Name[i]), 
+			       NBins, XMin, XMax,   // Day is X
+			       fWelch->NBins(), -0.5*df, 
+			       (fWelch->NBins() - 0.5)*df); // Hz is Y
+	    fDayBuf[i].reserve(kSecPerDay);
+	}
+	fPSDSeg = new TH1D("PSD_NSEG", "PSD segments per day", 
+			   NBins, XMin, XMax);
+    }
+    if (fTiltOn)
+    {
+	fTilt = new Tilt(fTiltPerSample);
+	fH2D  = new TH2D("H2D", "Day by Day H", 
+			 NBins, XMin, XMax, kNTimeBin, 0.0, (double) kSecPerDay);
+	fD2D  = new TH2D("D2D", "Day by Day declination", 
+			 NBins, XMin, XMax, kNTimeBin, 0.0, (double) kSecPerDay);
+	fI2D  = new TH2D("I2D", "Day by Day inclination", 
+			 NBins, XMin, XMax, kNTimeBin, 0.0, (double) kSecPerDay);
+    }
+    if (fTempFitOn)
+    {
+	fTempFit = new TempFit(fTempRate, fTempRef);
+    }
+    if (fResampleOn)
+    {
+	fResample = new Resampler(fResampleStep, fResampleMaxFill, 
+				  Resampler::Mode(fResampleFill.c_str()));
+	fRaw.Resize(fBlockRows);
+	fCount    = new TH2D("COUNT2D", "Rows per day and time bin", 
+			     NBins, XMin, XMax, 
+			     kNTimeBin, 0.0, (double) kSecPerDay);
+	fCoverage = new TH2D("COVERAGE", "Fraction of each bin measured", 
+			     NBins, XMin, XMax, 
+			     kNTimeBin, 0.0, (double) kSecPerDay);
+    }
+    if (fSq)
+    {
+	fBaseline = new SqBaseline(fSqFile.c_str(), kNTimeBin, fSqQuietDays,
+				   fSqWindow, fSqCoverage);
+	fBaseline->Read();
+	fSqSumMag.assign(kNTimeBin, 0.0);
+	fSqSumZ.assign(kNTimeBin, 0.0);
+	fSqCount.assign(kNTimeBin, 0.0);
+    }
+    if (fRollOn)
+    {
+	fRollup = new Rollup(fRollFile.c_str(), kNTimeBin);
+	fRollup->Read();
+	FlushRollup();
+    }
     SET_DEBUG_STACK;
     return true;
 }
@@ -291,15 +718,16 @@ bool Analysis::CreateNTuple(void)
 /**
  ******************************************************************
  *
- * Function Name : Do
+ * Function Name : NewTuple
  *
- * Description :
+ * Description : An empty IMUTuple, a TNtupleD, or with FLOAT32 a
+ *               TTree with float sample and double time branches.
  *
- * Inputs :
+ * Inputs : Name - tree name
  *
- * Returns :
+ * Returns : the tree, in the current directory
  *
- * Error Conditions :
+ * Error Conditions : none
  * 
  * Unit Tested on: 
  *
@@ -308,83 +736,31 @@ bool Analysis::CreateNTuple(void)
  *
  *******************************************************************
  */
-void Analysis::Do(void)
+TTree* Analysis::NewTuple(const char *Name)
 {
-    SET_DEBUG_STACK;
-    CLogger *pLogger = CLogger::GetThis();
-    char     Filename[256];
-    TString  Name, Result, ProfName;        // stripped down name
-    char     tmp[32];
-    Ssiz_t   n1, n2;
-
-    fRun = true;
-
-    // Create initial TGraph for the data
-    fGraph = new TGraph();
-    fGraph->SetTitle("IMU Data");
-
-    fProfile = new TProfile("ABSMAG", "Absolute Magnitude", 
-			    kNTimeBin, 0.0, (double)kSecPerDay, 80.0, 90.0);
-
-    fLegend = new TLegend(0.1, 0.1, 0.5, 0.4);
-
-    // Loop over input file name until there are no more. 
-    for (UInt_t i=0; i<fExpected; i++)
-    {
-	memset( Filename, 0, sizeof(Filename));
-
-	fInputFileList->getline( Filename, sizeof(Filename),'\n');
-	cout << "Input: " << Filename << ", count: " << i << endl;
-	fRun = (strlen(Filename)>0);
-	if (fRun)
-	{
-	    Name   = Filename;
-	    n1     = Name.First("202");
-	    n2     = Name.Last('_');
-	    Result = Name(n1,n2-n1);
-	    snprintf(tmp, sizeof(tmp), "IMU%d",i);
-	    ProfName = tmp;
-	    fProfile->SetTitle(Result);
-
-	    // Process. 
-	    if(OpenInputFile(Filename))
-	    {
-		/* Log that this was done in the local text log file. */
-		pLogger->LogTime("File - number: %d, name: %s\n", i, Filename);
-
-		// Loop over data, process it and then close the input file. 
-		ProcessData(i);
-		delete f5InputFile;
-		f5InputFile = NULL;
-		if (ftmg)
-		{
-		    fGraph->SetTitle(Result);
-		    ftmg->Add(fGraph); 
-		    fLegend->AddEntry(fGraph, Result);
-		    // Create a new graph
-		    fGraph = new TGraph();
-		    fGraph->SetMarkerColor(i);
-		    fGraph->SetLineColor(i);
-		}
-		fProfile->Write(ProfName);
-		fProfile->Reset();
-	    }
-	}
-    }
-    SET_DEBUG_STACK;
+#ifdef FLOAT32
+    TTree *T = new TTree(Name, "Raspberry Pi DA");
+    BindTuple(T, true);
+    return T;
+#else
+    return new TNtupleD(Name, "Raspberry Pi DA", kNtupleNames);
+#endif
 }
 /**
  ******************************************************************
  *
- * Function Name : ProcessData
+ * Function Name : BindTuple
  *
- * Description : for each file, process the data. 
+ * Description : Branches of a FLOAT32 IMUTuple on fTupleD and 
+ *               fTupleF, named as kNtupleNames. 
  *
- * Inputs : count - file number currently being processed. 
+ * Inputs : T    - tree
+ *          Make - true to make the branches, false to set the 
+ *                 addresses of those in a tree read back
  *
- * Returns : NONE
+ * Returns : none
  *
- * Error Conditions :
+ * Error Conditions : a TNtupleD has its own buffer and is left be
  * 
  * Unit Tested on: 
  *
@@ -393,241 +769,2668 @@ void Analysis::Do(void)
  *
  *******************************************************************
  */
-bool Analysis::ProcessData(uint32_t count)
+void Analysis::BindTuple(TTree *T, bool Make)
 {
-    SET_DEBUG_STACK;
-    const double KWeight = 3.0 * 3600.0;    // 1 sec per interval, 3 hour bins
-    const double KStation = 400.0/4900.0/2.0; 
-    CLogger *pLogger = CLogger::GetThis();
-    const double   *var;        // get a row at a time from H5 file
-    double         varcpy[16];
-    double         MTotal, FVal;
-    double         T, X, Y, Z;
-    //struct tm      *tmnow;
-    //time_t         sec;
-    // This assumes a 1/sec sample rate. 
-    double         Norm = ((double)kSecPerDay)/((double) kNTimeBin);
-    //double         Day  = (double) count;
-    double         W;   // Actual bin value
-    double         KIndex;
-    
-
-
-    // number of entries in the file. 
-    size_t N = f5InputFile->NEntries();
-    pLogger->LogTime("Processing: %d Entries. count: %d\n", N, count);
-
-    //time_t   iTime = f5InputFile->IndexFromName("Time");
-    int32_t  iUTC  = f5InputFile->IndexFromName("UTC");
-    uint32_t iMx   = f5InputFile->IndexFromName("Mx");
-    uint32_t iMy   = f5InputFile->IndexFromName("My");
-    uint32_t iMz   = f5InputFile->IndexFromName("Mz");
-
-
-    /*
-     * Get the date information from the header file. 
-     * This will be in the form of something like:
-     * "2024-02-12 02:43:44"
-     */
-    const char *Date = f5InputFile->HeaderInfo( H5Logger::kDATE);
-    struct tm *rv    = f5InputFile->H5ParseTime((const char *)Date);
-    double Day       = (Double_t)rv->tm_yday;
-    pLogger->LogTime("Date: %s, Day in Year: %f\n", Date, Day);
+    string Names(kNtupleNames), Name;
+    size_t Start = 0, End;
 
-    for (size_t i=0 ;i<N; i++)
-    {
-	if(f5InputFile->DatasetReadRow(i))
-	{
-	    var = f5InputFile->RowData();
-	    //sec = (time_t) var[iTime];
-	    //tmnow = gmtime(&sec);
-	    T = UTC2Sec(var[iUTC]);
-	    X = var[iMx];
-	    Y = var[iMy];
-	    Z = var[iMz];
-	    MTotal = sqrt(X*X + Y*Y + Z*Z);
-	    FVal   = fFilter->Filter(MTotal);
-	    fGraph->AddPoint(T, FVal);
-	    fProfile->Fill(T,MTotal);
-	    memcpy(varcpy, var, 15*sizeof(double));
-	    // convert UTC HHMMSS.ss into sssss
-	    varcpy[14] = UTC2Sec(var[14]);
-	    varcpy[15] = Day;   // start with Jan 1 is JD 1. 
-	    if (fNtuple) fNtuple->Fill(varcpy);
-
-	    W = MTotal/Norm;
-	    /* 
-	     * Updating from day based on file count
-	     * to Day of year. 
-	     */
-	    f2D->Fill (Day, T, W);
-	    f2DZ->Fill(Day, T, Z/Norm);
-	    /*
-	     *  Not worrying about the K number right now. 
-	     * should be something like this 
-	     * 
-	     * K  0  1  2   3   4   5   6    7    8    9
-	     * ak 0  3  7  15  27  48  80  140  240  400 (nT)
-	     *
-	     * Factor for lowest value of nT measured. 
-	     * Full scale is: 4900 T over 16 bits
-	     * 74.8nT. 
-	     * Oh yeah and is only Z component. 
-	     * Think it goes like this, 9 is 400nT. 
-	     * KStation = 400.0/4900.0/2.0 
-	     *
-	     */
-	    KIndex = Z/KWeight * KStation;
-	    f2DK->Fill(Day, T, KIndex);
+    if (T->InheritsFrom("TNtupleD")) return;
+    for (uint32_t c=0; c<RowBlock::kNTupleCol; c++)
+    {
+	End   = Names.find(':', Start);
+	Name  = Names.substr(Start, End - Start);
+	Start = End + 1;
+	if (RowBlock::IsTime(c))
+	{
+	    if (Make) T->Branch(Name.c_str(), &fTupleD[c], 
+				(Name + "/D").c_str());
+	    else      T->SetBranchAddress(Name.c_str(), &fTupleD[c]);
+	}
+	else
+	{
+	    if (Make) T->Branch(Name.c_str(), &fTupleF[c], 
+				(Name + "/F").c_str());
+	    else      T->SetBranchAddress(Name.c_str(), &fTupleF[c]);
 	}
     }
-
-    SET_DEBUG_STACK;
-    return true;
 }
-
 /**
  ******************************************************************
  *
- * Function Name : OpenInputFile
+ * Function Name : FillTuple
  *
- * Description : Open and manage the HDF5 Input file
+ * Description : One row into an IMUTuple from NewTuple.
  *
- * Inputs : Filename to open
+ * Inputs : T   - tree
+ *          row - kNTupleCol values
  *
- * Returns : true on success
+ * Returns : none
  *
- * Error Conditions : File doesn't exist
+ * Error Conditions : none
  * 
- * Unit Tested on:  
+ * Unit Tested on: 
  *
  * Unit Tested by: CBL
  *
  *
  *******************************************************************
  */
-bool Analysis::OpenInputFile(const char *Filename)
+void Analysis::FillTuple(TTree *T, const double *row)
 {
-    SET_DEBUG_STACK;
-    CLogger *pLogger = CLogger::GetThis();
-
-    /*
-     * open in read only mode. 
-     */
-    f5InputFile = new H5Logger( Filename, NULL, 0, true);
-    if (f5InputFile->CheckError())
+#ifdef FLOAT32
+    for (uint32_t c=0; c<RowBlock::kNTupleCol; c++)
     {
-	pLogger->Log("# Failed to open H5 input file: %s\n", Filename);
-	delete f5InputFile;
-	f5InputFile = NULL;
-	return false;
+	if (RowBlock::IsTime(c)) fTupleD[c] = row[c];
+	else                     fTupleF[c] = (float) row[c];
     }
-    return true;
+    T->Fill();
+#else
+    ((TNtupleD *) T)->Fill(row);
+#endif
 }
 /**
  ******************************************************************
  *
- * Function Name : CountFiles
+ * Function Name : TupleRow
  *
- * Description : Count the number of files on the input side
+ * Description : Entry i of an IMUTuple as doubles.
  *
- * Inputs : none
+ * Inputs : T   - tree
+ *          i   - entry
+ *          row - returned, kNTupleCol values
  *
- * Returns : NONE
+ * Returns : none
  *
- * Error Conditions : NONE
+ * Error Conditions : none
  * 
- * Unit Tested on:  
+ * Unit Tested on: 
  *
  * Unit Tested by: CBL
  *
  *
  *******************************************************************
  */
-uint32_t Analysis::CountFiles(void)
+void Analysis::TupleRow(TTree *T, int64_t i, double *row)
 {
-    SET_DEBUG_STACK;
-    CLogger *pLogger = CLogger::GetThis();
-    uint32_t count   = 0;
-    char     Filename[256];
-    bool     Run     = true;
-    
-    /*
-     * file is already open, read all the lines and increment the 
-     * count then return it. 
-     */
-    while(Run)
+    T->GetEntry(i);
+#ifdef FLOAT32
+    for (uint32_t c=0; c<RowBlock::kNTupleCol; c++)
     {
-	fInputFileList->getline( Filename, sizeof(Filename),'\n');
-	Run = (strlen(Filename)>0);
-	if (Run) count++;
+	row[c] = RowBlock::IsTime(c) ? fTupleD[c] : (double) fTupleF[c];
     }
-    // Rewind the file. 
-    fInputFileList->clear();  // new! Should have been true all along. 
-    fInputFileList->seekg(ios_base::beg);
-    cout << "position: " << fInputFileList->tellg() << endl;
-    pLogger->LogTime("Number input files expected: %d\n", count);
-    SET_DEBUG_STACK;
-    return count;
+#else
+    memcpy(row, ((TNtupleD *) T)->GetArgs(), 
+	   RowBlock::kNTupleCol*sizeof(double));
+#endif
 }
 /**
  ******************************************************************
  *
- * Function Name : ReadConfiguration
+ * Function Name : Do
  *
- * Description : Open read the configuration file. 
+ * Description :
  *
- * Inputs : none
+ * Inputs :
  *
- * Returns : NONE
+ * Returns :
  *
- * Error Conditions : NONE
+ * Error Conditions :
  * 
- * Unit Tested on:  
+ * Unit Tested on: 
  *
  * Unit Tested by: CBL
  *
  *
  *******************************************************************
  */
-bool Analysis::ReadConfiguration(void)
+void Analysis::Do(void)
 {
     SET_DEBUG_STACK;
-    CLogger *Logger = CLogger::GetThis();
-    ClearError(__LINE__);
-    Config *pCFG = new Config();
-    string InputFile;
-    double CutoffFrequency, SampleRate;
-    bool   multi  = false;
+    CLogger *pLogger = CLogger::GetThis();
+    const char *Filename;
+    TString  Result, ProfName;        // stripped down name
+    char     tmp[32];
+    uint32_t k;
+    vector<uint32_t> Order = RunOrder();
 
-    /*
-     * Open the configuragtion file. 
-     */
-    try{
-	pCFG->readFile(fConfigFileName);
+    fRun = true;
+    if (fLargestFirst && fZonesOn)
+    {
+	pLogger->Log("# Zones on, LargestFirst ignored, files by date.\n");
     }
-    catch( const FileIOException &fioex)
+
+    if (fProducts.Has(Products::kGraph))
     {
-	Logger->LogError(__FILE__,__LINE__,'F',
-			 "I/O error while reading configuration file.\n");
-	return false;
+	// Create initial TGraph for the data
+	fGraph = new TGraph();
+	fGraph->SetTitle("IMU Data");
+	fLegend = new TLegend(0.1, 0.1, 0.5, 0.4);
     }
-    catch (const ParseException &pex)
+    if (fProducts.Has(Products::kProfile))
     {
-	Logger->Log("# Parse error at: %s : %d - %s\n",
-		    pex.getFile(), pex.getLine(), pex.getError());
-	return false;
+	fProfile = new TProfile("ABSMAG", "Absolute Magnitude", 
+				kNTimeBin, 0.0, (double)kSecPerDay, 80.0, 90.0);
     }
 
+    // Blocks passed between stages. One is enough when serial. 
+    fBlocks.resize(fPipeline ? fPipelineDepth : 1);
+    for (size_t i=0; i<fBlocks.size(); i++) fBlocks[i].Resize(fBlockRows);
 
-    /*
-     * Start at the top. 
-     */
-    const Setting& root = pCFG->getRoot();
+    if (fSites.size() > 1)
+    {
+	RunSites();
+	SET_DEBUG_STACK;
+	return;
+    }
+    if (fExtractStart.length() > 0)
+    {
+	Extract();
+	SET_DEBUG_STACK;
+	return;
+    }
 
-    // USER TO FILL IN
-    // Output a list of all books in the inventory.
-    try
+    // k is the file number in the manifest and names the output, 
+    // i is the position in the run. 
+    if (fScheduler)
+    {
+	RunScheduled(Order);
+	SET_DEBUG_STACK;
+	return;
+    }
+
+    // Loop over input files until there are no more. 
+    for (UInt_t i=0; (i<fExpected) && fRun; i++)
+    {
+	if (i < fStartFile) continue;      // Done before the checkpoint
+	k        = Order[i];
+	Filename = fManifest->Entry(k).fName.c_str();
+	cout << "Input: " << Filename << ", count: " << k << endl;
+	Result = FileTitle(Filename);
+	snprintf(tmp, sizeof(tmp), "IMU%d",k);
+	ProfName = tmp;
+	if (fProfile) fProfile->SetTitle(Result);
+
+	// Process. 
+	if(OpenInputFile(Filename))
+	{
+	    /* Log that this was done in the local text log file. */
+	    pLogger->LogTime("File - number: %d, name: %s\n", k, Filename);
+
+	    // Loop over data, process it and then close the input file. 
+	    ProcessData(k);
+	    delete f5InputFile;
+	    f5InputFile = NULL;
+	    EndFile(k, Result, ProfName);
+	}
+	// Only if the file was not cut short by Stop. 
+	if (fRun && fCheckpoint && (fCheckpointEvery > 0) &&
+	    ((((i+1) % fCheckpointEvery) == 0) || ((i+1) == fExpected)))
+	{
+	    SaveCheckpoint(i+1);
+	}
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : EndFile
+ *
+ * Description : Output after each input file, graph and profile. 
+ *
+ * Inputs : count    - file number
+ *          Title    - legend label
+ *          ProfName - key for the profile
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::EndFile(uint32_t count, const char *Title, 
+		       const char *ProfName)
+{
+    SET_DEBUG_STACK;
+    if (fGraph == NULL)
+    {
+	// No graph product. 
+    }
+    else if (fStreamGraphs)
+    {
+	StreamGraph(count, Title);
+    }
+    else if (ftmg)
+    {
+	fGraph->SetTitle(Title);
+	ftmg->Add(fGraph); 
+	fLegend->AddEntry(fGraph, Title);
+	// Create a new graph
+	fGraph = new TGraph();
+	fGraph->SetMarkerColor(count);
+	fGraph->SetLineColor(count);
+    }
+    if (fProfile)
+    {
+	fProfile->Write(ProfName);
+	fProfile->Reset();
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Extract
+ *
+ * Description : Process only the rows between ExtractStart and 
+ *               ExtractEnd. The index gives the files that overlap
+ *               the window, only those are opened and only the 
+ *               rows in the window are read. The index is built
+ *               from the manifest's sizes and times, a file is only
+ *               opened if its cache entry is stale. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : bad window
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::Extract(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    double   Start   = H5Index::ParseTime(fExtractStart.c_str());
+    double   End     = H5Index::ParseTime(fExtractEnd.c_str());
+    char     tmp[32];
+    vector<H5IndexEntry> Files(fExpected);
+    vector<uint32_t> Overlap;
+    size_t   First, Last;
+    TString  Result;
+
+    if ((Start < 0.0) || (End <= Start))
+    {
+	pLogger->Log("# Bad extract window %s to %s\n", 
+		     fExtractStart.c_str(), fExtractEnd.c_str());
+	return;
+    }
+    // The manifest has stat'ed them, the index need not again. 
+    for (uint32_t i=0; i<fExpected; i++)
+    {
+	Files[i].fName  = fManifest->Entry(i).fName;
+	Files[i].fMTime = fManifest->Entry(i).fMTime;
+	Files[i].fSize  = fManifest->Entry(i).fSize;
+    }
+    fIndex = new H5Index(fIndexStep);
+    fIndex->Build(Files, fIndexFile.c_str());
+    fIndex->Overlap(Start, End, Overlap);
+    pLogger->LogTime("Extract %s to %s, %d files.\n", fExtractStart.c_str(),
+		     fExtractEnd.c_str(), (int) Overlap.size());
+
+    for (size_t j=0; (j<Overlap.size()) && fRun; j++)
+    {
+	uint32_t i = Overlap[j];
+	const H5IndexEntry &E = fIndex->Entry(i);
+	if (!OpenInputFile(E.fName.c_str())) continue;
+	if (fIndex->Rows(i, f5InputFile, Start, End, First, Last))
+	{
+	    pLogger->LogTime("File - number: %d, name: %s, rows %ld to %ld\n", 
+			     i, E.fName.c_str(), (long) First, (long) Last);
+	    Result = FileTitle(E.fName.c_str());
+	    if (fProfile) fProfile->SetTitle(Result);
+	    snprintf(tmp, sizeof(tmp), "IMU%d",i);
+
+	    ProcessData(i, First, Last);
+	    EndFile(i, Result, tmp);
+	}
+	delete f5InputFile;
+	f5InputFile = NULL;
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : RunSites
+ *
+ * Description : Each site gets its own manifest, cached as 
+ *               Manifest_<Name>.txt, and a SiteStream over its 
+ *               files. The MultiStream gives aligned sets, and 
+ *               every set with the first site in it gives one pair
+ *               for each other site present. Pairs are collected 
+ *               into blocks of BlockRows, the differences done a 
+ *               column at a time, then filled: 
+ *               SiteDiff - Time:Site:DMX:DMY:DMZ:DMAG, if SiteNtuple
+ *               DIFF2D_<first>_<site> - day by time, DMAG, binned 
+ *               like ABSMAG2D. 
+ *               Memory is a block per site and one of pairs. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : sites with no files are logged and left out
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::RunSites(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    const double Norm = ((double)kSecPerDay)/((double) kNTimeBin);
+    MultiStream  MS(fSiteTolerance);
+    vector<SiteSample> Set;
+    vector<TH2D*> Diff;
+    vector<uint64_t> NPair;
+    TNtupleD    *Nt = NULL;
+    int32_t      DayFirst = INT32_MAX, DayLast = INT32_MIN, F, L;
+    uint32_t     Mask;
+    uint64_t     NSet = 0;
+    struct tm    tm;
+    time_t       t;
+
+    // Pairs of the current block, first site A, other site B. 
+    const size_t Rows = fBlockRows;
+    vector<double> PT(Rows), PS(Rows), A[3], B[3], D[4];
+    size_t         n = 0;
+    for (uint32_t c=0; c<3; c++) {A[c].resize(Rows); B[c].resize(Rows);}
+    for (uint32_t c=0; c<4; c++) D[c].resize(Rows);
+
+    for (size_t i=0; i<fSites.size(); i++)
+    {
+	string   Cache = "Manifest_" + fSites[i].fName + ".txt";
+	Manifest M(Cache.c_str(), fScanThreads);
+	vector<string> Files;
+	if (fSites[i].fDirs.size() > 0) M.AddDirectories(fSites[i].fDirs);
+	if (fSites[i].fList.length() > 0) M.AddList(fSites[i].fList.c_str());
+	M.Build();
+	for (size_t j=0; j<M.Size(); j++) Files.push_back(M.Entry(j).fName);
+	if (Files.empty())
+	{
+	    pLogger->Log("# Site %s has no files, left out.\n", 
+			 fSites[i].fName.c_str());
+	    continue;
+	}
+	if (M.DayRange(F, L))
+	{
+	    DayFirst = std::min(DayFirst, F);
+	    DayLast  = std::max(DayLast, L);
+	}
+	MS.Add(new SiteStream(fSites[i].fName.c_str(), Files, fBlockRows));
+    }
+    if (MS.NSites() < 2)
+    {
+	pLogger->Log("# Fewer than two sites with data, nothing to pair.\n");
+	return;
+    }
+
+    fRootFile->cd();
+    if (fSiteNtuple)
+    {
+	Nt = new TNtupleD("SiteDiff", "Site less the first site", 
+			  "Time:Site:DMX:DMY:DMZ:DMAG");
+    }
+    Diff.assign(MS.NSites(), (TH2D *) NULL);
+    NPair.assign(MS.NSites(), 0);
+    for (size_t s=1; s<MS.NSites(); s++)
+    {
+	Diff[s] = new TH2D(Form("DIFF2D_%s_%s", MS.Site(0).Name().c_str(),
+				MS.Site(s).Name().c_str()),
+			   Form("%s less %s, |M|", MS.Site(s).Name().c_str(), 
+				MS.Site(0).Name().c_str()),
+			   DayLast - DayFirst + 1, (double) DayFirst, 
+			   (double) (DayLast + 1),
+			   kNTimeBin, 0.0, (double) kSecPerDay);
+    }
+
+    auto Flush = [&]()
+    {
+	double Row[6], MA, MB;
+	for (size_t i=0; i<n; i++)
+	{
+	    D[0][i] = B[0][i] - A[0][i];
+	    D[1][i] = B[1][i] - A[1][i];
+	    D[2][i] = B[2][i] - A[2][i];
+	    MA = sqrt(A[0][i]*A[0][i] + A[1][i]*A[1][i] + A[2][i]*A[2][i]);
+	    MB = sqrt(B[0][i]*B[0][i] + B[1][i]*B[1][i] + B[2][i]*B[2][i]);
+	    D[3][i] = MB - MA;
+	}
+	for (size_t i=0; i<n; i++)
+	{
+	    t = (time_t) PT[i];
+	    gmtime_r(&t, &tm);
+	    Diff[(size_t) PS[i]]->Fill((double) tm.tm_yday, 
+				       fmod(PT[i], (double) kSecPerDay),
+				       D[3][i]/Norm);
+	    if (Nt)
+	    {
+		Row[0] = PT[i];
+		Row[1] = PS[i];
+		for (uint32_t c=0; c<4; c++) Row[2+c] = D[c][i];
+		Nt->Fill(Row);
+	    }
+	}
+	n = 0;
+    };
+
+    while (fRun && MS.Next(Set, Mask))
+    {
+	NSet++;
+	if ((Mask & 1U) == 0) continue;     // No reference sample
+	for (uint32_t s=1; s<MS.NSites(); s++)
+	{
+	    if ((Mask & (1U << s)) == 0) continue;
+	    PT[n] = Set[0].fTime;
+	    PS[n] = s;
+	    for (uint32_t c=0; c<3; c++)
+	    {
+		A[c][n] = Set[0].fM[c];
+		B[c][n] = Set[s].fM[c];
+	    }
+	    NPair[s]++;
+	    if (++n == Rows) Flush();
+	}
+    }
+    Flush();
+
+    pLogger->LogTime("Sites: %ld sets.\n", (long) NSet);
+    for (size_t s=0; s<MS.NSites(); s++)
+    {
+	pLogger->Log("# Site %s, %ld pairs, %ld rows dropped out of order.\n",
+		     MS.Site(s).Name().c_str(), (long) NPair[s], 
+		     (long) MS.Site(s).Dropped());
+    }
+    // Written with the rest of the output file. 
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : NormalizeCounts
+ *
+ * Description : Resampled, ABSMAG2D, Z2D, H2D, D2D and I2D hold 
+ *               sums. Divide each by COUNT2D for the mean per bin,
+ *               the actual rows rather than 1 per second. Bins with
+ *               no rows are left 0. KINDEX is a sum and stays one.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::NormalizeCounts(void)
+{
+    SET_DEBUG_STACK;
+    TH2D *Hist[5] = {f2D, f2DZ, fH2D, fD2D, fI2D};
+
+    if (fCount == NULL) return;
+    for (uint32_t i=0; i<5; i++)
+    {
+	if (Hist[i]) Hist[i]->Divide(fCount);
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : StreamGraph
+ *
+ * Description : Streaming output. Write the graph for the file just
+ *               processed to the root file and free it so memory 
+ *               does not grow with the number of days. Only the
+ *               key, title and color are kept. 
+ *
+ * Inputs : count - file number
+ *          Title - legend label for the graph
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::StreamGraph(uint32_t count, const char *Title)
+{
+    SET_DEBUG_STACK;
+    GraphRef Ref;
+    char     Key[32];
+
+    snprintf(Key, sizeof(Key), "IMUGraph%d", count);
+    Ref.fKey   = Key;
+    Ref.fTitle = Title;
+    Ref.fColor = fGraph->GetMarkerColor();
+
+    fGraph->SetTitle(Title);
+    fRootFile->cd();
+    fGraph->Write(Key);
+    fGraphIndex.push_back(Ref);
+    delete fGraph;
+
+    // Create a new graph
+    fGraph = new TGraph();
+    fGraph->SetMarkerColor(count);
+    fGraph->SetLineColor(count);
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteGraphIndex
+ *
+ * Description : Streaming output. Build the legend and IMUIndex, 
+ *               the list of graph keys, from the references kept 
+ *               by StreamGraph. PlotResult.C makes the multigraph
+ *               from IMUIndex. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::WriteGraphIndex(void)
+{
+    SET_DEBUG_STACK;
+    TObjArray    Index(fGraphIndex.size());
+    TLegendEntry *Entry;
+
+    if (fLegend == NULL) return;       // No graph product
+    Index.SetOwner(kTRUE);
+    for (size_t i=0; i<fGraphIndex.size(); i++)
+    {
+	Index.Add(new TObjString(fGraphIndex[i].fKey.c_str()));
+	Entry = fLegend->AddEntry((TObject *) NULL, 
+				  fGraphIndex[i].fTitle.c_str(), "p");
+	Entry->SetMarkerColor(fGraphIndex[i].fColor);
+	Entry->SetMarkerStyle(1);
+    }
+    fRootFile->cd();
+    Index.Write("IMUIndex", TObject::kSingleKey);
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteQuantiles
+ *
+ * Description : 5, 50 and 95 percent points of |M| from the 
+ *               sketches. ABSMAG_P05.. by time of day, same bins as
+ *               the ABSMAG profile, and ABSMAG2D_P05.. by day and 
+ *               time, same bins as ABSMAG2D, from the closed days.
+ *               Empty bins stay 0. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::WriteQuantiles(void)
+{
+    SET_DEBUG_STACK;
+    TH1D   *h1[kNQ];
+    TH2D   *h2[kNQ];
+    int32_t NDay;
+
+    if (!fQuantiles) return;
+    CloseSketchDay();
+    fRootFile->cd();
+    NDay = fDayPacked.size()/kNTimeBin;
+    for (uint32_t j=0; j<kNQ; j++)
+    {
+	h1[j] = new TH1D(Form("ABSMAG_%s", kQName[j]), 
+			 Form("Absolute Magnitude %s", kQName[j]), 
+			 kNTimeBin, 0.0, (double) kSecPerDay);
+	for (uint32_t t=0; t<fSketch.size(); t++)
+	{
+	    if (!fSketch[t].Empty())
+	    {
+		h1[j]->SetBinContent(t+1, fSketch[t].Quantile(kQ[j]));
+	    }
+	}
+	h2[j] = DayTimeHist(Form("ABSMAG2D_%s", kQName[j]), 
+			    Form("Day by Day ABSMAG %s", kQName[j]),
+			    kNTimeBin, 0.0, (double) kSecPerDay);
+    }
+    // Each closed day and time bin unpacked once for all three.
+    for (int32_t d=0; d<NDay; d++)
+    {
+	for (uint32_t t=0; t<kNTimeBin; t++)
+	{
+	    const vector<double> &P = fDayPacked[d*kNTimeBin + t];
+	    if (P.empty()) continue;
+	    TDigest       Dig(fDaySketchCompression);
+	    const double *p = P.data();
+	    if (!Dig.Unpack(p, p + P.size()) || Dig.Empty()) continue;
+	    for (uint32_t j=0; j<kNQ; j++)
+	    {
+		h2[j]->SetBinContent(d+1, t+1, Dig.Quantile(kQ[j]));
+	    }
+	}
+    }
+    // Picked up by the fRootFile->Write() that follows. 
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : CloseSketchDay
+ *
+ * Description : The rows have moved off fSketchDay. Each time 
+ *               bin's sketch is packed, centroids and all, into 
+ *               fDayPacked and replaced by an empty one so its 
+ *               memory is given back. In date order a day is closed
+ *               once. A day seen again, out of date order or the 
+ *               same day of another year, has what was packed 
+ *               merged into the sketch before it is packed again, 
+ *               so its quantiles are those of all its samples. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::CloseSketchDay(void)
+{
+    SET_DEBUG_STACK;
+    bool    Again = false;
+
+    if (fSketchDay < 0) return;
+    for (uint32_t t=0; t<kNTimeBin; t++)
+    {
+	TDigest &D = fDaySketch[t];
+	if (D.Empty()) continue;
+	vector<double> &P = fDayPacked[fSketchDay*kNTimeBin + t];
+	if (!P.empty())
+	{
+	    TDigest       Old(fDaySketchCompression);
+	    const double *p = P.data();
+	    if (Old.Unpack(p, p + P.size())) D.Merge(Old);
+	    Again = true;
+	}
+	P.clear();
+	D.Pack(P);
+	P.shrink_to_fit();
+	D = TDigest(fDaySketchCompression);
+    }
+    if (Again)
+    {
+	CLogger::GetThis()->Log("# Day bin %d sketched again, merged.\n",
+				fSketchDay);
+    }
+    fSketchDay = -1;
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : FlushDay
+ *
+ * Description : Welch sums for the rows collected for fBufDay, 
+ *               added to its row of the PSD histograms, then the
+ *               buffers are emptied. The four series are 
+ *               independent, each on its own thread with the one 
+ *               shared plan. A day shorter than one segment adds
+ *               nothing. |M| is NaN whenever a component is, so 
+ *               its segment count serves for all four. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::FlushDay(void)
+{
+    SET_DEBUG_STACK;
+    const uint32_t NB = fWelch->NBins();
+    vector<double> Sum[kNPSD];
+    uint32_t       NSeg[kNPSD];
+    vector<std::thread> Threads;
+
+    if ((fBufDay >= 0) && (fBufDay < fPSD[0]->GetNbinsX()) &&
+	(fDayBuf[kPSD_MAG].size() >= fWelch->Length()))
+    {
+	for (uint32_t i=0; i<kNPSD; i++)
+	{
+	    Sum[i].assign(NB, 0.0);
+	    Threads.push_back(std::thread([this, &Sum, &NSeg, i]()
+	    {
+		NSeg[i] = fWelch->Accumulate(fDayBuf[i].data(), 
+					     fDayBuf[i].size(), Sum[i].data());
+	    }));
+	}
+	for (size_t i=0; i<Threads.size(); i++) Threads[i].join();
+
+	for (uint32_t i=0; i<kNPSD; i++)
+	{
+	    for (uint32_t k=0; k<NB; k++)
+	    {
+		fPSD[i]->SetBinContent(fBufDay+1, k+1, 
+			      fPSD[i]->GetBinContent(fBufDay+1, k+1) + Sum[i][k]);
+	    }
+	}
+	fPSDSeg->SetBinContent(fBufDay+1, 
+			       fPSDSeg->GetBinContent(fBufDay+1) + 
+			       NSeg[kPSD_MAG]);
+    }
+    for (uint32_t i=0; i<kNPSD; i++) fDayBuf[i].clear();
+    fBufDay = -1;
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteSpectra
+ *
+ * Description : Flush the last day and turn the sums into the 
+ *               average PSD, units^2/Hz, per day. Days without a 
+ *               whole segment stay 0. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::WriteSpectra(void)
+{
+    SET_DEBUG_STACK;
+    double N;
+
+    if (!fSpectra || (fWelch == NULL)) return;
+    FlushDay();
+    for (int32_t d=1; d<=fPSDSeg->GetNbinsX(); d++)
+    {
+	N = fPSDSeg->GetBinContent(d);
+	if (N <= 0.0) continue;
+	for (uint32_t i=0; i<kNPSD; i++)
+	{
+	    for (int32_t k=1; k<=fPSD[i]->GetNbinsY(); k++)
+	    {
+		fPSD[i]->SetBinContent(d, k, fPSD[i]->GetBinContent(d, k)/N);
+	    }
+	}
+    }
+    // Picked up by the fRootFile->Write() that follows. 
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : FlushSq
+ *
+ * Description : The sums for fSqKey go to the baseline, which 
+ *               remakes the baselines that depend on the day. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::FlushSq(void)
+{
+    SET_DEBUG_STACK;
+    if (fSqKey >= 0)
+    {
+	fBaseline->Add(fSqKey, fSqDoy, fSqSumMag.data(), fSqSumZ.data(), 
+		       fSqCount.data());
+    }
+    fSqSumMag.assign(kNTimeBin, 0.0);
+    fSqSumZ.assign(kNTimeBin, 0.0);
+    fSqCount.assign(kNTimeBin, 0.0);
+    fSqKey = -1;
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteBaseline
+ *
+ * Description : Save the baseline cache and make ABSMAG2D_SQ and 
+ *               Z2D_SQ, same bins as ABSMAG2D and Z2D, from the 
+ *               days done this run. Each cell is the mean in the
+ *               bin less the baseline, so the regular daily 
+ *               variation is gone and disturbances stand out. 
+ *               Cells without data or baseline stay 0. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::WriteBaseline(void)
+{
+    SET_DEBUG_STACK;
+    int32_t X;
+
+    if (fBaseline == NULL) return;
+    FlushSq();
+    fBaseline->Write();
+
+    fRootFile->cd();
+    TH2D *hM = DayTimeHist("ABSMAG2D_SQ", "Day by Day ABSMAG less Sq", 
+			   kNTimeBin, 0.0, (double) kSecPerDay);
+    TH2D *hZ = DayTimeHist("Z2D_SQ", "Day by Day Z less Sq", 
+			   kNTimeBin, 0.0, (double) kSecPerDay);
+
+    const set<int32_t> &T = fBaseline->Touched();
+    for (set<int32_t>::const_iterator it=T.begin(); it!=T.end(); it++)
+    {
+	const SqBaseline::Day *D = fBaseline->Find(*it);
+	if ((D == NULL) || !D->fHasBase) continue;
+	X = hM->GetXaxis()->FindBin((double) D->fDoy);
+	for (uint32_t t=0; t<kNTimeBin; t++)
+	{
+	    if (D->fCount[t] <= 0.0) continue;
+	    hM->SetBinContent(X, t+1, D->fSumMag[t]/D->fCount[t] - 
+			      D->fBaseMag[t]);
+	    hZ->SetBinContent(X, t+1, D->fSumZ[t]/D->fCount[t] - 
+			      D->fBaseZ[t]);
+	}
+    }
+    // Picked up by the fRootFile->Write() that follows. 
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : FlushRollup
+ *
+ * Description : The statistics for fRollKey go to the rollups, 
+ *               which remake its month and year. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::FlushRollup(void)
+{
+    SET_DEBUG_STACK;
+    const size_t N = Rollup::kNQuantity * kNTimeBin;
+    if (fRollKey >= 0)
+    {
+	fRollup->Add(fRollKey, fRollSum.data(), fRollMin.data(), 
+		     fRollMax.data(), fRollCount.data());
+    }
+    fRollSum.assign(N, 0.0);
+    fRollMin.assign(N, 0.0);
+    fRollMax.assign(N, 0.0);
+    fRollCount.assign(N, 0.0);
+    fRollKey = -1;
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteRollup
+ *
+ * Description : Last day in, then RollupFile written. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::WriteRollup(void)
+{
+    SET_DEBUG_STACK;
+    if (fRollup == NULL) return;
+    FlushRollup();
+    fRollup->Write();
+    CLogger::GetThis()->LogTime("Rollup %s, %d days, %d months, %d years.\n",
+				fRollFile.c_str(), 
+				(int) fRollup->Level(Rollup::kDay).size(),
+				(int) fRollup->Level(Rollup::kMonth).size(),
+				(int) fRollup->Level(Rollup::kYear).size());
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : EndTempFit
+ *
+ * Description : Solve the fit of this run. If the correction was
+ *               applied the fit saw corrected data, and since the 
+ *               model is linear the applied coefficients are just
+ *               added back. The offsets were never subtracted. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : fit can not be solved, fTempCoef unchanged
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::EndTempFit(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    const char Axis[TempFit::kNAxis] = {'X', 'Y', 'Z'};
+    double   Coef[TempFit::kNAxis][TempFit::kNPar];
+    double   RMS[TempFit::kNAxis];
+
+    if (fTempFit == NULL) return;
+    if (!fTempFit->Solve(Coef, RMS))
+    {
+	Logger->Log("# TempFit: %.0f rows, no solution, TempComp kept.\n",
+		    fTempFit->Rows());
+	return;
+    }
+    for (uint32_t a=0; a<TempFit::kNAxis; a++)
+    {
+	for (uint32_t j=1; fTempApply && (j<TempFit::kNPar); j++)
+	{
+	    Coef[a][j] += fTempCoef[a][j];
+	}
+	for (uint32_t j=0; j<TempFit::kNPar; j++)
+	{
+	    fTempCoef[a][j] = Coef[a][j];
+	}
+	fTempRMS[a] = RMS[a];
+	Logger->LogTime("TempFit M%c = %f + %f dT + %f dT/dt, rms %f\n", 
+			Axis[a], Coef[a][0], Coef[a][1], Coef[a][2], RMS[a]);
+    }
+    fTempRows = fTempFit->Rows();
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : DayTimeHist
+ *
+ * Description : New TH2D, X the day axis of ABSMAG2D, whether or 
+ *               not ABSMAG2D is made. 
+ *
+ * Inputs : Name, Title - 
+ *          NY, YMin, YMax - Y axis
+ *
+ * Returns : the histogram, in the current directory
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+TH2D* Analysis::DayTimeHist(const char *Name, const char *Title, 
+			    int32_t NY, double YMin, double YMax) const
+{
+    return new TH2D(Name, Title, fNDays, fDayMin, fDayMin + fNDays, 
+		    NY, YMin, YMax);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : CheckpointObjects
+ *
+ * Description : Accumulators that have to be saved to resume. 
+ *               The per file profiles and graphs are already on
+ *               disk and are not included. The graph index is 
+ *               saved as TNamed key/title pairs and a color vector,
+ *               the sketches packed in one vector: time of day, the
+ *               open day and the closed days that have data. 
+ *
+ * Inputs : Made - objects made for the checkpoint, the caller 
+ *                 deletes them
+ *
+ * Returns : list of objects
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Checkpoint::ObjectList Analysis::CheckpointObjects(vector<TObject*> &Made)
+{
+    Checkpoint::ObjectList rv;
+    TObjArray *Keys   = new TObjArray(fGraphIndex.size() + 1);
+    TVectorD  *Colors = new TVectorD(fGraphIndex.size());
+    vector<double> Packed;
+
+    Keys->SetOwner(true);
+    for (size_t i=0; i<fGraphIndex.size(); i++)
+    {
+	Keys->Add(new TNamed(fGraphIndex[i].fKey.c_str(), 
+			     fGraphIndex[i].fTitle.c_str()));
+	(*Colors)[i] = fGraphIndex[i].fColor;
+    }
+    rv.push_back(make_pair(string("ABSMAG2D")   , (TObject*) f2D));
+    rv.push_back(make_pair(string("Z2D")        , (TObject*) f2DZ));
+    rv.push_back(make_pair(string("KINDEX")     , (TObject*) f2DK));
+    rv.push_back(make_pair(string("GraphIndex") , (TObject*) Keys));
+    rv.push_back(make_pair(string("GraphColors"), (TObject*) Colors));
+    Made.push_back(Keys);
+    Made.push_back(Colors);
+    if (fRejected)
+    {
+	rv.push_back(make_pair(string("DESPIKE"), (TObject*) fRejected));
+    }
+    if (fSpectra)
+    {
+	for (uint32_t i=0; i<kNPSD; i++)
+	{
+	    rv.push_back(make_pair(string(fPSD[i]->GetName()), 
+				   (TObject*) fPSD[i]));
+	}
+	rv.push_back(make_pair(string("PSD_NSEG"), (TObject*) fPSDSeg));
+    }
+    if (fTilt)
+    {
+	rv.push_back(make_pair(string("H2D"), (TObject*) fH2D));
+	rv.push_back(make_pair(string("D2D"), (TObject*) fD2D));
+	rv.push_back(make_pair(string("I2D"), (TObject*) fI2D));
+    }
+    if (fResample)
+    {
+	rv.push_back(make_pair(string("COUNT2D") , (TObject*) fCount));
+	rv.push_back(make_pair(string("COVERAGE"), (TObject*) fCoverage));
+    }
+    if (fTempFit)
+    {
+	vector<double> TF;
+	fTempFit->Pack(TF);
+	TVectorD *Tv = new TVectorD(TF.size());
+	for (size_t i=0; i<TF.size(); i++) (*Tv)[i] = TF[i];
+	rv.push_back(make_pair(string("TempFit"), (TObject*) Tv));
+	Made.push_back(Tv);
+    }
+    if (fBaseline)
+    {
+	// The days redone so far, SqFile may be written past them. 
+	vector<double> SD;
+	fBaseline->Pack(SD);
+	TVectorD *Sv = new TVectorD(SD.size());
+	for (size_t i=0; i<SD.size(); i++) (*Sv)[i] = SD[i];
+	rv.push_back(make_pair(string("SqDays"), (TObject*) Sv));
+	Made.push_back(Sv);
+    }
+    if (fRollup)
+    {
+	vector<double> RD;
+	fRollup->Pack(RD);
+	TVectorD *Rv = new TVectorD(RD.size());
+	for (size_t i=0; i<RD.size(); i++) (*Rv)[i] = RD[i];
+	rv.push_back(make_pair(string("RollDays"), (TObject*) Rv));
+	Made.push_back(Rv);
+    }
+    if (fQuantiles)
+    {
+	// Closed day and time bins as index then packed digest. 
+	size_t NClosed = 0;
+	for (size_t i=0; i<fDayPacked.size(); i++)
+	{
+	    if (!fDayPacked[i].empty()) NClosed++;
+	}
+	for (size_t i=0; i<fSketch.size(); i++)    fSketch[i].Pack(Packed);
+	Packed.push_back(fSketchDay);
+	for (size_t i=0; i<fDaySketch.size(); i++) fDaySketch[i].Pack(Packed);
+	Packed.push_back(NClosed);
+	for (size_t i=0; i<fDayPacked.size(); i++)
+	{
+	    if (fDayPacked[i].empty()) continue;
+	    Packed.push_back(i);
+	    Packed.insert(Packed.end(), fDayPacked[i].begin(), 
+			  fDayPacked[i].end());
+	}
+	TVectorD *Sk = new TVectorD(Packed.size());
+	for (size_t i=0; i<Packed.size(); i++) (*Sk)[i] = Packed[i];
+	rv.push_back(make_pair(string("Sketches"), (TObject*) Sk));
+	Made.push_back(Sk);
+    }
+    return rv;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : SaveCheckpoint
+ *
+ * Description : Called between files. Flush the ntuple so the 
+ *               entries on disk match the count saved, then write
+ *               the checkpoint. Only called when all the stages 
+ *               are idle. 
+ *
+ * Inputs : NextFile - index of the first file not done
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : checkpoint could not be written
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Analysis::SaveCheckpoint(uint32_t NextFile)
+{
+    SET_DEBUG_STACK;
+    bool rc;
+    if (fNtuple) fNtuple->AutoSave("SaveSelf");
+    /*
+     * A day cut by the checkpoint is split in two, each part with
+     * whole segments. The rows are not in the checkpoint. 
+     */
+    if (fSpectra) FlushDay();
+    if (fBaseline)
+    {
+	FlushSq();
+	fBaseline->Write();
+    }
+    if (fRollup)
+    {
+	FlushRollup();
+	fRollup->Write();
+    }
+
+    vector<TObject*>       Made;
+    Checkpoint::ObjectList Objects = CheckpointObjects(Made);
+    rc = fCheckpoint->Write(NextFile, fNtuple ? fNtuple->GetEntries() : 0,
+			    RunFiles(NextFile), Objects);
+    for (size_t i=0; i<Made.size(); i++) delete Made[i];
+    SET_DEBUG_STACK;
+    return rc;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Restore
+ *
+ * Description : Resume from the last checkpoint. 
+ *   - refuse it if the files of the run or the day axis are not 
+ *     the ones it was made with, the position and histograms 
+ *     would not line up. 
+ *   - trim IMUTuple back to the checkpoint entry count, anything
+ *     past it came from a file that was not finished. 
+ *   - rebuild its zones. 
+ *   - add the saved histogram contents and sketches. 
+ *   - restore the graph index. 
+ *   - run the saved tail through the filter. 
+ *   - skip the files already done. 
+ *
+ * Inputs : none
+ *
+ * Returns : true if a checkpoint was found
+ *
+ * Error Conditions : no checkpoint, the run starts over in the
+ *                    existing output file. Refused, ERESUME_MISMATCH
+ *                    is set and nothing is run or written. 
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Analysis::Restore(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    const char *Names[3] = {"ABSMAG2D", "Z2D", "KINDEX"};
+    TH2D       *Hist[3]  = {f2D, f2DZ, f2DK};
+
+    bool     rc     = fCheckpoint->Read();
+
+    if (!rc)
+    {
+	Logger->Log("# Nothing to resume, start from the first file.\n");
+    }
+    else
+    {
+	const Checkpoint::FileList &Was = fCheckpoint->List();
+	TH2D       *Saved  = (TH2D *) fCheckpoint->Get("ABSMAG2D");
+	const char *Reason = NULL;
+	if (Was.fSize == 0)
+	{
+	    Reason = "has no file list";
+	}
+	else if (!(Was == RunFiles(fCheckpoint->NextFile())))
+	{
+	    Reason = "is for other files or another order";
+	}
+	else if (Saved && f2D && !SameAxes(Saved, f2D))
+	{
+	    Reason = "has another day axis";
+	}
+	if (Reason)
+	{
+	    Logger->Log("# Checkpoint %s %s, at %s. Not resumed, run "
+			"without --resume to start over.\n", 
+			fCheckpointFile.c_str(), Reason, 
+			Was.fNextName.c_str());
+	    fCheckpoint->Close();
+	    fRefused = true;
+	    SetError(ERESUME_MISMATCH, __LINE__);
+	    SET_DEBUG_STACK;
+	    return false;
+	}
+    }
+    // Zero if there was no checkpoint. 
+    Long64_t N = fCheckpoint->Entries();
+    if (fNtuple == NULL)
+    {
+	// No ntuple product. 
+    }
+    else if (fNtuple->GetEntries() > N)
+    {
+	Logger->Log("# Trim IMUTuple from %ld to %ld entries.\n", 
+		    (long) fNtuple->GetEntries(), (long) N);
+	TTree  *Trim = NewTuple("IMUTupleTrim");
+	double row[RowBlock::kNTupleCol];
+	for (Long64_t i=0; i<N; i++)
+	{
+	    TupleRow(fNtuple, i, row);
+	    FillTuple(Trim, row);
+	}
+	delete fNtuple;
+	fRootFile->Delete("IMUTuple;*");
+	Trim->SetName("IMUTuple");
+	if (fZones) Trim->SetAutoFlush(fZoneCluster);
+	fNtuple = Trim;
+    }
+    else if (fNtuple->GetEntries() < N)
+    {
+	Logger->Log("# IMUTuple has %ld entries, checkpoint %ld.\n", 
+		    (long) fNtuple->GetEntries(), (long) N);
+    }
+    if (fZones) fZones->Rebuild(fNtuple);
+
+    for (uint32_t i=0; i<3; i++)
+    {
+	TH2D *h = (TH2D *) fCheckpoint->Get(Names[i]);
+	if (h && Hist[i]) Hist[i]->Add(h);
+    }
+
+    TObjArray *Keys   = (TObjArray *) fCheckpoint->Get("GraphIndex");
+    TVectorD  *Colors = (TVectorD *)  fCheckpoint->Get("GraphColors");
+    fGraphIndex.clear();
+    if (Keys && Colors)
+    {
+	for (int i=0; i<Keys->GetEntriesFast(); i++)
+	{
+	    GraphRef Ref;
+	    Ref.fKey   = Keys->At(i)->GetName();
+	    Ref.fTitle = ((TNamed *) Keys->At(i))->GetTitle();
+	    Ref.fColor = (int) (*Colors)[i];
+	    fGraphIndex.push_back(Ref);
+	}
+    }
+
+    TH1D *Rej = (TH1D *) fCheckpoint->Get("DESPIKE");
+    if (Rej && fRejected) fRejected->Add(Rej);
+
+    for (uint32_t i=0; fSpectra && (i<kNPSD); i++)
+    {
+	TH2D *h = (TH2D *) fCheckpoint->Get(fPSD[i]->GetName());
+	if (h) fPSD[i]->Add(h);
+    }
+    TH1D *Seg = (TH1D *) fCheckpoint->Get("PSD_NSEG");
+    if (Seg && fPSDSeg) fPSDSeg->Add(Seg);
+
+    if (fTilt)
+    {
+	const char *TName[3] = {"H2D", "D2D", "I2D"};
+	TH2D       *THist[3] = {fH2D, fD2D, fI2D};
+	for (uint32_t i=0; i<3; i++)
+	{
+	    TH2D *h = (TH2D *) fCheckpoint->Get(TName[i]);
+	    if (h) THist[i]->Add(h);
+	}
+    }
+
+    if (fResample)
+    {
+	TH2D *h = (TH2D *) fCheckpoint->Get("COUNT2D");
+	if (h) fCount->Add(h);
+	h = (TH2D *) fCheckpoint->Get("COVERAGE");
+	if (h) fCoverage->Add(h);
+    }
+
+    TVectorD *Tf = (TVectorD *) fCheckpoint->Get("TempFit");
+    if (Tf && fTempFit)
+    {
+	vector<double> TF(Tf->GetNrows());
+	for (int i=0; i<Tf->GetNrows(); i++) TF[i] = (*Tf)[i];
+	const double *p = TF.data();
+	fTempFit->Unpack(p, p + TF.size());
+    }
+
+    /*
+     * The days as they were at the checkpoint, the cache may have 
+     * been written since, and so a day cut by the checkpoint is 
+     * added to, not replaced. 
+     */
+    TVectorD *SqDays = (TVectorD *) fCheckpoint->Get("SqDays");
+    if (SqDays && fBaseline)
+    {
+	vector<double> Packed(SqDays->GetNrows());
+	for (int i=0; i<SqDays->GetNrows(); i++) Packed[i] = (*SqDays)[i];
+	const double *p = Packed.data();
+	if (!fBaseline->Unpack(p, p + Packed.size()))
+	    Logger->Log("# Checkpoint Sq days short, ignored rest.\n");
+    }
+    TVectorD *RollDays = (TVectorD *) fCheckpoint->Get("RollDays");
+    if (RollDays && fRollup)
+    {
+	vector<double> Packed(RollDays->GetNrows());
+	for (int i=0; i<RollDays->GetNrows(); i++) Packed[i] = (*RollDays)[i];
+	const double *p = Packed.data();
+	if (!fRollup->Unpack(p, p + Packed.size()))
+	    Logger->Log("# Checkpoint rollup days short, ignored rest.\n");
+    }
+
+    TVectorD *Sk = (TVectorD *) fCheckpoint->Get("Sketches");
+    if (Sk && fQuantiles)
+    {
+	vector<double> Packed(Sk->GetNrows());
+	for (int i=0; i<Sk->GetNrows(); i++) Packed[i] = (*Sk)[i];
+	const double *p   = Packed.data();
+	const double *End = p + Packed.size();
+	size_t Bin, NClosed = 0;
+	bool ok = true;
+	for (size_t i=0; ok && (i<fSketch.size()); i++)
+	{
+	    ok = fSketch[i].Unpack(p, End);
+	}
+	if (ok && (p < End)) fSketchDay = (int32_t) *p++;
+	for (size_t i=0; ok && (i<fDaySketch.size()); i++)
+	{
+	    ok = fDaySketch[i].Unpack(p, End);
+	}
+	ok = ok && (p < End);
+	if (ok) NClosed = (size_t) *p++;
+	for (size_t i=0; ok && (i<NClosed); i++)
+	{
+	    ok = (p < End) && ((size_t) *p < fDayPacked.size());
+	    if (!ok) break;
+	    Bin = (size_t) *p++;
+	    TDigest Dig(fDaySketchCompression);
+	    ok = Dig.Unpack(p, End);
+	    if (ok)
+	    {
+		fDayPacked[Bin].clear();
+		Dig.Pack(fDayPacked[Bin]);
+	    }
+	}
+	if (!ok) Logger->Log("# Checkpoint sketches short, ignored rest.\n");
+    }
+
+    vector<double> Tail = fCheckpoint->Tail();
+    for (size_t i=0; i<Tail.size(); i++)
+    {
+	// NaN filled grid rows were never filtered. 
+	if (!std::isnan(Tail[i])) fFilter->Filter(Tail[i]);
+    }
+    // Read put the tail back in the ring for the next checkpoint.
+    fStartFile = fCheckpoint->NextFile();
+    fCheckpoint->Close();
+
+    fRootFile->cd();
+    Logger->LogTime("Resume at file %d, %d graphs, filter warmed with %d.\n",
+		    fStartFile, (int) fGraphIndex.size(), (int) Tail.size());
+    SET_DEBUG_STACK;
+    return rc;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : RunOrder
+ *
+ * Description : Manifest order is by date. Largest first keeps the
+ *               long files from all landing at the end. Zones need
+ *               the IMUTuple in date order, so with Zones on the run
+ *               is by date whatever LargestFirst says. 
+ *
+ * Inputs : none
+ *
+ * Returns : manifest indices in run order
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+vector<uint32_t> Analysis::RunOrder(void) const
+{
+    vector<uint32_t> Order;
+
+    if (fLargestFirst && !fZonesOn) return fManifest->LargestFirst();
+    Order.resize(fManifest->Size());
+    for (uint32_t i=0; i<Order.size(); i++) Order[i] = i;
+    return Order;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : RunFiles
+ *
+ * Description : What a checkpoint at NextFile is a position in. 
+ *               The hash takes each file's name, size and time in
+ *               run order, so an added, removed, changed or 
+ *               reordered file changes it. 
+ *
+ * Inputs : NextFile - position in RunOrder of the next file to do
+ *
+ * Returns : the list
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Checkpoint::FileList Analysis::RunFiles(uint32_t NextFile) const
+{
+    vector<uint32_t>     Order = RunOrder();
+    Checkpoint::FileList L;
+    uint64_t             h     = 14695981039346656037ULL;
+    int64_t              v;
+
+    for (size_t i=0; i<Order.size(); i++)
+    {
+	const ManifestEntry &E = fManifest->Entry(Order[i]);
+	h = Hash64(E.fName.c_str(), E.fName.size() + 1, h);
+	v = E.fSize;
+	h = Hash64(&v, sizeof(v), h);
+	v = E.fMTime;
+	h = Hash64(&v, sizeof(v), h);
+    }
+    L.fSize = Order.size();
+    L.fHash = h;
+    if (NextFile < Order.size())
+    {
+	L.fNextName  = fManifest->Entry(Order[NextFile]).fName;
+	L.fNextMTime = fManifest->Entry(Order[NextFile]).fMTime;
+    }
+    return L;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ProcessData
+ *
+ * Description : for each file, process the data. 
+ *
+ * Inputs : count - file number currently being processed. 
+ *          First, Last - rows to process [First, Last), the whole
+ *                        file by default. 
+ *
+ * Returns : NONE
+ *
+ * Error Conditions :
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Analysis::ProcessData(uint32_t count, size_t First, size_t Last)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    double   Busy[kNStage] = {0.0, 0.0, 0.0};
+    double   Start, Wall;
+
+    // number of entries in the file. 
+    size_t N = f5InputFile->NEntries();
+    if (Last < N) N = Last;
+    pLogger->LogTime("Processing: %d Entries. count: %d\n", N - First, count);
+
+    //time_t   iTime = f5InputFile->IndexFromName("Time");
+    fiUTC = f5InputFile->IndexFromName("UTC");
+    fiMx  = f5InputFile->IndexFromName("Mx");
+    fiMy  = f5InputFile->IndexFromName("My");
+    fiMz  = f5InputFile->IndexFromName("Mz");
+    if (fResample) fResample->Reset();
+
+    /*
+     * Get the date information from the header file. 
+     * This will be in the form of something like:
+     * "2024-02-12 02:43:44"
+     */
+    const char *Date = f5InputFile->HeaderInfo( H5Logger::kDATE);
+    struct tm *rv    = f5InputFile->H5ParseTime((const char *)Date);
+    double Day       = (Double_t)rv->tm_yday;
+    // Days since 1970, the Sq and rollup day. 
+    int32_t Key      = CalDays(1900 + rv->tm_year, rv->tm_mon, rv->tm_mday);
+    pLogger->LogTime("Date: %s, Day in Year: %f\n", Date, Day);
+
+    Start = Now();
+    if (fPipeline)
+    {
+	RunPipeline(First, N, Day, Key, count, Busy);
+    }
+    else
+    {
+	RunSerial(First, N, Day, Key, count, Busy);
+    }
+    Wall = Now() - Start;
+
+    LogUtilization("File", Busy, Wall);
+    for (uint32_t i=0; i<kNStage; i++) fStageBusy[i] += Busy[i];
+    fStageWall += Wall;
+
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : RunScheduled
+ *
+ * Description : Files cut into row range tasks and run on fWorkers
+ *               threads with work stealing, see Scheduler. A worker
+ *               reads its rows, under the HDF5 lock, and computes 
+ *               them with its own filter and despiker, warmed up on
+ *               the rows before the task, FilterWarmup or the 
+ *               despike window if that is longer. Where the task is
+ *               near the start of a file those come from the end of
+ *               the file before it in merge order, as a serial run
+ *               carries them over. This thread merges the results 
+ *               in task order, so the histograms, ntuple and graphs
+ *               see the rows in the same order as a serial run. 
+ *
+ *               What is not the same as serial: 
+ *               - FILT, to the extent the filter remembers more 
+ *                 than the warm up rows. 
+ *               - the first rows of the run, serial warms from 
+ *                 the checkpoint tail on resume. 
+ *               - Tilt block mode, gravity is the mean of the task
+ *                 here and of the pipeline block in serial. 
+ *               The warm up rows are gridded by the Resampler only
+ *               to carry on from, they are not in its counts. 
+ *
+ *               Thread ownership while running: 
+ *               workers - their H5Logger, filter and RowBlocks
+ *               merger  - everything else
+ *
+ * Inputs : Order - files in the order to merge
+ *
+ * Returns : none
+ *
+ * Error Conditions : a file that fails to open gives empty results
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::RunScheduled(const vector<uint32_t> &Order)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    /// A finished task waiting to be merged. 
+    struct Result {
+	RowBlock *fBlock;
+	bool      fEndOfFile;
+    };
+    /// What a worker has open. 
+    struct Input {
+	H5Logger *fH5;
+	uint32_t  fFile;
+	int32_t   fCols[4];
+    };
+    const uint64_t Ahead  = 4 * fWorkers;  // Results held before waiting
+    const double   Cutoff = fFilter->Cutoff();
+    const double   Rate   = fFilter->SampleRate();
+    const uint32_t Need   = fProducts.Columns();
+    // The despiker needs a full window before its first output. 
+    const size_t   Lead   = max((size_t) fFilterWarmup, 
+				fDespikeOn ? (size_t) fDespikeWindow : 0);
+    Scheduler      Sched(fWorkers);
+    vector<Input>  In(Sched.NWorkers());
+    vector<uint32_t> Pos(fManifest->Size(), 0);
+    map<uint64_t, Result> Done;
+    std::mutex     Lock;
+    std::condition_variable Ready, Space;
+    uint64_t       Emit    = 0;            // Next task to merge
+    uint32_t       Current = UINT32_MAX;   // File being merged
+    TString        Title;
+    char           ProfName[32];
+    Result         r;
+    double         Start   = Now();
+
+    for (size_t w=0; w<In.size(); w++)
+    {
+	In[w].fH5   = NULL;
+	In[w].fFile = UINT32_MAX;
+    }
+    for (uint32_t i=fStartFile; i<Order.size(); i++)
+    {
+	Pos[Order[i]] = i;
+	Sched.AddFile(Order[i], fManifest->Entry(Order[i]).fNRows, fTaskRows);
+    }
+    pLogger->LogTime("Scheduler: %d tasks on %d workers.\n", 
+		     (int) Sched.NTasks(), (int) Sched.NWorkers());
+
+    Sched.Start([&](uint32_t w, const Task &t)
+    {
+	Input    &I     = In[w];
+	RowBlock *b     = new RowBlock;
+	RowBlock  Warm, Prev;
+	size_t    First = (t.fFirst > Lead) ? t.fFirst - Lead : 0;
+	// Rows still wanted from the file before, in merge order. 
+	size_t    NPrev = Lead - (t.fFirst - First);
+	uint32_t  P     = (Pos[t.fFile] > 0) ? Order[Pos[t.fFile]-1] : 
+	    UINT32_MAX;
+	SFilter   Filter(Cutoff, Rate);
+	Despike   Spike(fDespikeWindow, fDespikeThreshold, fDespikeFloor);
+	Despike  *pSpike = fDespikeOn ? &Spike : NULL;
+
+	b->Resize(t.Rows());
+	b->fFile = t.fFile;
+	b->fDay  = fManifest->Entry(t.fFile).fDay;
+	b->fKey  = (int32_t) (fManifest->Entry(t.fFile).fEpoch / kSecPerDay);
+	Warm.Resize(t.fFirst - First);
+	Warm.fDay = b->fDay;
+	if (P == UINT32_MAX) NPrev = 0;
+	Prev.Resize(NPrev);
+	{
+	    std::lock_guard<std::mutex> H5(H5Mutex());
+	    if (I.fFile != t.fFile)
+	    {
+		delete I.fH5;
+		I.fFile = t.fFile;
+		I.fH5   = new H5Logger(fManifest->Entry(t.fFile).fName.c_str(),
+				       NULL, 0, true);
+		if (I.fH5->CheckError())
+		{
+		    delete I.fH5;
+		    I.fH5 = NULL;
+		}
+		else
+		{
+		    I.fCols[0] = I.fH5->IndexFromName("UTC");
+		    I.fCols[1] = I.fH5->IndexFromName("Mx");
+		    I.fCols[2] = I.fH5->IndexFromName("My");
+		    I.fCols[3] = I.fH5->IndexFromName("Mz");
+		}
+	    }
+	    if (I.fH5)
+	    {
+		ReadRows(I.fH5, I.fCols, Need, Warm, First, t.fFirst);
+		ReadRows(I.fH5, I.fCols, Need, *b, First, t.fLast);
+	    }
+	    if (NPrev > 0)
+	    {
+		const ManifestEntry &E = fManifest->Entry(P);
+		size_t    PFirst = (E.fNRows > NPrev) ? E.fNRows - NPrev : 0;
+		int32_t   PCols[4];
+		H5Logger *h5     = new H5Logger(E.fName.c_str(), NULL, 0, true);
+		Prev.fDay = E.fDay;
+		if (!h5->CheckError())
+		{
+		    PCols[0] = h5->IndexFromName("UTC");
+		    PCols[1] = h5->IndexFromName("Mx");
+		    PCols[2] = h5->IndexFromName("My");
+		    PCols[3] = h5->IndexFromName("Mz");
+		    ReadRows(h5, PCols, Need, Prev, PFirst, E.fNRows);
+		}
+		delete h5;
+	    }
+	}
+	if (fResample)
+	{
+	    /*
+	     * A grid per task, the points line up from task to task. 
+	     * Warm carries the grid on into the task and is counted 
+	     * by the task before, Prev is another file and serial 
+	     * starts its grid again, so it has a grid of its own. 
+	     */
+	    Resampler Grid(fResample->Step(), fResampleMaxFill, 
+			   fResample->Mode());
+	    Resampler Tail(fResample->Step(), fResampleMaxFill, 
+			   fResample->Mode());
+	    RowBlock  Out;
+	    Out.fDay = Prev.fDay;
+	    Tail.Run(Prev, Need, Out);
+	    std::swap(Prev, Out);
+	    Out.fDay = b->fDay;
+	    Grid.Run(Warm, Need, Out);
+	    std::swap(Warm, Out);
+	    Grid.ClearCounts();
+	    Grid.Run(*b, Need, Out);
+	    std::swap(*b, Out);
+	    b->fFile = t.fFile;
+	    b->fKey  = Out.fKey;
+	    std::lock_guard<std::mutex> L(Lock);
+	    fResample->Merge(Grid);
+	}
+	ComputeRows(Prev, &Filter, pSpike);
+	ComputeRows(Warm, &Filter, pSpike);
+	ComputeRows(*b, &Filter, pSpike);
+
+	std::unique_lock<std::mutex> L(Lock);
+	while (fRun && (t.fSeq >= Emit + Ahead))
+	{
+	    Space.wait_for(L, std::chrono::milliseconds(100));
+	}
+	Done[t.fSeq].fBlock     = b;
+	Done[t.fSeq].fEndOfFile = t.fEndOfFile;
+	Ready.notify_one();
+    });
+
+    // Merge, in task order. 
+    while ((Emit < Sched.NTasks()) && fRun)
+    {
+	{
+	    std::unique_lock<std::mutex> L(Lock);
+	    if (Done.find(Emit) == Done.end())
+	    {
+		Ready.wait_for(L, std::chrono::milliseconds(100));
+		continue;
+	    }
+	    r = Done[Emit];
+	    Done.erase(Emit);
+	    Emit++;
+	}
+	Space.notify_all();
+
+	RowBlock &b = *r.fBlock;
+	if (b.fFile != Current)
+	{
+	    Current = b.fFile;
+	    Title   = FileTitle(fManifest->Entry(Current).fName.c_str());
+	    snprintf(ProfName, sizeof(ProfName), "IMU%d", Current);
+	    if (fProfile) fProfile->SetTitle(Title);
+	    pLogger->LogTime("File - number: %d, name: %s\n", Current, 
+			     fManifest->Entry(Current).fName.c_str());
+	}
+	FillBlock(b);
+	WriteBlock(b);
+	delete r.fBlock;
+
+	if (r.fEndOfFile)
+	{
+	    EndFile(Current, Title, ProfName);
+	    if (fRun && fCheckpoint && (fCheckpointEvery > 0) &&
+		((((Pos[Current]+1) % fCheckpointEvery) == 0) || 
+		 ((Pos[Current]+1) == fExpected)))
+	    {
+		SaveCheckpoint(Pos[Current]+1);
+	    }
+	}
+    }
+    Sched.Stop();
+    Space.notify_all();
+    Sched.Join();
+
+    // Anything left after a Stop. 
+    for (map<uint64_t, Result>::iterator it=Done.begin(); it!=Done.end(); it++)
+    {
+	delete it->second.fBlock;
+    }
+    for (size_t w=0; w<In.size(); w++)
+    {
+	std::lock_guard<std::mutex> H5(H5Mutex());
+	delete In[w].fH5;
+    }
+    pLogger->LogTime("Scheduler: %ld of %ld tasks, %ld stolen, %f s.\n",
+		     (long) Emit, (long) Sched.NTasks(), (long) Sched.Steals(),
+		     Now() - Start);
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : RunSerial
+ *
+ * Description : Read, compute and write one block at a time on 
+ *               the calling thread. 
+ *
+ * Inputs : First - first row
+ *          N     - one past the last row
+ *          Day   - day of year for the file
+ *          count - file number
+ *          Busy  - busy seconds per stage, added to
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::RunSerial(size_t First, size_t N, double Day, int32_t Key,
+			 uint32_t count, double *Busy)
+{
+    SET_DEBUG_STACK;
+    RowBlock &Block = fBlocks[0];
+    double   t0, t1, t2, t3;
+
+    Block.fFile = count;
+    Block.fDay  = Day;
+    Block.fKey  = Key;
+    while (fRun)
+    {
+	t0 = Now();
+	if (ReadBlock(Block, First, N) == 0) break;
+	t1 = Now();
+	ComputeBlock(Block);
+	t2 = Now();
+	WriteBlock(Block);
+	t3 = Now();
+	Busy[kStageRead]    += t1 - t0;
+	Busy[kStageCompute] += t2 - t1;
+	Busy[kStageWrite]   += t3 - t2;
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : RunPipeline
+ *
+ * Description : Reader on this thread, compute and writer on their
+ *               own threads. Blocks go reader -> compute -> writer 
+ *               and back to the reader through three SPSC rings. 
+ *               Only fPipelineDepth blocks exist so a slow stage 
+ *               holds the others back. An empty block marks the 
+ *               end of the file. 
+ *
+ *               Thread ownership while running: 
+ *               reader  - f5InputFile, fResample, fRaw
+ *               compute - fFilter, fProfile, f2D, f2DZ, f2DK, fCount,
+ *                         fCoverage
+ *               writer  - fNtuple, fGraph
+ *
+ * Inputs : First - first row
+ *          N     - one past the last row
+ *          Day   - day of year for the file
+ *          count - file number
+ *          Busy  - busy seconds per stage, added to
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::RunPipeline(size_t First, size_t N, double Day, int32_t Key,
+			   uint32_t count, double *Busy)
+{
+    SET_DEBUG_STACK;
+    SPSCQueue<RowBlock*> ToCompute(fBlocks.size());
+    SPSCQueue<RowBlock*> ToWrite(fBlocks.size());
+    SPSCQueue<RowBlock*> ToRead(fBlocks.size());
+    RowBlock *Block;
+    size_t   n;
+    double   t0;
+
+    for (size_t i=0; i<fBlocks.size(); i++) ToRead.Push(&fBlocks[i]);
+
+    std::thread Compute([&]()
+    {
+	RowBlock *b;
+	double    t;
+	do {
+	    ToCompute.PopWait(b);
+	    if (b->fN > 0)
+	    {
+		t = Now();
+		ComputeBlock(*b);
+		Busy[kStageCompute] += Now() - t;
+	    }
+	    ToWrite.PushWait(b);
+	} while (b->fN > 0);
+    });
+
+    std::thread Writer([&]()
+    {
+	RowBlock *b;
+	double    t;
+	do {
+	    ToWrite.PopWait(b);
+	    if (b->fN > 0)
+	    {
+		t = Now();
+		WriteBlock(*b);
+		Busy[kStageWrite] += Now() - t;
+	    }
+	    ToRead.PushWait(b);
+	} while (b->fN > 0);
+    });
+
+    do {
+	ToRead.PopWait(Block);
+	Block->fFile = count;
+	Block->fDay  = Day;
+	Block->fKey  = Key;
+	t0 = Now();
+	n  = fRun ? ReadBlock(*Block, First, N) : 0;
+	Block->fN = n;
+	Busy[kStageRead] += Now() - t0;
+	ToCompute.PushWait(Block);
+    } while (n > 0);
+
+    Compute.join();
+    Writer.join();
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadBlock
+ *
+ * Description : Read rows from the HDF5 file into the block until 
+ *               it is full or the file ends. Rows that fail to 
+ *               read are skipped. When resampling the rows go 
+ *               through fRaw and the Resampler, so the block holds
+ *               grid rows and may be more or less than full. 
+ *
+ * Inputs : Block - to fill
+ *          First - next row to read, advanced on return
+ *          N     - rows in the file
+ *
+ * Returns : rows in the block, 0 at end of file. 
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t Analysis::ReadBlock(RowBlock &Block, size_t &First, size_t N)
+{
+    const int32_t  Cols[4] = {fiUTC, fiMx, fiMy, fiMz};
+    const uint32_t Need    = fProducts.Columns();
+
+    if (fResample == NULL)
+    {
+	return ReadRows(f5InputFile, Cols, Need, Block, First, N);
+    }
+    // A block of duplicates gives no grid rows, read on. 
+    Block.fN = 0;
+    while ((Block.fN == 0) && 
+	   (ReadRows(f5InputFile, Cols, Need, fRaw, First, N) > 0))
+    {
+	fResample->Run(fRaw, Need, Block);
+    }
+    return Block.fN;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadRows
+ *
+ * Description : ReadBlock from any open file. 
+ *
+ * Inputs : h5    - open file
+ *          Cols  - UTC, Mx, My, Mz column numbers in the file
+ *          Need  - bit per RowBlock input column to copy
+ *          Block - to fill
+ *          First - next row to read, advanced on return
+ *          N     - stop before this row
+ *
+ * Returns : rows in the block
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t Analysis::ReadRows(H5Logger *h5, const int32_t *Cols, uint32_t Need,
+			  RowBlock &Block, size_t &First, size_t N)
+{
+    const double *var;        // get a row at a time from H5 file
+    const size_t Cap = Block.Capacity();
+    size_t       n   = 0;
+
+    Block.fFirst   = First;
+    Block.fSeconds = false;
+    while ((n < Cap) && (First < N))
+    {
+	if(h5->DatasetReadRow(First))
+	{
+	    var = h5->RowData();
+	    for (uint32_t c=0; c<RowBlock::kNInputCol; c++)
+	    {
+		if (Need & (1U << c)) Block.Set(c, n, var[c]);
+	    }
+	    if (Need & (1U << RowBlock::kUTC)) 
+		Block.Set(RowBlock::kUTC, n, var[Cols[0]]);
+	    if (Need & (1U << RowBlock::kMX)) 
+		Block.Set(RowBlock::kMX, n, var[Cols[1]]);
+	    if (Need & (1U << RowBlock::kMY)) 
+		Block.Set(RowBlock::kMY, n, var[Cols[2]]);
+	    if (Need & (1U << RowBlock::kMZ)) 
+		Block.Set(RowBlock::kMZ, n, var[Cols[3]]);
+	    n++;
+	}
+	First++;
+    }
+    Block.fN = n;
+    return n;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ComputeBlock
+ *
+ * Description : Magnitude, filter and the binned products for 
+ *               each row of the block. ComputeRows then FillBlock.
+ *
+ * Inputs : Block - rows from ReadBlock
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::ComputeBlock(RowBlock &Block)
+{
+    ComputeRows(Block, fFilter, fDespike);
+    FillBlock(Block);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ComputeRows
+ *
+ * Description : Per row values, despike, time, magnitude and 
+ *               filter. Touches nothing but the block, the filter
+ *               and the despiker.
+ *
+ * Inputs : Block  - rows from ReadBlock
+ *          Filter - filter to run |M| through
+ *          Spike  - despiker, NULL for none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::ComputeRows(RowBlock &Block, SFilter *Filter, 
+			   Despike *Spike) const
+{
+    const double Day  = Block.fDay;
+    const bool   Time = fProducts.Stage(Products::kTime);
+    const bool   Mag  = fProducts.Stage(Products::kMag);
+    const bool   Filt = fProducts.Stage(Products::kFilter);
+    double   *UTC  = Block.Time(RowBlock::kUTC);
+    double   *JD   = Block.Time(RowBlock::kJD);
+    double   *DSEC = Block.Time(RowBlock::kDSEC);
+    Sample_t *MX   = Block.Col(RowBlock::kMX);
+    Sample_t *MY   = Block.Col(RowBlock::kMY);
+    Sample_t *MZ   = Block.Col(RowBlock::kMZ);
+    Sample_t *MAG  = Block.Col(RowBlock::kMAG);
+    Sample_t *FILT = Block.Col(RowBlock::kFILT);
+    Sample_t *REJ  = Block.Col(RowBlock::kREJ);
+    Sample_t *TEMP = Block.Col(RowBlock::kTemp);
+    Sample_t *TDOT = Block.Col(RowBlock::kTDOT);
+    double   T, dT;
+
+    if (fTempRate && (fTempApply || fTempFitOn))
+    {
+	TempFit::Rate(TEMP, Block.fN, fTempSpan, TDOT);
+    }
+    if (fTempApply)
+    {
+	// Not the offsets, only what changes with temperature. 
+	for (size_t i=0; i<Block.fN; i++)
+	{
+	    T  = TEMP[i] - fTempRef;
+	    dT = fTempRate ? TDOT[i] : 0.0;
+	    MX[i] -= fTempCoef[0][1]*T + fTempCoef[0][2]*dT;
+	    MY[i] -= fTempCoef[1][1]*T + fTempCoef[1][2]*dT;
+	    MZ[i] -= fTempCoef[2][1]*T + fTempCoef[2][2]*dT;
+	}
+    }
+    for (size_t i=0; i<Block.fN; i++)
+    {
+	if (Spike)
+	{
+	    REJ[i] = Spike->Clean(MX[i], MY[i], MZ[i]) ? 1.0 : 0.0;
+	}
+	if (Time)
+	{
+	    // convert UTC HHMMSS.ss into sssss, the Resampler did already
+	    T       = Block.fSeconds ? UTC[i] : UTC2Sec(UTC[i]);
+	    UTC[i]  = T;
+	    JD[i]   = Day;   // start with Jan 1 is JD 1. 
+	    DSEC[i] = Day * kSecPerDay + T;
+	}
+    }
+    if (Mag)
+    {
+	// A loop of its own, in Sample_t, so it can be vectorized. 
+	for (size_t i=0; i<Block.fN; i++)
+	{
+	    MAG[i] = sqrt(MX[i]*MX[i] + MY[i]*MY[i] + MZ[i]*MZ[i]);
+	}
+    }
+    if (Filt) 
+    {
+	for (size_t i=0; i<Block.fN; i++)
+	{
+	    // NaN grid rows would stay in the filter for good. 
+	    FILT[i] = std::isnan(MAG[i]) ? MAG[i] : Filter->Filter(MAG[i]);
+	}
+    }
+    if (fTilt)
+    {
+	// A rotation, |M| and so the filter are the same either way. 
+	fTilt->Level(Block.Col(RowBlock::kAX), Block.Col(RowBlock::kAY), 
+		     Block.Col(RowBlock::kAZ), MX, MY, MZ, Block.fN,
+		     Block.Col(RowBlock::kMXL), Block.Col(RowBlock::kMYL), 
+		     Block.Col(RowBlock::kMZL));
+	Tilt::HDI(Block.Col(RowBlock::kMXL), Block.Col(RowBlock::kMYL), 
+		  Block.Col(RowBlock::kMZL), Block.fN, 
+		  Block.Col(RowBlock::kH), Block.Col(RowBlock::kD), 
+		  Block.Col(RowBlock::kI));
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : FillBlock
+ *
+ * Description : Binned products from the computed rows, in row 
+ *               order. 
+ *
+ * Inputs : Block - rows from ComputeRows
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::FillBlock(RowBlock &Block)
+{
+    const double KWeight = 3.0 * 3600.0;    // 1 sec per interval, 3 hour bins
+    const double KStation = 400.0/4900.0/2.0; 
+    // This assumes a 1/sec sample rate. 
+    const double Norm = ((double)kSecPerDay)/((double) kNTimeBin);
+    // Resampled, the day maps are sums divided by COUNT2D at the end.
+    const double W    = fResample ? 1.0 : 1.0/Norm;
+    const double Frac = fResample ? fResample->Step()/Norm : 0.0;
+    const bool   Skip = fResample && (fResample->Mode() == Resampler::kNaN);
+    const Sample_t *FILL = Block.Col(RowBlock::kFILL);
+    const double Day  = Block.fDay;
+    // Level frame components in place of the sensor ones if asked.
+    const bool      L   = fTilt && fTiltApply;
+    const double   *UTC = Block.Time(RowBlock::kUTC);
+    const Sample_t *MX  = Block.Col(L ? RowBlock::kMXL : RowBlock::kMX);
+    const Sample_t *MY  = Block.Col(L ? RowBlock::kMYL : RowBlock::kMY);
+    const Sample_t *MZ  = Block.Col(L ? RowBlock::kMZL : RowBlock::kMZ);
+    const Sample_t *MAG = Block.Col(RowBlock::kMAG);
+    const Sample_t *REJ = Block.Col(RowBlock::kREJ);
+    const Sample_t *H   = Block.Col(RowBlock::kH);
+    const Sample_t *D   = Block.Col(RowBlock::kD);
+    const Sample_t *I   = Block.Col(RowBlock::kI);
+    // The day sketches hold one day, -1 if off the axis.
+    const int32_t DayRow = fQuantiles ? DayBin(Day) : -1;
+    if (fQuantiles && (DayRow != fSketchDay))
+    {
+	CloseSketchDay();
+	fSketchDay = DayRow;
+    }
+    const bool    DayOK  = (fSketchDay >= 0);
+    double  T, Z, KIndex;
+    int32_t TBin;
+
+    for (size_t i=0; i<Block.fN; i++)
+    {
+	T       = UTC[i];      // seconds, from ComputeRows
+	Z       = MZ[i];
+
+	if (fResample)
+	{
+	    if (FILL[i] == 0.0) fCoverage->Fill(Day, T, Frac);
+	    if (Skip && (FILL[i] > 0.0)) continue;
+	    fCount->Fill(Day, T);
+	}
+	if (fProfile) fProfile->Fill(T, MAG[i]);
+	/* 
+	 * Updating from day based on file count
+	 * to Day of year. 
+	 */
+	if (f2D)  f2D->Fill (Day, T, MAG[i]*W);
+	if (f2DZ) f2DZ->Fill(Day, T, Z*W);
+	/*
+	 *  Not worrying about the K number right now. 
+	 * should be something like this 
+	 * 
+	 * K  0  1  2   3   4   5   6    7    8    9
+	 * ak 0  3  7  15  27  48  80  140  240  400 (nT)
+	 *
+	 * Factor for lowest value of nT measured. 
+	 * Full scale is: 4900 T over 16 bits
+	 * 74.8nT. 
+	 * Oh yeah and is only Z component. 
+	 * Think it goes like this, 9 is 400nT. 
+	 * KStation = 400.0/4900.0/2.0 
+	 *
+	 */
+	KIndex = Z/KWeight * KStation;
+	if (f2DK) f2DK->Fill(Day, T, KIndex);
+
+	if (fRejected && (REJ[i] > 0.0)) fRejected->Fill(Day);
+	if (fTilt)
+	{
+	    fH2D->Fill(Day, T, H[i]*W);
+	    fD2D->Fill(Day, T, D[i]*W);
+	    fI2D->Fill(Day, T, I[i]*W);
+	}
+	if (fQuantiles)
+	{
+	    TBin = (int32_t) (T/Norm);
+	    if ((TBin >= 0) && (TBin < (int32_t) kNTimeBin))
+	    {
+		fSketch[TBin].Add(MAG[i]);
+		if (DayOK) fDaySketch[TBin].Add(MAG[i]);
+	    }
+	}
+    }
+    if (fSpectra)
+    {
+	// Rows of a day run on across files, until the day changes. 
+	int32_t Bin = DayBin(Day);
+	if (Bin != fBufDay)
+	{
+	    FlushDay();
+	    fBufDay = Bin;
+	}
+	fDayBuf[kPSD_MX].insert (fDayBuf[kPSD_MX].end(),  MX,  MX+Block.fN);
+	fDayBuf[kPSD_MY].insert (fDayBuf[kPSD_MY].end(),  MY,  MY+Block.fN);
+	fDayBuf[kPSD_MZ].insert (fDayBuf[kPSD_MZ].end(),  MZ,  MZ+Block.fN);
+	fDayBuf[kPSD_MAG].insert(fDayBuf[kPSD_MAG].end(), MAG, MAG+Block.fN);
+    }
+    // Days since 1970 of the file, for the day keyed stores. fFile
+    // is not a manifest index when extracting. 
+    const int32_t Key = Block.fKey;
+    if (fBaseline)
+    {
+	if (Key != fSqKey)
+	{
+	    FlushSq();
+	    fSqKey = Key;
+	    fSqDoy = (int32_t) Day;
+	}
+	for (size_t i=0; i<Block.fN; i++)
+	{
+	    TBin = (int32_t) (UTC[i]/Norm);
+	    if ((TBin >= 0) && (TBin < (int32_t) kNTimeBin) && 
+		!std::isnan(MAG[i]))
+	    {
+		fSqSumMag[TBin] += MAG[i];
+		fSqSumZ[TBin]   += MZ[i];
+		fSqCount[TBin]  += 1.0;
+	    }
+	}
+    }
+    if (fRollup)
+    {
+	double  V[Rollup::kNQuantity];
+	int32_t k;
+	if (Key != fRollKey)
+	{
+	    FlushRollup();
+	    fRollKey = Key;
+	}
+	for (size_t i=0; i<Block.fN; i++)
+	{
+	    TBin = (int32_t) (UTC[i]/Norm);
+	    if ((TBin < 0) || (TBin >= (int32_t) kNTimeBin) || 
+		std::isnan(MAG[i])) continue;
+	    V[Rollup::kMag] = MAG[i];
+	    V[Rollup::kZ]   = MZ[i];
+	    for (uint32_t q=0; q<Rollup::kNQuantity; q++)
+	    {
+		k = q*kNTimeBin + TBin;
+		if (fRollCount[k] <= 0.0)
+		{
+		    fRollMin[k] = fRollMax[k] = V[q];
+		}
+		else
+		{
+		    fRollMin[k] = std::min(fRollMin[k], V[q]);
+		    fRollMax[k] = std::max(fRollMax[k], V[q]);
+		}
+		fRollSum[k]   += V[q];
+		fRollCount[k] += 1.0;
+	    }
+	}
+    }
+    if (fTempFit)
+    {
+	// Sensor frame, corrected if TempComp is applied. 
+	fTempFit->Add(Block.Col(RowBlock::kTemp), Block.Col(RowBlock::kTDOT),
+		      Block.Col(RowBlock::kMX), Block.Col(RowBlock::kMY), 
+		      Block.Col(RowBlock::kMZ), Block.fN);
+    }
+    if (fCheckpoint && fProducts.Stage(Products::kFilter))
+    {
+	// Filter input, to warm the filter up on resume.
+	fCheckpoint->KeepTail(MAG, Block.fN);
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteBlock
+ *
+ * Description : Ntuple and graph output for each row. 
+ *
+ * Inputs : Block - rows from ComputeBlock
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::WriteBlock(RowBlock &Block)
+{
+    const double   *T    = Block.Time(RowBlock::kUTC);
+    const Sample_t *FILT = Block.Col(RowBlock::kFILT);
+    double         row[RowBlock::kNTupleCol];
+
+    for (size_t i=0; i<Block.fN; i++)
+    {
+	if (fNtuple)
+	{
+	    Block.Row(i, row);
+	    FillTuple(fNtuple, row);
+	    if (fZones) fZones->Fill(row);
+	}
+	if (fGraph) fGraph->AddPoint(T[i], FILT[i]);
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : LogUtilization
+ *
+ * Description : Log busy time of each stage as a fraction of the 
+ *               wall time. When pipelined the stage nearest 100% 
+ *               is the bottleneck. 
+ *
+ * Inputs : Label - File or Run
+ *          Busy  - busy seconds per stage
+ *          Wall  - elapsed seconds
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::LogUtilization(const char *Label, const double *Busy, 
+			      double Wall) const
+{
+    CLogger *pLogger = CLogger::GetThis();
+    if (Wall <= 0.0) return;
+    pLogger->LogTime("%s %.3f s, utilization read %.1f%% compute %.1f%% "
+		     "write %.1f%%\n", Label, Wall, 
+		     100.0*Busy[kStageRead]/Wall, 
+		     100.0*Busy[kStageCompute]/Wall, 
+		     100.0*Busy[kStageWrite]/Wall);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : OpenInputFile
+ *
+ * Description : Open and manage the HDF5 Input file
+ *
+ * Inputs : Filename to open
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : File doesn't exist
+ * 
+ * Unit Tested on:  
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Analysis::OpenInputFile(const char *Filename)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+
+    /*
+     * open in read only mode. 
+     */
+    f5InputFile = new H5Logger( Filename, NULL, 0, true);
+    if (f5InputFile->CheckError())
+    {
+	pLogger->Log("# Failed to open H5 input file: %s\n", Filename);
+	delete f5InputFile;
+	f5InputFile = NULL;
+	return false;
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadConfiguration
+ *
+ * Description : Open read the configuration file. 
+ *
+ * Inputs : none
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on:  
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Analysis::ReadConfiguration(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    ClearError(__LINE__);
+    Config *pCFG = new Config();
+    string InputFile;
+    double CutoffFrequency, SampleRate;
+    bool   multi  = false;
+
+    /*
+     * Open the configuragtion file. 
+     */
+    try{
+	pCFG->readFile(fConfigFileName);
+    }
+    catch( const FileIOException &fioex)
+    {
+	Logger->LogError(__FILE__,__LINE__,'F',
+			 "I/O error while reading configuration file.\n");
+	return false;
+    }
+    catch (const ParseException &pex)
+    {
+	Logger->Log("# Parse error at: %s : %d - %s\n",
+		    pex.getFile(), pex.getLine(), pex.getError());
+	return false;
+    }
+
+
+    /*
+     * Start at the top. 
+     */
+    const Setting& root = pCFG->getRoot();
+
+    // USER TO FILL IN
+    // Output a list of all books in the inventory.
+    try
     {
 	int    Debug;
 	/*
@@ -641,6 +3444,109 @@ bool Analysis::ReadConfiguration(void)
 	MM.lookupValue("OutputFile"    , fOutputFileName);
 	MM.lookupValue("Multigraph"    , multi);
 	MM.lookupValue("NBins"         , fNBins);
+	MM.lookupValue("Pipeline"      , fPipeline);
+	MM.lookupValue("BlockRows"     , fBlockRows);
+	MM.lookupValue("PipelineDepth" , fPipelineDepth);
+	MM.lookupValue("StreamOutput"  , fStreamOutput);
+	MM.lookupValue("CheckpointEvery", fCheckpointEvery);
+	MM.lookupValue("CheckpointFile", fCheckpointFile);
+	MM.lookupValue("FilterWarmup"  , fFilterWarmup);
+	MM.lookupValue("ExtractStart"  , fExtractStart);
+	MM.lookupValue("ExtractEnd"    , fExtractEnd);
+	MM.lookupValue("IndexFile"     , fIndexFile);
+	MM.lookupValue("IndexStep"     , fIndexStep);
+	MM.lookupValue("ManifestFile"  , fManifestFile);
+	MM.lookupValue("ScanThreads"   , fScanThreads);
+	MM.lookupValue("LargestFirst"  , fLargestFirst);
+	MM.lookupValue("Scheduler"     , fScheduler);
+	MM.lookupValue("Workers"       , fWorkers);
+	MM.lookupValue("TaskRows"      , fTaskRows);
+	MM.lookupValue("Quantiles"     , fQuantiles);
+	MM.lookupValue("SketchCompression"   , fSketchCompression);
+	MM.lookupValue("DaySketchCompression", fDaySketchCompression);
+	MM.lookupValue("Despike"         , fDespikeOn);
+	MM.lookupValue("DespikeWindow"   , fDespikeWindow);
+	MM.lookupValue("DespikeThreshold", fDespikeThreshold);
+	MM.lookupValue("DespikeFloor"    , fDespikeFloor);
+	MM.lookupValue("PSD"             , fSpectra);
+	MM.lookupValue("PSDLength"       , fPSDLength);
+	MM.lookupValue("PSDOverlap"      , fPSDOverlap);
+	MM.lookupValue("PSDRate"         , fPSDRate);
+	MM.lookupValue("SqBaseline"      , fSq);
+	MM.lookupValue("SqFile"          , fSqFile);
+	MM.lookupValue("SqQuietDays"     , fSqQuietDays);
+	MM.lookupValue("SqWindow"        , fSqWindow);
+	MM.lookupValue("SqCoverage"      , fSqCoverage);
+	MM.lookupValue("Rollup"          , fRollOn);
+	MM.lookupValue("RollupFile"      , fRollFile);
+	MM.lookupValue("Zones"           , fZonesOn);
+	MM.lookupValue("ZoneCluster"     , fZoneCluster);
+	MM.lookupValue("Tilt"            , fTiltOn);
+	MM.lookupValue("TiltPerSample"   , fTiltPerSample);
+	MM.lookupValue("TiltApply"       , fTiltApply);
+	MM.lookupValue("TempFit"         , fTempFitOn);
+	MM.lookupValue("Resample"        , fResampleOn);
+	MM.lookupValue("ResampleStep"    , fResampleStep);
+	MM.lookupValue("ResampleMaxFill" , fResampleMaxFill);
+	MM.lookupValue("ResampleFill"    , fResampleFill);
+	if (MM.exists("TempComp"))
+	{
+	    const Setting &TC = MM["TempComp"];
+	    const char *Axis[TempFit::kNAxis] = {"X", "Y", "Z"};
+	    TC.lookupValue("Apply"   , fTempApply);
+	    TC.lookupValue("Rate"    , fTempRate);
+	    TC.lookupValue("RateSpan", fTempSpan);
+	    TC.lookupValue("Ref"     , fTempRef);
+	    TC.lookupValue("Rows"    , fTempRows);
+	    for (uint32_t a=0; a<TempFit::kNAxis; a++)
+	    {
+		if (!TC.exists(Axis[a])) continue;
+		const Setting &C = TC[Axis[a]];
+		for (int j=0; (j<C.getLength()) && (j<TempFit::kNPar); j++)
+		{
+		    fTempCoef[a][j] = C[j];
+		}
+	    }
+	}
+	if (MM.exists("Products"))
+	{
+	    const Setting &P = MM["Products"];
+	    for (int i=0; i<P.getLength(); i++)
+	    {
+		fProductNames.push_back((const char *) P[i]);
+	    }
+	}
+	MM.lookupValue("SiteTolerance"   , fSiteTolerance);
+	MM.lookupValue("SiteNtuple"      , fSiteNtuple);
+	if (MM.exists("Sites"))
+	{
+	    const Setting &S = MM["Sites"];
+	    for (int i=0; i<S.getLength(); i++)
+	    {
+		const Setting &G = S[i];
+		SiteConfig C;
+		G.lookupValue("Name"    , C.fName);
+		G.lookupValue("FileList", C.fList);
+		if (G.exists("DataDirs"))
+		{
+		    const Setting &D = G["DataDirs"];
+		    for (int j=0; j<D.getLength(); j++)
+		    {
+			C.fDirs.push_back((const char *) D[j]);
+		    }
+		}
+		if (C.fName.length() == 0) C.fName = "Site" + to_string(i);
+		fSites.push_back(C);
+	    }
+	}
+	if (MM.exists("DataDirs"))
+	{
+	    const Setting &D = MM["DataDirs"];
+	    for (int i=0; i<D.getLength(); i++)
+	    {
+		fDataDirs.push_back((const char *) D[i]);
+	    }
+	}
 
 	SetDebug(Debug);
 	if (InputFile.length()>0)
@@ -657,9 +3563,17 @@ bool Analysis::ReadConfiguration(void)
     pCFG = 0;
 
 
-    // open the input filename. 
-    fInputFileList = new ifstream(fInputFileName);
-    if(fInputFileList->fail())
+    /*
+     * Input files. Data directories if there are any, otherwise 
+     * the input file list. 
+     */
+    fManifest = new Manifest(fManifestFile.c_str(), fScanThreads);
+    if (fDataDirs.size() > 0)
+    {
+	Logger->Log("# Scan %d data directories.\n", (int)fDataDirs.size());
+	fManifest->AddDirectories(fDataDirs);
+    }
+    else if (!fManifest->AddList(fInputFileName.c_str()))
     {
 	Logger->Log("# Failed to open input file list: %s\n", 
 		    fInputFileName.data());
@@ -669,6 +3583,7 @@ bool Analysis::ReadConfiguration(void)
     {
 	Logger->Log("# Input file list: %s\n", fInputFileName.data());
     }
+    fManifest->Build();
     // Setup filter
     if (SampleRate <= 0.0)
     {
@@ -683,6 +3598,15 @@ bool Analysis::ReadConfiguration(void)
     Logger->Log("# Filter parameters set to, Cutoff: %f, Sample Rate: %f\n", 
 		CutoffFrequency, SampleRate);
     fFilter = new SFilter(CutoffFrequency, SampleRate);
+    ResolveProducts();
+    fStreamGraphs = fStreamOutput;
+    if (((fCheckpointEvery > 0) || fResume) && !fStreamOutput)
+    {
+	// Graphs held in memory would be lost on resume. For this
+	// run only, the configuration keeps what was asked for. 
+	fStreamGraphs = true;
+	Logger->Log("# Checkpoints on, StreamOutput forced on.\n");
+    }
     OpenOutputFile(fOutputFileName.data());
 
     if (multi)
@@ -694,6 +3618,70 @@ bool Analysis::ReadConfiguration(void)
     return true;
 }
 
+/**
+ ******************************************************************
+ *
+ * Function Name : ResolveProducts
+ *
+ * Description : With no Products list, the original outputs plus 
+ *               the optional ones that are switched on. With a 
+ *               list, exactly what it names, and the switches for 
+ *               the optional ones follow it. Applying TempComp 
+ *               needs Temp wherever Mx, My, Mz are read. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : unknown product names are logged and ignored
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Analysis::ResolveProducts(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+
+    if (fProductNames.empty())
+    {
+	fProducts.Default();
+	if (fQuantiles)  fProducts.Want(Products::kQuantiles);
+	if (fDespikeOn)  fProducts.Want(Products::kDespike);
+	if (fSpectra)    fProducts.Want(Products::kPSD);
+	if (fSq)         fProducts.Want(Products::kSq);
+	if (fTiltOn)     fProducts.Want(Products::kTilt);
+	if (fTempFitOn)  fProducts.Want(Products::kTempFit);
+	if (fRollOn)     fProducts.Want(Products::kRollup);
+    }
+    else
+    {
+	if (!fProducts.Select(fProductNames))
+	{
+	    Logger->Log("# Unknown name in Products, ignored.\n");
+	}
+	fQuantiles = fProducts.Has(Products::kQuantiles);
+	fDespikeOn = fProducts.Has(Products::kDespike);
+	fSpectra   = fProducts.Has(Products::kPSD);
+	fSq        = fProducts.Has(Products::kSq);
+	fTiltOn    = fProducts.Has(Products::kTilt);
+	fTempFitOn = fProducts.Has(Products::kTempFit);
+	fRollOn    = fProducts.Has(Products::kRollup);
+    }
+    fProducts.Resolve();
+    if (fTempApply && fProducts.Column(RowBlock::kMX))
+    {
+	fProducts.AddColumn(RowBlock::kTemp);
+    }
+    // The grid is placed by UTC. 
+    if (fResampleOn) fProducts.AddColumn(RowBlock::kUTC);
+    Logger->Log("# Products: %s\n", fProducts.Describe().c_str());
+    SET_DEBUG_STACK;
+}
 /**
  ******************************************************************
  *
@@ -740,6 +3728,98 @@ bool Analysis::WriteConfiguration(void)
     MM.add("OutputFile"     , Setting::TypeString) = fOutputFileName;
     MM.add("Multigraph"     , Setting::TypeBoolean)= (ftmg != NULL);
     MM.add("NBins"          , Setting::TypeInt)    = fNBins;
+    MM.add("Pipeline"       , Setting::TypeBoolean)= fPipeline;
+    MM.add("BlockRows"      , Setting::TypeInt)    = (int) fBlockRows;
+    MM.add("PipelineDepth"  , Setting::TypeInt)    = (int) fPipelineDepth;
+    MM.add("StreamOutput"   , Setting::TypeBoolean)= fStreamOutput;
+    MM.add("CheckpointEvery", Setting::TypeInt)    = (int) fCheckpointEvery;
+    MM.add("CheckpointFile" , Setting::TypeString) = fCheckpointFile;
+    MM.add("FilterWarmup"   , Setting::TypeInt)    = (int) fFilterWarmup;
+    MM.add("ExtractStart"   , Setting::TypeString) = fExtractStart;
+    MM.add("ExtractEnd"     , Setting::TypeString) = fExtractEnd;
+    MM.add("IndexFile"      , Setting::TypeString) = fIndexFile;
+    MM.add("IndexStep"      , Setting::TypeFloat)  = fIndexStep;
+    MM.add("ManifestFile"   , Setting::TypeString) = fManifestFile;
+    MM.add("ScanThreads"    , Setting::TypeInt)    = (int) fScanThreads;
+    MM.add("LargestFirst"   , Setting::TypeBoolean)= fLargestFirst;
+    MM.add("Scheduler"      , Setting::TypeBoolean)= fScheduler;
+    MM.add("Workers"        , Setting::TypeInt)    = (int) fWorkers;
+    MM.add("TaskRows"       , Setting::TypeInt)    = (int) fTaskRows;
+    MM.add("Quantiles"      , Setting::TypeBoolean)= fQuantiles;
+    MM.add("SketchCompression"   , Setting::TypeFloat) = fSketchCompression;
+    MM.add("DaySketchCompression", Setting::TypeFloat) = fDaySketchCompression;
+    MM.add("Despike"         , Setting::TypeBoolean) = fDespikeOn;
+    MM.add("DespikeWindow"   , Setting::TypeInt)     = (int) fDespikeWindow;
+    MM.add("DespikeThreshold", Setting::TypeFloat)   = fDespikeThreshold;
+    MM.add("DespikeFloor"    , Setting::TypeFloat)   = fDespikeFloor;
+    MM.add("PSD"             , Setting::TypeBoolean) = fSpectra;
+    MM.add("PSDLength"       , Setting::TypeInt)     = (int) fPSDLength;
+    MM.add("PSDOverlap"      , Setting::TypeFloat)   = fPSDOverlap;
+    MM.add("PSDRate"         , Setting::TypeFloat)   = fPSDRate;
+    MM.add("SqBaseline"      , Setting::TypeBoolean) = fSq;
+    MM.add("SqFile"          , Setting::TypeString)  = fSqFile;
+    MM.add("SqQuietDays"     , Setting::TypeInt)     = (int) fSqQuietDays;
+    MM.add("SqWindow"        , Setting::TypeInt)     = (int) fSqWindow;
+    MM.add("SqCoverage"      , Setting::TypeFloat)   = fSqCoverage;
+    MM.add("Rollup"          , Setting::TypeBoolean) = fRollOn;
+    MM.add("RollupFile"      , Setting::TypeString)  = fRollFile;
+    MM.add("Zones"           , Setting::TypeBoolean) = fZonesOn;
+    MM.add("ZoneCluster"     , Setting::TypeInt)     = (int) fZoneCluster;
+    MM.add("Tilt"            , Setting::TypeBoolean) = fTiltOn;
+    MM.add("TiltPerSample"   , Setting::TypeBoolean) = fTiltPerSample;
+    MM.add("TiltApply"       , Setting::TypeBoolean) = fTiltApply;
+    MM.add("TempFit"         , Setting::TypeBoolean) = fTempFitOn;
+    MM.add("Resample"        , Setting::TypeBoolean) = fResampleOn;
+    MM.add("ResampleStep"    , Setting::TypeFloat)   = fResampleStep;
+    MM.add("ResampleMaxFill" , Setting::TypeInt)     = (int) fResampleMaxFill;
+    MM.add("ResampleFill"    , Setting::TypeString)  = fResampleFill;
+    {
+	// Offset, per degree and per degree/sec for each axis. 
+	const char *Axis[TempFit::kNAxis] = {"X", "Y", "Z"};
+	Setting &TC = MM.add("TempComp", Setting::TypeGroup);
+	TC.add("Apply"   , Setting::TypeBoolean) = fTempApply;
+	TC.add("Rate"    , Setting::TypeBoolean) = fTempRate;
+	TC.add("RateSpan", Setting::TypeInt)     = (int) fTempSpan;
+	TC.add("Ref"     , Setting::TypeFloat)   = fTempRef;
+	TC.add("Rows"    , Setting::TypeFloat)   = fTempRows;
+	Setting &R = TC.add("RMS", Setting::TypeArray);
+	for (uint32_t a=0; a<TempFit::kNAxis; a++)
+	{
+	    R.add(Setting::TypeFloat) = fTempRMS[a];
+	}
+	for (uint32_t a=0; a<TempFit::kNAxis; a++)
+	{
+	    Setting &C = TC.add(Axis[a], Setting::TypeArray);
+	    for (uint32_t j=0; j<TempFit::kNPar; j++)
+	    {
+		C.add(Setting::TypeFloat) = fTempCoef[a][j];
+	    }
+	}
+    }
+    MM.add("SiteTolerance"   , Setting::TypeFloat)   = fSiteTolerance;
+    MM.add("SiteNtuple"      , Setting::TypeBoolean) = fSiteNtuple;
+    Setting &S = MM.add("Sites", Setting::TypeList);
+    for (size_t i=0; i<fSites.size(); i++)
+    {
+	Setting &G = S.add(Setting::TypeGroup);
+	G.add("Name"    , Setting::TypeString) = fSites[i].fName;
+	G.add("FileList", Setting::TypeString) = fSites[i].fList;
+	Setting &SD = G.add("DataDirs", Setting::TypeArray);
+	for (size_t j=0; j<fSites[i].fDirs.size(); j++)
+	{
+	    SD.add(Setting::TypeString) = fSites[i].fDirs[j];
+	}
+    }
+    Setting &P = MM.add("Products", Setting::TypeArray);
+    for (size_t i=0; i<fProductNames.size(); i++)
+    {
+	P.add(Setting::TypeString) = fProductNames[i];
+    }
+    Setting &D = MM.add("DataDirs", Setting::TypeArray);
+    for (size_t i=0; i<fDataDirs.size(); i++)
+    {
+	D.add(Setting::TypeString) = fDataDirs[i];
+    }
 
     // Write out the new configuration.
     try
@@ -18,6 +18,29 @@
  *
  * 28-Jan-24     Create Ntuple too
  * 13-Feb-24     Add in K-index style 2D histo.
+ * 19-Oct-26 CBL Reader, compute and writer stages on their own 
+ *               threads connected by lock free rings of RowBlocks.
+ * 19-Oct-26 CBL Streaming output, per file graphs written as soon 
+ *               as the file is done. 
+ * 19-Oct-26 CBL Checkpoints between input files and resume. 
+ * 19-Oct-26 CBL Time window extraction through an H5Index. 
+ * 19-Oct-26 CBL Input files from a Manifest. 
+ * 19-Oct-26 CBL Work stealing Scheduler over row range tasks. 
+ * 19-Oct-26 CBL Quantile sketches. 
+ * 19-Oct-26 CBL Optional median/MAD despike of Mx, My, Mz. 
+ * 19-Oct-26 CBL Per day Welch PSD spectrograms. 
+ * 19-Oct-26 CBL Quiet day (Sq) baseline and subtracted day maps. 
+ * 19-Oct-26 CBL Tilt compensation, H, D and I. 
+ * 19-Oct-26 CBL Temperature coefficient fit and correction. 
+ * 19-Oct-26 CBL Products, only what is asked for is computed. 
+ * 19-Oct-26 CBL Several sites merged on time, difference products. 
+ * 19-Oct-26 CBL Resample onto a uniform grid, day maps from counts. 
+ * 19-Oct-26 CBL Day, month and year rollups. 
+ * 19-Oct-26 CBL Zone map of IMUTuple clusters. 
+ * 19-Oct-26 CBL FLOAT32, float sample columns and IMUTuple branches. 
+ * 19-Oct-26 CBL Resume checks the file list, fStreamGraphs. 
+ * 19-Oct-26 CBL Day sketches held for the open day only. 
+ * 19-Oct-26 CBL fNDays, the run's day axis, NBins as configured. 
  * 
  * Classification : Unclassified
  *
@@ -28,8 +51,24 @@
  */
 #ifndef __MAINMODULE_hh_
 #define __MAINMODULE_hh_
+#  include <vector>
+#  include <cmath>
 #  include "CObject.hh" // Base class with all kinds of intermediate
 #  include "H5Logger.hh"
+#  include "RowBlock.hh"
+#  include "Checkpoint.hh"
+#  include "H5Index.hh"
+#  include "Manifest.hh"
+#  include "TDigest.hh"
+#  include "Despike.hh"
+#  include "Welch.hh"
+#  include "SqBaseline.hh"
+#  include "Rollup.hh"
+#  include "ZoneMap.hh"
+#  include "Tilt.hh"
+#  include "TempFit.hh"
+#  include "Products.hh"
+#  include "Resampler.hh"
 
 class TFile;
 class SFilter;
@@ -37,8 +76,11 @@ class TGraph;
 class TMultiGraph;
 class TLegend;
 class TNtupleD;
+class TTree;
 class TProfile;
+class TH1D;
 class TH2D;
+class TObject;
 
 class Analysis : public CObject
 {
@@ -46,12 +88,14 @@ public:
     /** 
      * Build on CObject error codes. 
      */
-    enum {ENO_FILE=1, ECONFIG_READ_FAIL, ECONFIG_WRITE_FAIL};
+    enum {ENO_FILE=1, ECONFIG_READ_FAIL, ECONFIG_WRITE_FAIL, 
+	  ERESUME_MISMATCH};
     /**
      * Constructor the lassen SK8 subsystem.
      * All inputs are in configuration file. 
+     * Resume - continue from the last checkpoint. 
      */
-    Analysis(const char *ConfigFile);
+    Analysis(const char *ConfigFile, bool Resume=false);
 
     /**
      * Destructor
@@ -89,22 +133,136 @@ private:
     const   uint32_t kSecPerDay = 86400;
     const   uint32_t kNTimeBin  = 288;
 
+    /// Pipeline stages, index into fStageBusy
+    enum {kStageRead=0, kStageCompute, kStageWrite, kNStage};
+
     /// CERN Root stuff.
     TFile       *fRootFile;
     TGraph      *fGraph;
     TProfile    *fProfile;
     TMultiGraph *ftmg;        // if this is non-null, use multiple graphs
     TLegend     *fLegend;   
-    TNtupleD    *fNtuple;   
+    TTree       *fNtuple;     // TNtupleD, a TTree of /F and /D with FLOAT32
+    double      fTupleD[RowBlock::kNTupleCol];  // FLOAT32 branch buffers,
+    float       fTupleF[RowBlock::kNTupleCol];  // time and sample columns
     TH2D        *f2D;         // Binned 2 D data - high res bin
     TH2D        *f2DZ;        // Binned 2 D data - high res bin, Z only
     TH2D        *f2DK;        // binned on 3 hour intervals. K_Index
     uint32_t    fExpected;    // Number of files expected. 
-    int32_t     fNBins;
+    int32_t     fNBins;       // Configured, if the manifest has no days
+    int32_t     fNDays;       // Bins on the day axis of this run
+    double      fDayMin;      // Low edge of the day axis, 1 day bins
+
+    /// Outputs asked for, everything if the list is empty. 
+    std::vector<string> fProductNames;
+    Products     fProducts;
 
     /// File management
-    ifstream     *fInputFileList;
-    string       fInputFileName;
+    Manifest     *fManifest;
+    string       fInputFileName;   // File list, if no DataDirs
+    std::vector<string> fDataDirs;
+    string       fManifestFile;    // Manifest cache
+    uint32_t     fScanThreads;
+    bool         fLargestFirst;    // Most rows first, else by date
+
+    /// Scheduler, row range tasks on worker threads. 
+    bool         fScheduler;
+    uint32_t     fWorkers;
+    uint32_t     fTaskRows;        // Largest task
+
+    /// Quantile sketches of |M|, by time bin and by day and time bin.
+    bool         fQuantiles;
+    double       fSketchCompression;
+    double       fDaySketchCompression;
+    std::vector<TDigest> fSketch;
+    std::vector<TDigest> fDaySketch;   // kNTimeBin, day fSketchDay
+    int32_t      fSketchDay;           // Day bin being sketched, -1 none
+    /// Day major, packed centroids of each closed day and time bin.
+    std::vector<std::vector<double> > fDayPacked;
+
+    /// Despike ahead of everything else. 
+    bool         fDespikeOn;
+    uint32_t     fDespikeWindow;
+    double       fDespikeThreshold;  // Robust sigmas
+    double       fDespikeFloor;      // Smallest MAD
+    Despike     *fDespike;           // Owned by the compute stage
+    TH1D        *fRejected;          // Replaced samples per day
+
+    /// Welch PSD of Mx, My, Mz and |M| for each day. 
+    enum {kPSD_MX=0, kPSD_MY, kPSD_MZ, kPSD_MAG, kNPSD};
+    bool         fSpectra;
+    uint32_t     fPSDLength;         // Samples per FFT
+    double       fPSDOverlap;        // Fraction
+    double       fPSDRate;           // Sample rate, Hz
+    Welch       *fWelch;
+    TH2D        *fPSD[kNPSD];        // Day by frequency, summed 
+    TH1D        *fPSDSeg;            // Segments summed per day
+    std::vector<double> fDayBuf[kNPSD]; // The day being collected
+    int32_t      fBufDay;            // Its bin on the day axis, -1 none
+
+    /// Quiet day baseline, cached between runs. 
+    bool         fSq;
+    string       fSqFile;
+    uint32_t     fSqQuietDays;
+    uint32_t     fSqWindow;          // Days
+    double       fSqCoverage;        // Fraction of bins for a quiet day
+    SqBaseline  *fBaseline;
+    std::vector<double> fSqSumMag, fSqSumZ, fSqCount; // Day collected
+    int32_t      fSqKey;             // Its days since 1970, -1 none
+    int32_t      fSqDoy;
+
+    /// Day, month and year rollups, kept in RollupFile. 
+    bool         fRollOn;
+    string       fRollFile;
+    Rollup      *fRollup;
+    /// Day collected, |M| then Z, Rollup::kNQuantity*kNTimeBin
+    std::vector<double> fRollSum, fRollMin, fRollMax, fRollCount;
+    int32_t      fRollKey;           // Its days since 1970, -1 none
+
+    /// Per cluster min and max of IMUTuple, IMUZones.
+    bool         fZonesOn;
+    uint32_t     fZoneCluster;       // Entries, also the AutoFlush
+    ZoneMap     *fZones;
+
+    /// Tilt compensation from the accelerometer. 
+    bool         fTiltOn;
+    bool         fTiltPerSample;     // Else the block mean gravity
+    bool         fTiltApply;         // Level frame into the products
+    Tilt        *fTilt;
+    TH2D        *fH2D;               // Day by time, like ABSMAG2D
+    TH2D        *fD2D;
+    TH2D        *fI2D;
+
+    /// Temperature coefficients, TempComp group in the config. 
+    bool         fTempFitOn;         // Fit this run
+    bool         fTempApply;         // Correct with fTempCoef
+    bool         fTempRate;          // dT/dt term in the model
+    uint32_t     fTempSpan;          // Rows each side for dT/dt
+    double       fTempRef;           // Reference temperature
+    double       fTempCoef[TempFit::kNAxis][TempFit::kNPar];
+    double       fTempRMS[TempFit::kNAxis];
+    double       fTempRows;          // Rows behind fTempCoef
+    TempFit     *fTempFit;
+
+    /// Sites read together, differences to the first one. 
+    struct SiteConfig {
+	string   fName;
+	std::vector<string> fDirs;   // Data directories, or
+	string   fList;              // a file list
+    };
+    std::vector<SiteConfig> fSites;
+    double       fSiteTolerance;     // Seconds
+    bool         fSiteNtuple;        // SiteDiff ntuple as well
+
+    /// Uniform time grid. The day maps then divide by fCount. 
+    bool         fResampleOn;
+    double       fResampleStep;      // Seconds
+    uint32_t     fResampleMaxFill;   // Longest gap filled, in steps
+    string       fResampleFill;      // "linear" or "nan"
+    Resampler   *fResample;          // Reader thread while running
+    RowBlock     fRaw;               // Rows as read, before the grid
+    TH2D        *fCount;             // Rows in each day map bin
+    TH2D        *fCoverage;          // Fraction of each bin measured
     string       fOutputFileName;
 
     /// Main run stuff
@@ -123,6 +281,43 @@ private:
     /// Filtering of data. 
     SFilter     *fFilter;
 
+    /// Pipeline
+    bool         fPipeline;       // Stages on their own threads
+    uint32_t     fBlockRows;      // Rows per RowBlock
+    uint32_t     fPipelineDepth;  // RowBlocks in flight
+    std::vector<RowBlock> fBlocks;
+    /// Input column indices for the current file. 
+    int32_t      fiUTC, fiMx, fiMy, fiMz;
+    /// Busy seconds per stage and wall seconds, whole run. 
+    double       fStageBusy[kNStage];
+    double       fStageWall;
+
+    /// Streaming output, a graph that has been written and deleted.
+    struct GraphRef {
+	string  fKey;      // Key in the root file
+	string  fTitle;    // Legend label
+	int     fColor;
+    };
+    bool         fStreamOutput;    // As configured
+    bool         fStreamGraphs;    // In effect, forced on by checkpoints
+    std::vector<GraphRef> fGraphIndex;
+
+    /// Checkpoint and resume. 
+    bool         fResume;          // Continue from CheckpointFile
+    uint32_t     fCheckpointEvery; // Files between checkpoints, 0 off
+    string       fCheckpointFile;
+    uint32_t     fFilterWarmup;    // Filter inputs kept for warm up
+    uint32_t     fStartFile;       // First file in the list to do
+    bool         fRefused;         // Resume refused, output left be
+    Checkpoint  *fCheckpoint;
+
+    /// Time window extraction, off if ExtractStart is empty. 
+    string       fExtractStart;    // "2024-05-10 16:00:00" UTC
+    string       fExtractEnd;
+    string       fIndexFile;       // H5Index cache
+    double       fIndexStep;       // Seconds between row offsets
+    H5Index     *fIndex;
+
 
     /* Private functions. ==============================  */
 
@@ -134,19 +329,164 @@ private:
     bool OpenOutputFile(const char *Filename);
 
     bool CreateNTuple(void);
-
-    uint32_t CountFiles(void);
+    /*!
+     * IMUTuple either way it is built. A TNtupleD, or with FLOAT32
+     * a TTree with the time columns /D and the rest /F, bound to
+     * fTupleD and fTupleF. Rows in and out are always double. 
+     */
+    TTree* NewTuple(const char *Name);
+    void   BindTuple(TTree *T, bool Make);
+    void   FillTuple(TTree *T, const double *row);
+    void   TupleRow(TTree *T, int64_t i, double *row);
 
     /*!
      * Read the configuration file. 
      */
     bool ReadConfiguration(void);
+    /*!
+     * Products from the list or the feature switches, and the 
+     * switches set to match. 
+     */
+    void ResolveProducts(void);
     /*!
      * Write the configuration file. 
      */
     bool WriteConfiguration(void);
 
-    bool ProcessData(uint32_t count);
+    bool ProcessData(uint32_t count, size_t First=0, size_t Last=SIZE_MAX);
+
+    /*!
+     * Output after each file. 
+     */
+    void EndFile(uint32_t count, const char *Title, const char *ProfName);
+
+    /*!
+     * Only the rows between ExtractStart and ExtractEnd, from the 
+     * files that overlap it. 
+     */
+    void Extract(void);
+
+    /*!
+     * Sites merged on Time, each site less the first in the 
+     * SiteDiff ntuple and DIFF2D_ day maps. 
+     */
+    void RunSites(void);
+
+    /*!
+     * Day maps from sums to means, divided by fCount. Once, just
+     * before they are written. 
+     */
+    void NormalizeCounts(void);
+
+    /*!
+     * Pipeline stages. Each works on one block at a time. 
+     */
+    size_t ReadBlock(RowBlock &Block, size_t &First, size_t N);
+    void   ComputeBlock(RowBlock &Block);
+    /*!
+     * The parts of the stages the scheduler runs apart. ReadRows 
+     * and ComputeRows are safe on any thread with their own file
+     * and filter, FillBlock and WriteBlock are not. 
+     */
+    static size_t ReadRows(H5Logger *h5, const int32_t *Cols, 
+			   uint32_t Need, RowBlock &Block, size_t &First, 
+			   size_t N);
+    void   ComputeRows(RowBlock &Block, SFilter *Filter, 
+		       Despike *Spike) const;
+    void   FillBlock(RowBlock &Block);
+    void   WriteBlock(RowBlock &Block);
+    /*!
+     * Run the stages over rows First to N of the current file, 
+     * either in turn on this thread or on three threads. 
+     * Busy time per stage is added to Busy. 
+     */
+    void   RunSerial(size_t First, size_t N, double Day, int32_t Key, 
+		     uint32_t count, double *Busy);
+    void   RunPipeline(size_t First, size_t N, double Day, int32_t Key, 
+		       uint32_t count, double *Busy);
+    /*!
+     * Files in Order as row range tasks on fWorkers threads, merged
+     * in order on this one. 
+     */
+    void   RunScheduled(const std::vector<uint32_t> &Order);
+    void   LogUtilization(const char *Label, const double *Busy, 
+			  double Wall) const;
+
+    /*!
+     * Streaming output. Write the current graph, free it and 
+     * remember only its key, title and color. At the end the 
+     * legend and the IMUIndex list are made from those. 
+     */
+    void   StreamGraph(uint32_t count, const char *Title);
+    void   WriteGraphIndex(void);
+
+    /*!
+     * P05, P50, P95 histograms from the sketches. 
+     */
+    void   WriteQuantiles(void);
+    /*!
+     * The open day's sketches packed into fDayPacked, merged with
+     * what is there, and their memory given back. 
+     */
+    void   CloseSketchDay(void);
+
+    /*!
+     * Day axis helpers. DayBin is the 0 based day bin, -1 if off 
+     * the axis. DayTimeHist a new TH2D with the ABSMAG2D day axis.
+     */
+    inline int32_t DayBin(double Day) const {
+	int32_t b = (int32_t) floor(Day - fDayMin);
+	return ((b >= 0) && (b < fNDays)) ? b : -1;};
+    TH2D*  DayTimeHist(const char *Name, const char *Title, 
+		       int32_t NY, double YMin, double YMax) const;
+
+    /*!
+     * Spectra of the day held in fDayBuf added to the PSD 
+     * histograms, one thread per series. WriteSpectra divides 
+     * each day by its segment count at the end. 
+     */
+    void   FlushDay(void);
+    void   WriteSpectra(void);
+
+    /*!
+     * Day sums to the Sq baseline, and at the end ABSMAG2D_SQ and 
+     * Z2D_SQ, the day bin means less the baseline. 
+     */
+    void   FlushSq(void);
+    void   WriteBaseline(void);
+
+    /*!
+     * Day statistics to the rollups, which are written at 
+     * checkpoints and the end. 
+     */
+    void   FlushRollup(void);
+    void   WriteRollup(void);
+
+    /*!
+     * Solve the temperature fit into fTempCoef, for 
+     * WriteConfiguration. 
+     */
+    void   EndTempFit(void);
+
+    /*!
+     * Checkpoint between files. NextFile is the index of the 
+     * first file not yet done. Restore reloads the last one, 
+     * trims the ntuple back to it and warms up the filter.
+     */
+    Checkpoint::ObjectList CheckpointObjects(std::vector<TObject*> &Made);
+    bool   SaveCheckpoint(uint32_t NextFile);
+    bool   Restore(void);
+    /*!
+     * Manifest indices in the order the files are run, and what a
+     * checkpoint at NextFile in that order is over. 
+     */
+    std::vector<uint32_t> RunOrder(void) const;
+    Checkpoint::FileList  RunFiles(uint32_t NextFile) const;
+    /*!
+     * Everything written to the output file at the end, not done 
+     * if the resume was refused. 
+     */
+    void   WriteOutput(void);
 
     /*! The static 'this' pointer. */
     static Analysis *fAnalysis;
@@ -0,0 +1,372 @@
+/********************************************************************
+ *
+ * Module Name : Checkpoint.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Checkpoint state for long Analysis runs. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Run file list saved and read back. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstdio>
+
+// CERN root includes 
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TNamed.h>
+#include <TParameter.h>
+#include <TVectorD.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "Checkpoint.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Checkpoint constructor
+ *
+ * Description : 
+ *
+ * Inputs : Filename - checkpoint file name
+ *          Warmup   - filter input samples to keep
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Checkpoint::Checkpoint(const char *Filename, uint32_t Warmup)
+{
+    SET_DEBUG_STACK;
+    fFilename = Filename;
+    fFile     = NULL;
+    fNextFile = 0;
+    fEntries  = 0;
+    fTail.resize(Warmup > 0 ? Warmup : 1);
+    fTailPos  = 0;
+    fTailN    = 0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Checkpoint destructor
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Checkpoint::~Checkpoint(void)
+{
+    SET_DEBUG_STACK;
+    Close();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : KeepTail
+ *
+ * Description : Keep the last values of the filter input. Only the
+ *               end of a long block is copied. 
+ *
+ * Inputs : x - values
+ *          n - number of values
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+template <class T> void Checkpoint::KeepTail(const T *x, size_t n)
+{
+    const size_t W = fTail.size();
+    size_t i = (n > W) ? n - W : 0;
+    for (; i<n; i++)
+    {
+	fTail[fTailPos] = x[i];
+	fTailPos = (fTailPos + 1) % W;
+	if (fTailN < W) fTailN++;
+    }
+}
+template void Checkpoint::KeepTail<double>(const double *x, size_t n);
+template void Checkpoint::KeepTail<float>(const float *x, size_t n);
+/**
+ ******************************************************************
+ *
+ * Function Name : Tail
+ *
+ * Description : Unroll the ring, oldest first. 
+ *
+ * Inputs : none
+ *
+ * Returns : the kept values
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+vector<double> Checkpoint::Tail(void) const
+{
+    const size_t W = fTail.size();
+    vector<double> rv(fTailN);
+    size_t start = (fTailPos + W - fTailN) % W;
+    for (size_t i=0; i<fTailN; i++)
+    {
+	rv[i] = fTail[(start + i) % W];
+    }
+    return rv;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Write
+ *
+ * Description : Write to Filename.tmp then rename over the old 
+ *               checkpoint. A crash during the write leaves the 
+ *               previous checkpoint in place. 
+ *
+ * Inputs : NextFile - next file index in the list
+ *          Entries  - ntuple entries on disk
+ *          List     - files of the run
+ *          Objects  - objects to save
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : file can not be created or renamed
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Checkpoint::Write(uint32_t NextFile, int64_t Entries, 
+		       const FileList &List, const ObjectList &Objects)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    string   Tmp     = fFilename + ".tmp";
+    vector<double> T = Tail();
+    // Opening a file changes gDirectory, the caller writes to its own.
+    TDirectory *Save = gDirectory;
+
+    TFile *f = new TFile(Tmp.c_str(), "RECREATE", "Analysis checkpoint");
+    if (f->IsZombie())
+    {
+	pLogger->Log("# Could not create checkpoint %s\n", Tmp.c_str());
+	delete f;
+	Save->cd();
+	return false;
+    }
+    TParameter<Long64_t> Next("NextFile", NextFile);
+    TParameter<Long64_t> NEnt("Entries", Entries);
+    TParameter<Long64_t> LSize("ListSize", List.fSize);
+    TParameter<Long64_t> LHash("ListHash", (Long64_t) List.fHash);
+    TParameter<Long64_t> LTime("NextMTime", List.fNextMTime);
+    TNamed               LName("NextName", List.fNextName.c_str());
+    TVectorD Tv(T.size());
+    for (size_t i=0; i<T.size(); i++) Tv[i] = T[i];
+
+    f->WriteTObject(&Next);
+    f->WriteTObject(&NEnt);
+    f->WriteTObject(&LSize);
+    f->WriteTObject(&LHash);
+    f->WriteTObject(&LTime);
+    f->WriteTObject(&LName);
+    f->WriteTObject(&Tv, "FilterTail");
+    for (size_t i=0; i<Objects.size(); i++)
+    {
+	if (Objects[i].second) 
+	{
+	    f->WriteTObject(Objects[i].second, Objects[i].first.c_str());
+	}
+    }
+    f->Close();
+    delete f;
+    Save->cd();
+
+    if (rename(Tmp.c_str(), fFilename.c_str()) != 0)
+    {
+	pLogger->Log("# Could not rename checkpoint %s\n", Tmp.c_str());
+	return false;
+    }
+    fNextFile = NextFile;
+    fEntries  = Entries;
+    fList     = List;
+    pLogger->LogTime("Checkpoint: next file %d, entries %ld\n", 
+		     NextFile, (long) Entries);
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Read
+ *
+ * Description : Open the checkpoint file and load the file position, 
+ *               entry count, file list and filter tail. The file 
+ *               stays open so the caller can Get the saved objects. 
+ *
+ * Inputs : none
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : no checkpoint or it is incomplete
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Checkpoint::Read(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    TDirectory *Save = gDirectory;
+
+    Close();
+    fFile = TFile::Open(fFilename.c_str());
+    Save->cd();
+    if ((fFile == NULL) || fFile->IsZombie())
+    {
+	pLogger->Log("# No checkpoint %s\n", fFilename.c_str());
+	delete fFile;
+	fFile = NULL;
+	return false;
+    }
+    TParameter<Long64_t> *Next = (TParameter<Long64_t> *)fFile->Get("NextFile");
+    TParameter<Long64_t> *NEnt = (TParameter<Long64_t> *)fFile->Get("Entries");
+    TVectorD *Tv = (TVectorD *) fFile->Get("FilterTail");
+    TParameter<Long64_t> *LSize=(TParameter<Long64_t> *)fFile->Get("ListSize");
+    TParameter<Long64_t> *LHash=(TParameter<Long64_t> *)fFile->Get("ListHash");
+    TParameter<Long64_t> *LTime=(TParameter<Long64_t> *)fFile->Get("NextMTime");
+    TNamed               *LName=(TNamed *) fFile->Get("NextName");
+    if ((Next == NULL) || (NEnt == NULL))
+    {
+	pLogger->Log("# Checkpoint %s incomplete\n", fFilename.c_str());
+	Close();
+	return false;
+    }
+    fNextFile = Next->GetVal();
+    fEntries  = NEnt->GetVal();
+    fList     = FileList();
+    if (LSize && LHash && LTime && LName)
+    {
+	fList.fSize      = (uint32_t) LSize->GetVal();
+	fList.fHash      = (uint64_t) LHash->GetVal();
+	fList.fNextMTime = LTime->GetVal();
+	fList.fNextName  = LName->GetTitle();
+    }
+    fTailPos  = 0;
+    fTailN    = 0;
+    if (Tv)
+    {
+	vector<double> T(Tv->GetNrows());
+	for (int i=0; i<Tv->GetNrows(); i++) T[i] = (*Tv)[i];
+	KeepTail(T.data(), T.size());
+    }
+    pLogger->LogTime("Resume from checkpoint: next file %d, entries %ld\n", 
+		     fNextFile, (long) fEntries);
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Get
+ *
+ * Description : Saved object by name. 
+ *
+ * Inputs : Name
+ *
+ * Returns : object or NULL
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+TObject* Checkpoint::Get(const char *Name)
+{
+    if (fFile == NULL) return NULL;
+    return fFile->Get(Name);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Close
+ *
+ * Description : Close the file opened by Read
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Checkpoint::Close(void)
+{
+    if (fFile)
+    {
+	TDirectory *Save = gDirectory;
+	fFile->Close();
+	delete fFile;
+	fFile = NULL;
+	Save->cd();
+    }
+}
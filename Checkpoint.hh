@@ -0,0 +1,115 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Checkpoint.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Checkpoint state for long Analysis runs. Holds the 
+ * tail of the filter input so the filter can be warmed back up, 
+ * and writes/reads a small root file with the position in the 
+ * file list, the number of ntuple entries on disk and copies of 
+ * the accumulated histograms. The file is written under a 
+ * temporary name and renamed so there is always one consistent 
+ * checkpoint on disk. 
+ *
+ * The position is only good for the same files in the same order, 
+ * so the checkpoint also keeps what the run was over: the number of
+ * files, a hash of their names, sizes and times in run order, and 
+ * the name and time of the next file. A resume that does not match
+ * is refused. 
+ *
+ * Restrictions/Limitations : Only written between input files. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL KeepTail takes float as well. 
+ * 19-Oct-26 CBL FileList, what the position is in. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __CHECKPOINT_hh_
+#define __CHECKPOINT_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <string>
+#  include <vector>
+#  include <utility>
+
+class TFile;
+class TObject;
+
+class Checkpoint {
+public:
+    /// Objects to save and the key to save them under.
+    typedef std::vector<std::pair<std::string, TObject*> > ObjectList;
+
+    /// The files of a run, so a resume can tell it has the same ones.
+    struct FileList {
+	uint32_t    fSize;        // Files in the run
+	uint64_t    fHash;        // Names, sizes and times in run order
+	std::string fNextName;    // Next file to do, empty at the end
+	int64_t     fNextMTime;
+	FileList(void) : fSize(0), fHash(0), fNextMTime(0) {};
+	inline bool operator==(const FileList &L) const
+	    {return (fSize == L.fSize) && (fHash == L.fHash) && 
+		    (fNextName == L.fNextName) && 
+		    (fNextMTime == L.fNextMTime);};
+    };
+
+    /*!
+     * Filename - checkpoint file
+     * Warmup   - number of filter input samples to keep
+     */
+    Checkpoint(const char *Filename, uint32_t Warmup);
+    ~Checkpoint(void);
+
+    /// Keep the last Warmup values of x, called per block. 
+    /// Double or float, for the FLOAT32 blocks.
+    template <class T> void KeepTail(const T *x, size_t n);
+    /// Tail in time order, oldest first. 
+    std::vector<double> Tail(void) const;
+
+    /*!
+     * Description: 
+     *   Write a new checkpoint. 
+     *
+     * Arguments:
+     *   NextFile - index in the file list of the next file to do
+     *   Entries  - ntuple entries on disk
+     *   List     - the files NextFile is an index into
+     *   Objects  - histograms etc to save and their keys
+     *
+     * Returns:
+     *   true on success
+     */
+    bool Write(uint32_t NextFile, int64_t Entries, const FileList &List,
+	       const ObjectList &Objects);
+
+    /// Open the last checkpoint and load the position and tail. 
+    bool Read(void);
+    /// Get a saved object, only good between Read and Close. 
+    TObject* Get(const char *Name);
+    void Close(void);
+
+    inline uint32_t NextFile(void) const {return fNextFile;};
+    inline int64_t  Entries(void)  const {return fEntries;};
+    /// As written, fSize 0 if the checkpoint predates the list. 
+    inline const FileList& List(void) const {return fList;};
+
+private:
+    std::string fFilename;
+    TFile       *fFile;        // Open after Read
+    uint32_t    fNextFile;
+    int64_t     fEntries;
+    FileList    fList;
+
+    /// Ring of the last filter inputs
+    std::vector<double> fTail;
+    size_t      fTailPos;
+    size_t      fTailN;
+};
+#endif
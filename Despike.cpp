@@ -0,0 +1,265 @@
+/********************************************************************
+ *
+ * Module Name : Despike.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Sliding window median/MAD despiker. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL NaN passed through, not counted as a spike. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ * Hampel filter, F. Hampel, "The Influence Curve and its Role in
+ * Robust Estimation", JASA 69, 1974. 
+ *
+ ********************************************************************/
+// System includes.
+#include <cmath>
+using namespace std;
+
+// Local Includes.
+#include "Despike.hh"
+
+/// MAD to sigma for normal data. 
+static const double kMADSigma = 1.4826;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SlidingMedian constructor
+ *
+ * Description : 
+ *
+ * Inputs : Window - number of values
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SlidingMedian::SlidingMedian(uint32_t Window)
+{
+    fWindow = (Window > 0) ? Window : 1;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : Remove the oldest from whichever half holds it, 
+ *               insert the new one on its side and rebalance. Nodes
+ *               move between the halves without reallocation. 
+ *
+ * Inputs : x - value
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SlidingMedian::Add(double x)
+{
+    std::multiset<double>::iterator it;
+    std::multiset<double>::node_type Node;
+
+    if (fRing.size() >= fWindow)
+    {
+	// Reuse the oldest value's node, no allocation once full.
+	double Old = fRing.front();
+	fRing.pop_front();
+	it = fLo.find(Old);
+	if (it != fLo.end()) Node = fLo.extract(it);
+	else Node = fHi.extract(fHi.find(Old));
+	Node.value() = x;
+    }
+    fRing.push_back(x);
+    bool Low = fLo.empty() || (x <= *fLo.rbegin());
+    if (Node.empty())
+    {
+	if (Low) fLo.insert(x);
+	else fHi.insert(x);
+    }
+    else
+    {
+	if (Low) fLo.insert(std::move(Node));
+	else fHi.insert(std::move(Node));
+    }
+    Balance();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Balance
+ *
+ * Description : Keep fLo the same size as fHi or one larger. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SlidingMedian::Balance(void)
+{
+    while (fLo.size() > fHi.size() + 1)
+    {
+	fHi.insert(fLo.extract(--fLo.end()));
+    }
+    while (fHi.size() > fLo.size())
+    {
+	fLo.insert(fHi.extract(fHi.begin()));
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Median
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : median, 0 if empty
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double SlidingMedian::Median(void) const
+{
+    if (fLo.empty()) return 0.0;
+    if (fLo.size() > fHi.size()) return *fLo.rbegin();
+    return 0.5*(*fLo.rbegin() + *fHi.begin());
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Despike constructor
+ *
+ * Description : 
+ *
+ * Inputs : Window    - samples in the median window
+ *          Threshold - robust sigmas to reject at
+ *          Floor     - smallest MAD used
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Despike::Despike(uint32_t Window, double Threshold, double Floor) :
+    fMed{SlidingMedian(Window), SlidingMedian(Window), SlidingMedian(Window)},
+    fDev{SlidingMedian(Window), SlidingMedian(Window), SlidingMedian(Window)}
+{
+    fThreshold = Threshold;
+    fFloor     = Floor;
+    fMinFill   = (Window + 1)/2;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Clean
+ *
+ * Description : All three components. 
+ *
+ * Inputs : X, Y, Z - sample, spikes replaced
+ *
+ * Returns : true if any was replaced
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Despike::Clean(Sample_t &X, Sample_t &Y, Sample_t &Z)
+{
+    // No short circuit, every component's window has to move. 
+    bool rx = Clean(0, X);
+    bool ry = Clean(1, Y);
+    bool rz = Clean(2, Z);
+    return rx || ry || rz;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Clean
+ *
+ * Description : One component. The raw value goes into the window
+ *               either way, the median does not care about one 
+ *               spike and a real step is followed within half a 
+ *               window. A NaN is a gap left on purpose, by the 
+ *               resampler with ResampleFill nan, it is passed 
+ *               through and does not go in the window. 
+ *
+ * Inputs : c - component
+ *          x - value, replaced if a finite spike
+ *
+ * Returns : true if replaced
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Despike::Clean(uint32_t c, Sample_t &x)
+{
+    if (std::isnan(x)) return false;
+
+    const double Med = fMed[c].Median();
+    const double Dev = fabs(x - Med);
+    double       MAD = fDev[c].Median();
+    bool         rc  = false;
+
+    if (MAD < fFloor) MAD = fFloor;
+    if ((fMed[c].Size() >= fMinFill) && (Dev > fThreshold*kMADSigma*MAD))
+    {
+	rc = true;
+    }
+    fMed[c].Add(x);
+    fDev[c].Add(Dev);
+    if (rc) x = Med;
+    return rc;
+}
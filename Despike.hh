@@ -0,0 +1,83 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Despike.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Sliding window median/MAD despiker for the three
+ * magnetometer components. A sample further than Threshold robust
+ * sigmas from the median of the previous Window samples is 
+ * replaced by that median. The median is kept in two multisets, 
+ * so each sample costs O(log Window). The MAD is the sliding 
+ * median of |x - median| as each sample came in, a second 
+ * SlidingMedian, rather than recomputed over the window. 
+ *
+ * Restrictions/Limitations : Causal, looks only back. Nothing is
+ * rejected until the window is half full. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Clean takes Sample_t, the medians stay double. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __DESPIKE_hh_
+#define __DESPIKE_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <deque>
+#  include <set>
+#  include "RowBlock.hh"
+
+/// Median of the last Window values. 
+class SlidingMedian
+{
+public:
+    SlidingMedian(uint32_t Window);
+    /// Add x, dropping the oldest value once the window is full.
+    void   Add(double x);
+    double Median(void) const;
+    inline size_t Size(void) const {return fRing.size();};
+
+private:
+    uint32_t                fWindow;
+    std::deque<double>      fRing;    // Values in arrival order
+    std::multiset<double>   fLo;      // Lower half, may hold one more
+    std::multiset<double>   fHi;      // Upper half
+    void   Balance(void);
+};
+
+class Despike
+{
+public:
+    /*!
+     * Window    - samples in the median window
+     * Threshold - robust sigmas, 1.4826*MAD, to reject at
+     * Floor     - smallest MAD used, sensor units. Quiet data from
+     *             a quantized sensor has a MAD of 0. 
+     */
+    Despike(uint32_t Window, double Threshold, double Floor);
+
+    /*!
+     * Description: 
+     *   Check each component, replace spikes with the median. 
+     *
+     * Returns:
+     *   true if any component was replaced
+     */
+    bool   Clean(Sample_t &X, Sample_t &Y, Sample_t &Z);
+
+private:
+    double        fThreshold;
+    double        fFloor;
+    size_t        fMinFill;
+    SlidingMedian fMed[3];
+    SlidingMedian fDev[3];
+
+    bool   Clean(uint32_t c, Sample_t &x);
+};
+#endif
@@ -0,0 +1,499 @@
+/********************************************************************
+ *
+ * Module Name : H5Index.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Time index over the HDF5 archive. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Cache in a map by name, Build without stat. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "H5Logger.hh"
+#include "H5Index.hh"
+
+/// Sort entries by start time. 
+static bool EarlierFirst(const H5IndexEntry &a, const H5IndexEntry &b)
+{
+    return a.fFirst < b.fFirst;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : H5Index constructor
+ *
+ * Description : 
+ *
+ * Inputs : Step - seconds between coarse row offsets
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+H5Index::H5Index(double Step)
+{
+    fStep = (Step > 0.0) ? Step : 600.0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Build
+ *
+ * Description : Stat each file and Build from the sizes and times.
+ *
+ * Inputs : Files - HDF5 files
+ *          Cache - cache file name, may be NULL
+ *
+ * Returns : number of files in the index
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t H5Index::Build(const vector<string> &Files, const char *Cache)
+{
+    SET_DEBUG_STACK;
+    vector<H5IndexEntry> Known;
+    H5IndexEntry Entry;
+    struct stat  st;
+
+    for (size_t i=0; i<Files.size(); i++)
+    {
+	if (stat(Files[i].c_str(), &st) != 0)
+	{
+	    CLogger::GetThis()->Log("# Index: can not stat %s\n", 
+				    Files[i].c_str());
+	    continue;
+	}
+	Entry.fName  = Files[i];
+	Entry.fMTime = st.st_mtime;
+	Entry.fSize  = st.st_size;
+	Known.push_back(Entry);
+    }
+    SET_DEBUG_STACK;
+    return Build(Known, Cache);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Build
+ *
+ * Description : Take the cached entry by name if the size and 
+ *               modification time match, otherwise index the file.
+ *               Files that can not be opened are dropped. The 
+ *               cache is written again if a file was indexed or a
+ *               cached file is no longer asked for. 
+ *
+ * Inputs : Files - fName, fMTime and fSize of the HDF5 files
+ *          Cache - cache file name, may be NULL
+ *
+ * Returns : number of files in the index
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t H5Index::Build(const vector<H5IndexEntry> &Files, const char *Cache)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    map<string, H5IndexEntry> Cached;
+    map<string, H5IndexEntry>::const_iterator it;
+    H5IndexEntry Entry;
+    size_t       NNew = 0, NUsed = 0;
+
+    if (Cache) Load(Cache, Cached);
+
+    fEntry.clear();
+    for (size_t i=0; i<Files.size(); i++)
+    {
+	it = Cached.find(Files[i].fName);
+	if ((it != Cached.end()) &&
+	    (it->second.fMTime == Files[i].fMTime) &&
+	    (it->second.fSize  == Files[i].fSize))
+	{
+	    fEntry.push_back(it->second);
+	    NUsed++;
+	    continue;
+	}
+	Entry.fMTime = Files[i].fMTime;
+	Entry.fSize  = Files[i].fSize;
+	if (IndexFile(Files[i].fName, Entry))
+	{
+	    fEntry.push_back(Entry);
+	    NNew++;
+	}
+    }
+    sort(fEntry.begin(), fEntry.end(), EarlierFirst);
+
+    if (Cache && ((NNew > 0) || (NUsed != Cached.size())))
+    {
+	Save(Cache);
+    }
+    pLogger->LogTime("Index: %d files, %d new.\n", 
+		     (int) fEntry.size(), (int) NNew);
+    SET_DEBUG_STACK;
+    return fEntry.size();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : IndexFile
+ *
+ * Description : Read the Time column of one file, keep the first
+ *               and last time and the row at each Step. 
+ *
+ * Inputs : Name  - HDF5 file
+ *          Entry - filled in, fMTime and fSize already set
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : file can not be opened, no Time column or 
+ *                    no rows
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool H5Index::IndexFile(const string &Name, H5IndexEntry &Entry)
+{
+    SET_DEBUG_STACK;
+    CLogger  *pLogger = CLogger::GetThis();
+    H5Logger *h5 = new H5Logger(Name.c_str(), NULL, 0, true);
+    int       iTime;
+    double    t;
+    double    Next;
+
+    if (h5->CheckError())
+    {
+	pLogger->Log("# Index: failed to open %s\n", Name.c_str());
+	delete h5;
+	return false;
+    }
+    iTime = h5->IndexFromName("Time");
+    Entry.fName  = Name;
+    Entry.fDate  = h5->HeaderInfo(H5Logger::kDATE);
+    Entry.fNRows = h5->NEntries();
+    Entry.fOffset.clear();
+    if ((iTime < 0) || (Entry.fNRows == 0))
+    {
+	pLogger->Log("# Index: no Time data in %s\n", Name.c_str());
+	delete h5;
+	return false;
+    }
+
+    h5->DatasetReadRow(0);
+    Entry.fFirst = Entry.fLast = h5->RowData()[iTime];
+    Next = Entry.fFirst;
+    for (size_t i=0; i<Entry.fNRows; i++)
+    {
+	if (!h5->DatasetReadRow(i)) continue;
+	t = h5->RowData()[iTime];
+	while (Next <= t)
+	{
+	    Entry.fOffset.push_back((uint32_t) i);
+	    Next += fStep;
+	}
+	Entry.fLast = t;
+    }
+    delete h5;
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Overlap
+ *
+ * Description : Entries are sorted by start time and do not 
+ *               overlap, so the last times are sorted as well. 
+ *               Binary search for the first that ends at or after
+ *               Start and walk forward while they start before End.
+ *
+ * Inputs : Start, End - window, seconds
+ *          Entries    - filled with the entry indices
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void H5Index::Overlap(double Start, double End, vector<uint32_t> &Entries) const
+{
+    size_t lo = 0, hi = fEntry.size(), mid;
+
+    Entries.clear();
+    while (lo < hi)
+    {
+	mid = (lo + hi)/2;
+	if (fEntry[mid].fLast < Start) lo = mid + 1;
+	else hi = mid;
+    }
+    for (; (lo<fEntry.size()) && (fEntry[lo].fFirst < End); lo++)
+    {
+	Entries.push_back((uint32_t) lo);
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Rows
+ *
+ * Description : Coarse offsets bracket each end of the window to
+ *               one Step, a binary search on Time finds the row. 
+ *
+ * Inputs : Entry - index entry
+ *          h5    - open file for that entry
+ *          Start, End - window
+ *          First, Last - returned rows, [First, Last)
+ *
+ * Returns : true if there are rows in the window
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool H5Index::Rows(uint32_t Entry, H5Logger *h5, double Start, double End,
+		   size_t &First, size_t &Last) const
+{
+    const H5IndexEntry &E = fEntry[Entry];
+    const double Bound[2] = {Start, End};
+    size_t       Row[2];
+    int64_t      k;
+    size_t       lo, hi;
+    int          iTime = h5->IndexFromName("Time");
+
+    for (uint32_t j=0; j<2; j++)
+    {
+	k = (int64_t) floor((Bound[j] - E.fFirst)/fStep);
+	if (k < 0)
+	{
+	    Row[j] = 0;
+	    continue;
+	}
+	if ((size_t) k >= E.fOffset.size()) k = E.fOffset.size() - 1;
+	lo = E.fOffset[k];
+	hi = ((size_t)(k+1) < E.fOffset.size()) ? E.fOffset[k+1] : E.fNRows;
+	Row[j] = LowerBound(h5, iTime, lo, hi, Bound[j]);
+    }
+    First = Row[0];
+    Last  = Row[1];
+    return (First < Last);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : LowerBound
+ *
+ * Description : First row in [lo, hi) with Time >= t, hi if none. 
+ *
+ * Inputs : h5 - open file
+ *          iTime - Time column
+ *          lo, hi - rows to search
+ *          t - time
+ *
+ * Returns : row
+ *
+ * Error Conditions : a row that fails to read ends the search
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t H5Index::LowerBound(H5Logger *h5, int iTime, size_t lo, size_t hi,
+			   double t)
+{
+    size_t mid;
+    while (lo < hi)
+    {
+	mid = (lo + hi)/2;
+	if (!h5->DatasetReadRow(mid)) break;
+	if (h5->RowData()[iTime] < t) lo = mid + 1;
+	else hi = mid;
+    }
+    return lo;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ParseTime
+ *
+ * Description : Parse a date and time, UTC. The time part may be
+ *               left off. 
+ *
+ * Inputs : Date - "YYYY-MM-DD HH:MM:SS"
+ *
+ * Returns : seconds since 1970, -1 on error
+ *
+ * Error Conditions : bad format
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double H5Index::ParseTime(const char *Date)
+{
+    struct tm tm;
+    memset(&tm, 0, sizeof(tm));
+    if ((Date == NULL) || (strptime(Date, "%Y-%m-%d", &tm) == NULL))
+    {
+	return -1.0;
+    }
+    // Time of day is optional. 
+    strptime(Date, "%Y-%m-%d %H:%M:%S", &tm);
+    return (double) timegm(&tm);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Load
+ *
+ * Description : Read the cache. One file per line, tab separated:
+ *   name date mtime size nrows first last noffset offsets...
+ *
+ * Inputs : Cache - file name
+ *          Cached - filled in, by name
+ *
+ * Returns : true if the cache was read
+ *
+ * Error Conditions : missing cache or a different step
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool H5Index::Load(const char *Cache, map<string, H5IndexEntry> &Cached)
+{
+    ifstream     in(Cache);
+    string       Line, Field;
+    H5IndexEntry E;
+    double       Step = 0.0;
+    size_t       NOffset;
+    long         MTime;
+
+    Cached.clear();
+    if (in.fail()) return false;
+    if (!getline(in, Line) || 
+	(sscanf(Line.c_str(), "# H5Index step %lf", &Step) != 1) ||
+	(Step != fStep))
+    {
+	// Different step, all files get indexed again.
+	return false;
+    }
+    while (getline(in, Line))
+    {
+	istringstream s(Line);
+	getline(s, E.fName, '\t');
+	getline(s, E.fDate, '\t');
+	s >> MTime >> E.fSize >> E.fNRows >> E.fFirst >> E.fLast >> NOffset;
+	if (s.fail()) continue;
+	E.fMTime = (time_t) MTime;
+	E.fOffset.resize(NOffset);
+	for (size_t i=0; i<NOffset; i++) s >> E.fOffset[i];
+	if (!s.fail()) Cached[E.fName] = E;
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Save
+ *
+ * Description : Write the cache. 
+ *
+ * Inputs : Cache - file name
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : can not write
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool H5Index::Save(const char *Cache) const
+{
+    ofstream out(Cache);
+    if (out.fail())
+    {
+	CLogger::GetThis()->Log("# Index: can not write %s\n", Cache);
+	return false;
+    }
+    out.precision(17);
+    out << "# H5Index step " << fStep << endl;
+    for (size_t i=0; i<fEntry.size(); i++)
+    {
+	const H5IndexEntry &E = fEntry[i];
+	out << E.fName << '\t' << E.fDate << '\t' << (long) E.fMTime << ' ' 
+	    << E.fSize << ' ' << E.fNRows << ' ' << E.fFirst << ' ' 
+	    << E.fLast << ' ' << E.fOffset.size();
+	for (size_t j=0; j<E.fOffset.size(); j++) out << ' ' << E.fOffset[j];
+	out << endl;
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : H5Index.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Time index over the HDF5 archive. For each file 
+ * keep the header date, the first and last Time, the number of 
+ * rows and the row at coarse time steps from the start. A time 
+ * window then maps to the files that overlap it and a row range 
+ * in each, found by a binary search on Time between two coarse 
+ * offsets. Only the rows in the window are read afterwards.
+ *
+ * The index is built by reading the Time column of each file once 
+ * and is cached in a text file. A file is re-indexed if its size
+ * or modification time changed. The size and time can come from 
+ * the Manifest, which has them already, so nothing is stat'ed 
+ * twice. 
+ *
+ * Restrictions/Limitations : Time must increase within a file and
+ * files must not overlap in time. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Cache looked up by name, Build from known sizes. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __H5INDEX_hh_
+#define __H5INDEX_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <time.h>
+#  include <string>
+#  include <vector>
+#  include <map>
+
+class H5Logger;
+
+/// One HDF5 file in the index. 
+struct H5IndexEntry
+{
+    std::string fName;
+    std::string fDate;         // Header date
+    time_t      fMTime;        // For the stale check
+    int64_t     fSize;
+    size_t      fNRows;
+    double      fFirst;        // Time of the first row
+    double      fLast;         // Time of the last row
+    /// fOffset[k] is the first row with Time >= fFirst + k*Step
+    std::vector<uint32_t> fOffset;
+};
+
+class H5Index
+{
+public:
+    /*!
+     * Step - coarse offset step in seconds. 
+     */
+    H5Index(double Step=600.0);
+
+    /*!
+     * Description: 
+     *   Index the files, using the cache where it is still good. 
+     *   The entries end up sorted by start time. 
+     *
+     * Arguments:
+     *   Files - HDF5 files
+     *   Cache - cache file, read if it exists and rewritten if 
+     *           the files indexed changed
+     *
+     * Returns:
+     *   number of files indexed
+     */
+    size_t Build(const std::vector<std::string> &Files, const char *Cache);
+    /*!
+     * Description: 
+     *   As above with fName, fMTime and fSize of each file already
+     *   known, the files are not stat'ed. 
+     */
+    size_t Build(const std::vector<H5IndexEntry> &Files, const char *Cache);
+
+    /// Indices of the entries that overlap [Start, End). 
+    void Overlap(double Start, double End, 
+		 std::vector<uint32_t> &Entries) const;
+
+    /*!
+     * Description: 
+     *   Rows of an open file with Start <= Time < End. 
+     *
+     * Arguments:
+     *   Entry - index of the file entry
+     *   h5    - the file, open
+     *   Start, End - window
+     *   First, Last - rows [First, Last)
+     *
+     * Returns:
+     *   false if there are no rows in the window
+     */
+    bool Rows(uint32_t Entry, H5Logger *h5, double Start, double End,
+	      size_t &First, size_t &Last) const;
+
+    inline size_t Size(void) const {return fEntry.size();};
+    inline const H5IndexEntry& Entry(uint32_t i) const {return fEntry[i];};
+
+    /// "2024-05-10 16:00:00" as UTC seconds since 1970, -1 on error
+    static double ParseTime(const char *Date);
+
+private:
+    double fStep;
+    std::vector<H5IndexEntry> fEntry;
+
+    bool   IndexFile(const std::string &Name, H5IndexEntry &Entry);
+    bool   Load(const char *Cache, 
+		std::map<std::string, H5IndexEntry> &Cached);
+    bool   Save(const char *Cache) const;
+    static size_t LowerBound(H5Logger *h5, int iTime, size_t lo, size_t hi,
+			     double t);
+};
+#endif
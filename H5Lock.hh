@@ -0,0 +1,32 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : H5Lock.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : The HDF5 library here is not built thread safe. 
+ * Any thread other than the main one takes this lock around every
+ * H5Logger call, open and delete included. 
+ *
+ * Restrictions/Limitations : none
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __H5LOCK_hh_
+#define __H5LOCK_hh_
+#  include <mutex>
+
+/// One mutex for the whole program. 
+inline std::mutex& H5Mutex(void)
+{
+    static std::mutex Lock;
+    return Lock;
+}
+#endif
@@ -0,0 +1,678 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : KJoin.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Join local magnetometer and NOAA K by interval. 
+ *
+ * Restrictions/Limitations : none
+ *
+ * Change Descriptions : 
+ * 19-Oct-26 CBL IMUTuple read through the leaves, /F or /D. 
+ *
+ * Classification : Unclassified
+ *
+ * References : 
+ * https://www.swpc.noaa.gov/products/station-k-and-indices
+ *
+ *******************************************************************
+ */  
+// System includes.
+#include <iostream>
+using namespace std;
+
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <libconfig.h++>
+using namespace libconfig;
+
+/// Root includes
+#include <TROOT.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TLeaf.h>
+#include <TNtupleD.h>
+#include <TH2D.h>
+#include <TProfile.h>
+#include <TVectorD.h>
+
+/// Local Includes.
+#include "KJoin.hh"
+#include "CLogger.hh"
+#include "tools.h"
+#include "debug.h"
+
+KJoin* KJoin::fKJoin = NULL;
+
+/**
+ * K index lower limits for a K9 = 500nT station, scaled by K9/500 
+ * for other stations. 
+ */
+static const double kKLimit[10] = {0.0, 5.0, 10.0, 20.0, 40.0, 70.0, 
+				   120.0, 200.0, 330.0, 500.0};
+
+/**
+ * Coalesce a sorted bin list so that each interval shows up once. 
+ * Only needed if the input was out of order. 
+ */
+template <class T, class F> static void Coalesce(vector<T> &v, F Merge)
+{
+    size_t j = 0;
+    if (v.empty()) return;
+    for (size_t i=1; i<v.size(); i++)
+    {
+	if (v[i].fIndex == v[j].fIndex)
+	{
+	    Merge(v[j], v[i]);
+	}
+	else
+	{
+	    v[++j] = v[i];
+	}
+    }
+    v.resize(j+1);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : KJoin constructor
+ *
+ * Description : initialize CObject variables
+ *
+ * Inputs : ConfigFile - configuration file name
+ *
+ * Returns : none
+ *
+ * Error Conditions : ENO_FILE, ECONFIG_READ_FAIL
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+KJoin::KJoin(const char* ConfigFile) : CObject()
+{
+    CLogger *Logger = CLogger::GetThis();
+
+    /* Store the this pointer. */
+    fKJoin = this;
+    SetName("KJoin");
+    SetError(); // No error.
+
+    fRun            = true;
+    fIMUFileName    = "IMU.root";
+    fNOAAFileName   = "Sunspots.root";
+    fOutputFileName = "KJoin.root";
+    fStation        = "Fredericksburg";
+    fK9             = 500.0;      // Fredericksburg
+    fScale          = 1000.0;     // uT to nT
+
+    if(!ConfigFile)
+    {
+	SetError(ENO_FILE,__LINE__);
+	return;
+    }
+
+    fConfigFileName = strdup(ConfigFile);
+    if(!ReadConfiguration())
+    {
+	SetError(ECONFIG_READ_FAIL,__LINE__);
+	return;
+    }
+    Logger->Log("# KJoin constructed.\n");
+
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : KJoin Destructor
+ *
+ * Description : write configuration
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+KJoin::~KJoin(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+
+    if(!WriteConfiguration())
+    {
+	SetError(ECONFIG_WRITE_FAIL,__LINE__);
+	Logger->LogError(__FILE__,__LINE__, 'W', 
+			 "Failed to write config file.\n");
+    }
+    free(fConfigFileName);
+
+    Logger->Log("# KJoin closed.\n");
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Do
+ *
+ * Description : Reduce both sides to sorted interval lists and
+ *               join them. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : EINPUT_FAIL if either input can't be read. 
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void KJoin::Do(void)
+{
+    SET_DEBUG_STACK;
+    /*
+     * Initialize Root package.
+     * We don't really need to track the return pointer. 
+     * We just need to initialize it. 
+     */
+    ::new TROOT("KJoin","Local and NOAA K join");
+
+    if (!ReadLocal() || !fRun || !ReadNOAA() || !fRun)
+    {
+	SetError(EINPUT_FAIL, __LINE__);
+	return;
+    }
+    Join();
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadLocal
+ *
+ * Description : One pass over IMUTuple, min/max of each component
+ *               and sum of |M| per 3 hour interval. Rows are 
+ *               normally in time order so an interval is done when
+ *               the next one starts. If the input list was not in 
+ *               time order the bins are sorted and merged after. 
+ *               The columns are read through their leaves, so a 
+ *               tuple written with FLOAT32 reads the same. 
+ *
+ * Inputs : none
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : missing file, tree or column
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool KJoin::ReadLocal(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    const char *Name[4] = {"Time", "MX", "MY", "MZ"};
+    TLeaf   *Leaf[4];
+    Double_t Time, M[3];
+    LocalBin Bin;
+    int64_t  Index;
+
+    TFile *f = TFile::Open(fIMUFileName.c_str());
+    if ((f == NULL) || f->IsZombie())
+    {
+	pLogger->Log("# Failed to open %s\n", fIMUFileName.c_str());
+	return false;
+    }
+    TTree *t = (TTree *) f->Get("IMUTuple");
+    if (t == NULL)
+    {
+	pLogger->Log("# No IMUTuple in %s\n", fIMUFileName.c_str());
+	delete f;
+	return false;
+    }
+    // Only read what we use. 
+    t->SetBranchStatus("*", 0);
+    for (int j=0;j<4;j++)
+    {
+	t->SetBranchStatus(Name[j], 1);
+	Leaf[j] = t->GetLeaf(Name[j]);
+	if (Leaf[j] == NULL)
+	{
+	    pLogger->Log("# No %s in IMUTuple.\n", Name[j]);
+	    delete f;
+	    return false;
+	}
+    }
+
+    Long64_t N = t->GetEntries();
+    Bin.fIndex = -1;
+    fLocal.clear();
+    for (Long64_t i=0; (i<N) && fRun; i++)
+    {
+	t->GetEntry(i);
+	Time = Leaf[0]->GetValue();
+	for (int j=0;j<3;j++) M[j] = Leaf[j+1]->GetValue();
+	Index = (int64_t) floor(Time/kInterval);
+	if (Index != Bin.fIndex)
+	{
+	    if (Bin.fIndex >= 0) fLocal.push_back(Bin);
+	    Bin.fIndex = Index;
+	    Bin.fN     = 0;
+	    Bin.fSum   = 0.0;
+	    for (int j=0;j<3;j++)
+	    {
+		Bin.fMin[j] =  HUGE_VAL;
+		Bin.fMax[j] = -HUGE_VAL;
+	    }
+	}
+	for (int j=0;j<3;j++)
+	{
+	    Bin.fMin[j] = min(Bin.fMin[j], M[j]);
+	    Bin.fMax[j] = max(Bin.fMax[j], M[j]);
+	}
+	Bin.fSum += sqrt(M[0]*M[0] + M[1]*M[1] + M[2]*M[2]);
+	Bin.fN++;
+    }
+    if (Bin.fIndex >= 0) fLocal.push_back(Bin);
+    delete f;
+
+    if (!is_sorted(fLocal.begin(), fLocal.end()))
+    {
+	pLogger->Log("# IMUTuple not in time order, sorting intervals.\n");
+	stable_sort(fLocal.begin(), fLocal.end());
+	Coalesce(fLocal, [](LocalBin &a, const LocalBin &b) {
+		for (int j=0;j<3;j++)
+		{
+		    a.fMin[j] = min(a.fMin[j], b.fMin[j]);
+		    a.fMax[j] = max(a.fMax[j], b.fMax[j]);
+		}
+		a.fSum += b.fSum;
+		a.fN   += b.fN;
+	    });
+    }
+    pLogger->LogTime("Local: %ld rows, %ld intervals.\n", 
+		     (long) N, (long) fLocal.size());
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadNOAA
+ *
+ * Description : Expand the NOAAday entries for the station into
+ *               one bin per 3 hour interval. 
+ *
+ * Inputs : none
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : missing file or NOAAday tree
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool KJoin::ReadNOAA(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    Char_t   Station[32];
+    UInt_t   Epoch;
+    UChar_t  K[8];
+    NOAABin  Bin;
+
+    TFile *f = TFile::Open(fNOAAFileName.c_str());
+    if ((f == NULL) || f->IsZombie())
+    {
+	pLogger->Log("# Failed to open %s\n", fNOAAFileName.c_str());
+	return false;
+    }
+    TTree *t = (TTree *) f->Get("NOAAday");
+    if (t == NULL)
+    {
+	pLogger->Log("# No NOAAday in %s, rerun ReadAK with Compact.\n", 
+		     fNOAAFileName.c_str());
+	delete f;
+	return false;
+    }
+    t->SetBranchStatus("*", 0);
+    t->SetBranchStatus("STATION", 1);
+    t->SetBranchStatus("EPOCH", 1);
+    t->SetBranchStatus("K", 1);
+    t->SetBranchAddress("STATION", Station);
+    t->SetBranchAddress("EPOCH", &Epoch);
+    t->SetBranchAddress("K", K);
+
+    fNOAA.clear();
+    for (Long64_t i=0; (i<t->GetEntries()) && fRun; i++)
+    {
+	t->GetEntry(i);
+	if (strncmp(Station, fStation.c_str(), fStation.size()) != 0) 
+	    continue;
+	for (uint32_t j=0; j<8; j++)
+	{
+	    if (K[j] > 9) continue;     // missing
+	    Bin.fIndex = Epoch/kInterval + j;
+	    Bin.fK     = K[j];
+	    fNOAA.push_back(Bin);
+	}
+    }
+    delete f;
+
+    if (!is_sorted(fNOAA.begin(), fNOAA.end()))
+    {
+	stable_sort(fNOAA.begin(), fNOAA.end());
+	// Same interval twice, keep the later one. 
+	Coalesce(fNOAA, [](NOAABin &a, const NOAABin &b) {a.fK = b.fK;});
+    }
+    pLogger->LogTime("NOAA: %s, %ld intervals.\n", fStation.c_str(), 
+		     (long) fNOAA.size());
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : LocalK
+ *
+ * Description : K from a range in nT using the station K9 limit. 
+ *
+ * Inputs : RangenT - maximum horizontal range in the interval
+ *
+ * Returns : K 0-9
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double KJoin::LocalK(double RangenT) const
+{
+    const double Scale = fK9/500.0;
+    int K = 0;
+    while ((K<9) && (RangenT >= kKLimit[K+1]*Scale)) K++;
+    return (double) K;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Join
+ *
+ * Description : Merge join of the two sorted interval lists. 
+ *               Matched intervals go into the KJoin ntuple and 
+ *               the running sums for correlation and a least 
+ *               squares fit of NOAA K against the local range. 
+ *
+ *               The local K uses the larger of the X and Y ranges, 
+ *               K is defined on the horizontal components. No quiet
+ *               day curve is removed. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void KJoin::Join(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    const char *Names = "EPOCH:KNOAA:KLOCAL:XRANGE:YRANGE:ZRANGE:HRANGE:MAG:N";
+    Double_t var[9];
+    size_t   i = 0, j = 0;
+    double   N = 0.0, Sx = 0.0, Sy = 0.0, Sxx = 0.0, Syy = 0.0, Sxy = 0.0;
+    double   Sk = 0.0, Skk = 0.0, Sky = 0.0, Agree = 0.0;
+    double   x, y, k;
+
+    TFile *f = new TFile(fOutputFileName.c_str(), "RECREATE", 
+			 "Local and NOAA K join");
+    f->cd();
+    TNtupleD *nt   = new TNtupleD("KJoin", "Local and NOAA K", Names);
+    TH2D     *hk   = new TH2D("KCORR", "Local K vs NOAA K", 
+			      10, -0.5, 9.5, 10, -0.5, 9.5);
+    TProfile *prof = new TProfile("HRANGEK", "Local H range (nT) vs NOAA K", 
+				  10, -0.5, 9.5);
+    hk->SetXTitle("NOAA K");
+    hk->SetYTitle("Local K");
+
+    while ((i < fLocal.size()) && (j < fNOAA.size()))
+    {
+	if (fLocal[i].fIndex < fNOAA[j].fIndex)
+	{
+	    i++;
+	}
+	else if (fNOAA[j].fIndex < fLocal[i].fIndex)
+	{
+	    j++;
+	}
+	else
+	{
+	    const LocalBin &L = fLocal[i];
+	    var[0] = (double) L.fIndex * kInterval;
+	    var[1] = fNOAA[j].fK;
+	    var[3] = (L.fMax[0] - L.fMin[0]) * fScale;
+	    var[4] = (L.fMax[1] - L.fMin[1]) * fScale;
+	    var[5] = (L.fMax[2] - L.fMin[2]) * fScale;
+	    var[6] = max(var[3], var[4]);
+	    var[2] = LocalK(var[6]);
+	    var[7] = L.fSum/L.fN;
+	    var[8] = L.fN;
+	    nt->Fill(var);
+	    hk->Fill(var[1], var[2]);
+	    prof->Fill(var[1], var[6]);
+
+	    // x is the local range, y NOAA K, k local K
+	    x = var[6]; y = var[1]; k = var[2];
+	    N   += 1.0;
+	    Sx  += x;   Sy  += y;   Sk  += k;
+	    Sxx += x*x; Syy += y*y; Skk += k*k;
+	    Sxy += x*y; Sky += k*y;
+	    if (fabs(k-y) <= 1.0) Agree += 1.0;
+	    i++; j++;
+	}
+    }
+
+    /*
+     * Summary. 
+     * 0 number of matched intervals
+     * 1 correlation local K, NOAA K
+     * 2 correlation local range, NOAA K
+     * 3 slope     NOAA K = a + b * range
+     * 4 intercept 
+     * 5 fraction with |local K - NOAA K| <= 1
+     */
+    TVectorD Summary(6);
+    Summary[0] = N;
+    if (N > 1.0)
+    {
+	double vx = Sxx - Sx*Sx/N;
+	double vy = Syy - Sy*Sy/N;
+	double vk = Skk - Sk*Sk/N;
+	double cxy = Sxy - Sx*Sy/N;
+	double cky = Sky - Sk*Sy/N;
+	Summary[1] = ((vk>0.0) && (vy>0.0)) ? cky/sqrt(vk*vy) : 0.0;
+	Summary[2] = ((vx>0.0) && (vy>0.0)) ? cxy/sqrt(vx*vy) : 0.0;
+	Summary[3] = (vx>0.0) ? cxy/vx : 0.0;
+	Summary[4] = (Sy - Summary[3]*Sx)/N;
+	Summary[5] = Agree/N;
+    }
+    Summary.Write("KJoinSummary");
+    pLogger->LogTime("Joined %d intervals, r(K) %f, r(range) %f, "
+		     "K = %f + %f * range, agree %f\n", (int) N, 
+		     Summary[1], Summary[2], Summary[4], Summary[3], 
+		     Summary[5]);
+
+    f->Write();
+    f->Close();
+    delete f;
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadConfiguration
+ *
+ * Description : Open read the configuration file. 
+ *
+ * Inputs : none
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on:  
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool KJoin::ReadConfiguration(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    ClearError(__LINE__);
+    Config *pCFG = new Config();
+
+    /*
+     * Open the configuragtion file. 
+     */
+    try{
+	pCFG->readFile(fConfigFileName);
+    }
+    catch( const FileIOException &fioex)
+    {
+	Logger->LogError(__FILE__,__LINE__,'F',
+			 "I/O error while reading configuration file.\n");
+	return false;
+    }
+    catch (const ParseException &pex)
+    {
+	Logger->Log("# Parse error at: %s : %d - %s\n",
+		    pex.getFile(), pex.getLine(), pex.getError());
+	return false;
+    }
+
+    const Setting& root = pCFG->getRoot();
+    try
+    {
+	int    Debug;
+	const Setting &MM = root["KJoin"];
+	MM.lookupValue("Debug"     , Debug);
+	MM.lookupValue("IMUFile"   , fIMUFileName);
+	MM.lookupValue("NOAAFile"  , fNOAAFileName);
+	MM.lookupValue("OutputFile", fOutputFileName);
+	MM.lookupValue("Station"   , fStation);
+	MM.lookupValue("K9"        , fK9);
+	MM.lookupValue("Scale"     , fScale);
+	SetDebug(Debug);
+    }
+    catch(const SettingNotFoundException &nfex)
+    {
+	// Ignore.
+    }
+    delete pCFG;
+    pCFG = 0;
+
+    Logger->Log("# Join %s with %s station %s, K9 %f nT\n", 
+		fIMUFileName.c_str(), fNOAAFileName.c_str(), 
+		fStation.c_str(), fK9);
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteConfigurationFile
+ *
+ * Description : Write out final configuration
+ *
+ * Inputs : none
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on:  
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool KJoin::WriteConfiguration(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    ClearError(__LINE__);
+    Config *pCFG = new Config();
+
+    Setting &root = pCFG->getRoot();
+
+    Setting &MM = root.add("KJoin", Setting::TypeGroup);
+    MM.add("Debug"     , Setting::TypeInt)    = 0;
+    MM.add("IMUFile"   , Setting::TypeString) = fIMUFileName;
+    MM.add("NOAAFile"  , Setting::TypeString) = fNOAAFileName;
+    MM.add("OutputFile", Setting::TypeString) = fOutputFileName;
+    MM.add("Station"   , Setting::TypeString) = fStation;
+    MM.add("K9"        , Setting::TypeFloat)  = fK9;
+    MM.add("Scale"     , Setting::TypeFloat)  = fScale;
+
+    // Write out the new configuration.
+    try
+    {
+	pCFG->writeFile(fConfigFileName);
+	Logger->Log("# New configuration successfully written to: %s\n",
+		    fConfigFileName);
+
+    }
+    catch(const FileIOException &fioex)
+    {
+	Logger->Log("# I/O error while writing file: %s \n",
+		    fConfigFileName);
+	delete pCFG;
+	return(false);
+    }
+    delete pCFG;
+
+    SET_DEBUG_STACK;
+    return true;
+}
@@ -0,0 +1,118 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : KJoin.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Join the local magnetometer data (IMU.root from 
+ * Analysis) with the NOAA K indices (Sunspots.root from ReadAK) 
+ * on 3 hour UTC intervals. Each side is reduced to one bin per 
+ * interval in a single pass and the two sorted bin lists are 
+ * merge joined. Output is a combined ntuple and correlation and
+ * regression summaries. 
+ *
+ * Restrictions/Limitations : Sunspots.root needs the NOAAday tree.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ * https://www.swpc.noaa.gov/products/station-k-and-indices
+ *
+ *******************************************************************
+ */
+#ifndef __KJOIN_hh_
+#define __KJOIN_hh_
+#  include <stdint.h>
+#  include <vector>
+#  include "CObject.hh" // Base class with all kinds of intermediate
+
+class KJoin : public CObject
+{
+public:
+    /** 
+     * Build on CObject error codes. 
+     */
+    enum {ENO_FILE=1, ECONFIG_READ_FAIL, ECONFIG_WRITE_FAIL, EINPUT_FAIL};
+    /**
+     * Constructor, all inputs are in the configuration file. 
+     */
+    KJoin(const char *ConfigFile);
+
+    /**
+     * Destructor for KJoin
+     */
+    ~KJoin(void);
+
+    /*! Access the This pointer. */
+    static KJoin* GetThis(void) {return fKJoin;};
+
+    /**
+     * Main Module DO
+     * 
+     */
+    void Do(void);
+
+    /**
+     * Tell the program to stop. 
+     */
+    void Stop(void) {fRun=false;};
+
+private:
+    /// 3 hours, the K index interval. 
+    static const uint32_t kInterval = 10800;
+
+    /// Local magnetometer reduced to one interval. 
+    struct LocalBin {
+	int64_t  fIndex;        // epoch/kInterval
+	uint32_t fN;
+	double   fMin[3];       // X, Y, Z
+	double   fMax[3];
+	double   fSum;          // sum of |M|
+	bool operator<(const LocalBin &b) const {return fIndex<b.fIndex;};
+    };
+    /// One NOAA interval
+    struct NOAABin {
+	int64_t  fIndex;
+	uint8_t  fK;
+	bool operator<(const NOAABin &b) const {return fIndex<b.fIndex;};
+    };
+
+    bool     fRun;
+    string   fIMUFileName;
+    string   fNOAAFileName;
+    string   fOutputFileName;
+    string   fStation;
+    double   fK9;          // K9 lower limit for the station in nT
+    double   fScale;       // local units to nT
+
+    std::vector<LocalBin> fLocal;
+    std::vector<NOAABin>  fNOAA;
+
+    /*! 
+     * Configuration file name. 
+     */
+    char     *fConfigFileName;
+
+    /* Private functions. ==============================  */
+
+    bool   ReadLocal(void);
+    bool   ReadNOAA(void);
+    void   Join(void);
+    double LocalK(double RangenT) const;
+
+    /*!
+     * Read the configuration file. 
+     */
+    bool ReadConfiguration(void);
+    /*!
+     * Write the configuration file. 
+     */
+    bool WriteConfiguration(void);
+
+    /*! The static 'this' pointer. */
+    static KJoin *fKJoin;
+};
+#endif
@@ -0,0 +1,538 @@
+/********************************************************************
+ *
+ * Module Name : Manifest.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : List of HDF5 input files for planning a run. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Directory loops, cache saved on any change. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <sys/stat.h>
+#include <dirent.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "H5Logger.hh"
+#include "Manifest.hh"
+#include "H5Lock.hh"
+
+/// Chronological, name breaks ties. 
+static bool Earlier(const ManifestEntry &a, const ManifestEntry &b)
+{
+    if (a.fEpoch != b.fEpoch) return a.fEpoch < b.fEpoch;
+    return a.fName < b.fName;
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Manifest constructor
+ *
+ * Description : 
+ *
+ * Inputs : Cache   - cached manifest, may be NULL
+ *          Threads - worker threads
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Manifest::Manifest(const char *Cache, uint32_t Threads)
+{
+    if (Cache) fCache = Cache;
+    fThreads = (Threads > 0) ? Threads : 1;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : AddDirectories
+ *
+ * Description : One worker per directory tree, up to fThreads at a
+ *               time. 
+ *
+ * Inputs : Dirs   - top level data directories
+ *          Suffix - file name ending to take
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Manifest::AddDirectories(const vector<string> &Dirs, const char *Suffix)
+{
+    SET_DEBUG_STACK;
+    vector< vector<string> > Found(Dirs.size());
+    std::atomic<size_t> Next(0);
+    vector<std::thread> Workers;
+
+    for (uint32_t t=0; (t<fThreads) && (t<Dirs.size()); t++)
+    {
+	Workers.push_back(std::thread([&]()
+	{
+	    size_t i;
+	    while ((i = Next++) < Dirs.size())
+	    {
+		DirSet Seen;
+		ScanDirectory(Dirs[i], Suffix, Found[i], Seen);
+	    }
+	}));
+    }
+    for (size_t t=0; t<Workers.size(); t++) Workers[t].join();
+
+    for (size_t i=0; i<Found.size(); i++)
+    {
+	fFiles.insert(fFiles.end(), Found[i].begin(), Found[i].end());
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ScanDirectory
+ *
+ * Description : Recursive directory walk. Symbolic links to 
+ *               directories are followed, archives are often put 
+ *               together that way, but a directory already seen 
+ *               in this tree, by device and inode, is not walked 
+ *               again. A link back up the tree is then harmless. 
+ *
+ * Inputs : Dir    - directory
+ *          Suffix - file name ending to take
+ *          Found  - files added to
+ *          Seen   - directories walked, added to
+ *
+ * Returns : none
+ *
+ * Error Conditions : unreadable directories are logged and skipped,
+ *                    loops are logged and skipped
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Manifest::ScanDirectory(const string &Dir, const char *Suffix, 
+			     vector<string> &Found, DirSet &Seen)
+{
+    DIR           *d;
+    struct dirent *e;
+    struct stat    st;
+    string         Path;
+    size_t         ls = strlen(Suffix);
+    size_t         ln;
+
+    if ((stat(Dir.c_str(), &st) == 0) && 
+	!Seen.insert(make_pair(st.st_dev, st.st_ino)).second)
+    {
+	CLogger::GetThis()->Log("# Manifest: %s seen already, loop.\n", 
+				Dir.c_str());
+	return;
+    }
+    d = opendir(Dir.c_str());
+    if (d == NULL)
+    {
+	CLogger::GetThis()->Log("# Manifest: can not read %s\n", Dir.c_str());
+	return;
+    }
+    while ((e = readdir(d)) != NULL)
+    {
+	if (e->d_name[0] == '.') continue;
+	Path = Dir + "/" + e->d_name;
+	if (stat(Path.c_str(), &st) != 0) continue;
+	if (S_ISDIR(st.st_mode))
+	{
+	    ScanDirectory(Path, Suffix, Found, Seen);
+	}
+	else
+	{
+	    ln = strlen(e->d_name);
+	    if ((ln >= ls) && (strcmp(e->d_name + ln - ls, Suffix) == 0))
+	    {
+		Found.push_back(Path);
+	    }
+	}
+    }
+    closedir(d);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : AddList
+ *
+ * Description : The old FileList.txt, one name per line, no limit
+ *               on the length of a name. 
+ *
+ * Inputs : List - file name
+ *
+ * Returns : true if the list was read
+ *
+ * Error Conditions : list can not be opened
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Manifest::AddList(const char *List)
+{
+    ifstream in(List);
+    string   Line;
+    if (in.fail()) return false;
+    while (getline(in, Line))
+    {
+	if (Line.length() > 0) fFiles.push_back(Line);
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Build
+ *
+ * Description : The stat calls run on fThreads workers. A file 
+ *               whose size and time match the cache is taken from 
+ *               it, otherwise the header is read, one file at a 
+ *               time. Duplicate names are dropped. The cache is 
+ *               saved if a header was read or a cached file is gone
+ *               or changed, so removed files drop out of it. 
+ *
+ * Inputs : none
+ *
+ * Returns : number of good files
+ *
+ * Error Conditions : files that can not be stat'ed or opened are 
+ *                    logged and left out
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t Manifest::Build(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    vector<ManifestEntry> Cached;
+    map<string, size_t>   ByName;
+    std::atomic<size_t>   Next(0);
+    std::atomic<size_t>   NRead(0);
+    std::atomic<size_t>   NUsed(0);        // Cached entries still good
+    vector<std::thread>   Workers;
+
+    sort(fFiles.begin(), fFiles.end());
+    fFiles.erase(unique(fFiles.begin(), fFiles.end()), fFiles.end());
+
+    Load(Cached);
+    for (size_t i=0; i<Cached.size(); i++) ByName[Cached[i].fName] = i;
+
+    vector<ManifestEntry> Entry(fFiles.size());
+    vector<char>          Good(fFiles.size(), 0);
+
+    for (uint32_t t=0; (t<fThreads) && (t<fFiles.size()); t++)
+    {
+	Workers.push_back(std::thread([&]()
+	{
+	    struct stat st;
+	    size_t i;
+	    map<string, size_t>::const_iterator it;
+	    while ((i = Next++) < fFiles.size())
+	    {
+		if (stat(fFiles[i].c_str(), &st) != 0) continue;
+		it = ByName.find(fFiles[i]);
+		if ((it != ByName.end()) && 
+		    (Cached[it->second].fSize  == (int64_t) st.st_size) &&
+		    (Cached[it->second].fMTime == st.st_mtime))
+		{
+		    Entry[i] = Cached[it->second];
+		    Good[i]  = 1;
+		    NUsed++;
+		    continue;
+		}
+		Entry[i].fName  = fFiles[i];
+		Entry[i].fSize  = st.st_size;
+		Entry[i].fMTime = st.st_mtime;
+		Good[i] = ReadHeader(Entry[i]) ? 1 : 0;
+		NRead++;
+	    }
+	}));
+    }
+    for (size_t t=0; t<Workers.size(); t++) Workers[t].join();
+
+    fEntry.clear();
+    for (size_t i=0; i<Entry.size(); i++)
+    {
+	if (Good[i]) fEntry.push_back(Entry[i]);
+	else pLogger->Log("# Manifest: skip %s\n", fFiles[i].c_str());
+    }
+    fFiles.clear();
+    sort(fEntry.begin(), fEntry.end(), Earlier);
+
+    // A file read, or one in the cache gone or changed. 
+    if ((NRead > 0) || (NUsed != Cached.size())) Save();
+    pLogger->LogTime("Manifest: %d files, %d headers read, %ld rows.\n", 
+		     (int) fEntry.size(), (int) NRead.load(), 
+		     (long) TotalRows());
+    SET_DEBUG_STACK;
+    return fEntry.size();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadHeader
+ *
+ * Description : Open the file, get the date and number of rows. 
+ *
+ * Inputs : Entry - fName set, the rest filled in
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : file can not be opened or has no date
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Manifest::ReadHeader(ManifestEntry &Entry)
+{
+    std::lock_guard<std::mutex> Lock(H5Mutex());
+    H5Logger   *h5 = new H5Logger(Entry.fName.c_str(), NULL, 0, true);
+    const char *Date;
+    struct tm  *tm;
+    struct tm   t;
+    bool        rc = false;
+
+    if (!h5->CheckError())
+    {
+	Date = h5->HeaderInfo(H5Logger::kDATE);
+	tm   = (Date != NULL) ? h5->H5ParseTime(Date) : NULL;
+	if (tm)
+	{
+	    t = *tm;
+	    Entry.fDate  = Date;
+	    Entry.fYear  = t.tm_year + 1900;
+	    Entry.fDay   = t.tm_yday;
+	    Entry.fEpoch = timegm(&t);
+	    Entry.fNRows = h5->NEntries();
+	    rc = true;
+	}
+    }
+    delete h5;
+    return rc;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : LargestFirst
+ *
+ * Description : Order to schedule the work, most rows first. 
+ *
+ * Inputs : none
+ *
+ * Returns : entry indices
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+vector<uint32_t> Manifest::LargestFirst(void) const
+{
+    vector<uint32_t> rv(fEntry.size());
+    for (size_t i=0; i<rv.size(); i++) rv[i] = i;
+    stable_sort(rv.begin(), rv.end(), [this](uint32_t a, uint32_t b)
+		{return fEntry[a].fNRows > fEntry[b].fNRows;});
+    return rv;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : DayRange
+ *
+ * Description : Day in year limits, to size the histograms. 
+ *
+ * Inputs : First, Last - returned
+ *
+ * Returns : false if the manifest is empty
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Manifest::DayRange(int32_t &First, int32_t &Last) const
+{
+    if (fEntry.empty()) return false;
+    First = Last = fEntry[0].fDay;
+    for (size_t i=1; i<fEntry.size(); i++)
+    {
+	if (fEntry[i].fDay < First) First = fEntry[i].fDay;
+	if (fEntry[i].fDay > Last)  Last  = fEntry[i].fDay;
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : TotalRows
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : sum of rows over all files
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t Manifest::TotalRows(void) const
+{
+    size_t n = 0;
+    for (size_t i=0; i<fEntry.size(); i++) n += fEntry[i].fNRows;
+    return n;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Load
+ *
+ * Description : Read the cache. One file per line, tab separated:
+ *   name size mtime date epoch year day nrows
+ *
+ * Inputs : Cached - filled in
+ *
+ * Returns : true if there was a cache
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Manifest::Load(vector<ManifestEntry> &Cached)
+{
+    ifstream      in(fCache.c_str());
+    string        Line, Field[8];
+    ManifestEntry E;
+
+    Cached.clear();
+    if (fCache.empty() || in.fail()) return false;
+    while (getline(in, Line))
+    {
+	if ((Line.length() == 0) || (Line[0] == '#')) continue;
+	istringstream s(Line);
+	int n = 0;
+	while ((n < 8) && getline(s, Field[n], '\t')) n++;
+	if (n != 8) continue;
+	E.fName  = Field[0];
+	E.fSize  = strtoll(Field[1].c_str(), NULL, 10);
+	E.fMTime = (time_t) strtoll(Field[2].c_str(), NULL, 10);
+	E.fDate  = Field[3];
+	E.fEpoch = (time_t) strtoll(Field[4].c_str(), NULL, 10);
+	E.fYear  = atoi(Field[5].c_str());
+	E.fDay   = atoi(Field[6].c_str());
+	E.fNRows = strtoull(Field[7].c_str(), NULL, 10);
+	Cached.push_back(E);
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Save
+ *
+ * Description : Write the cache, in date order. 
+ *
+ * Inputs : none
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : can not write
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Manifest::Save(void) const
+{
+    if (fCache.empty()) return false;
+    ofstream out(fCache.c_str());
+    if (out.fail())
+    {
+	CLogger::GetThis()->Log("# Manifest: can not write %s\n", 
+				fCache.c_str());
+	return false;
+    }
+    out << "# name\tsize\tmtime\tdate\tepoch\tyear\tday\trows" << endl;
+    for (size_t i=0; i<fEntry.size(); i++)
+    {
+	const ManifestEntry &E = fEntry[i];
+	out << E.fName << '\t' << E.fSize << '\t' << (long) E.fMTime << '\t'
+	    << E.fDate << '\t' << (long) E.fEpoch << '\t' << E.fYear << '\t'
+	    << E.fDay << '\t' << E.fNRows << endl;
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Manifest.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : List of HDF5 input files with what is needed to 
+ * plan a run: size, modification time, header date and number of
+ * rows. Built from data directories, scanned in parallel, or from
+ * a file list. Each file is stat'ed and, if it is not already in
+ * the cached manifest with the same size and time, opened once to
+ * read the header. The result is sorted by date and written back 
+ * to the cache, so a restart on an unchanged archive opens 
+ * nothing. 
+ *
+ * Restrictions/Limitations : The HDF5 library is not built thread
+ * safe, header reads are serialized. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Directories seen kept by device and inode, so a 
+ *               symbolic link loop is walked once. Cache saved when
+ *               the set of files changed. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __MANIFEST_hh_
+#define __MANIFEST_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <time.h>
+#  include <string>
+#  include <vector>
+#  include <set>
+#  include <utility>
+#  include <sys/types.h>
+
+/// One input file. 
+struct ManifestEntry
+{
+    std::string fName;
+    int64_t     fSize;
+    time_t      fMTime;
+    std::string fDate;      // Header date, "2024-02-12 02:43:44"
+    time_t      fEpoch;     // Header date as seconds since 1970
+    int32_t     fYear;      // e.g. 2024
+    int32_t     fDay;       // Day in year, 0-365 like tm_yday
+    size_t      fNRows;
+};
+
+class Manifest
+{
+public:
+    /*!
+     * Cache   - cached manifest file, may be NULL
+     * Threads - worker threads for the scan
+     */
+    Manifest(const char *Cache, uint32_t Threads=4);
+
+    /// Add the *Suffix files under each directory, recursively. 
+    void   AddDirectories(const std::vector<std::string> &Dirs, 
+			  const char *Suffix=".h5");
+    /// Add the files named one per line in List. 
+    bool   AddList(const char *List);
+
+    /*!
+     * Description: 
+     *   Stat and read the headers of the files added, using the 
+     *   cache where possible. Sort by date and save the cache. 
+     *
+     * Returns:
+     *   number of good files
+     */
+    size_t Build(void);
+
+    inline size_t Size(void) const {return fEntry.size();};
+    inline const ManifestEntry& Entry(size_t i) const {return fEntry[i];};
+
+    /// Entry indices, most rows first. 
+    std::vector<uint32_t> LargestFirst(void) const;
+    /// Smallest and largest day in year, false if empty. 
+    bool   DayRange(int32_t &First, int32_t &Last) const;
+    /// Sum of the rows in all files. 
+    size_t TotalRows(void) const;
+
+private:
+    std::string fCache;
+    uint32_t    fThreads;
+    std::vector<std::string>   fFiles;   // Added, not yet built
+    std::vector<ManifestEntry> fEntry;   // Built, sorted
+
+    /// Device and inode of a directory. 
+    typedef std::set< std::pair<dev_t, ino_t> > DirSet;
+    void   ScanDirectory(const std::string &Dir, const char *Suffix, 
+			 std::vector<std::string> &Found, DirSet &Seen);
+    bool   ReadHeader(ManifestEntry &Entry);
+    bool   Load(std::vector<ManifestEntry> &Cached);
+    bool   Save(void) const;
+};
+#endif
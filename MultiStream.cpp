@@ -0,0 +1,358 @@
+/********************************************************************
+ *
+ * Module Name : MultiStream.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Time ordered merge of several sites. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cmath>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "H5Logger.hh"
+#include "MultiStream.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SiteStream constructor
+ *
+ * Description : Nothing is opened until the first Next. 
+ *
+ * Inputs : Name  - site label
+ *          Files - in time order
+ *          Rows  - rows per read
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SiteStream::SiteStream(const char *Name, const vector<string> &Files, 
+		       size_t Rows)
+{
+    fName    = Name;
+    fFiles   = Files;
+    fFile    = 0;
+    fH5      = NULL;
+    fRow     = fNRows = 0;
+    fBuf.resize((Rows > 0) ? Rows : 1);
+    fPos     = fN = 0;
+    fLast    = -1.0e300;
+    fDropped = 0;
+    for (uint32_t i=0; i<4; i++) fCols[i] = 0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : SiteStream destructor
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SiteStream::~SiteStream(void)
+{
+    delete fH5;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Open
+ *
+ * Description : Open the next file that can be opened. 
+ *
+ * Inputs : none
+ *
+ * Returns : false when there are no more files
+ *
+ * Error Conditions : files that fail to open are logged and skipped
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SiteStream::Open(void)
+{
+    CLogger *pLogger = CLogger::GetThis();
+
+    delete fH5;
+    fH5 = NULL;
+    while (fFile < fFiles.size())
+    {
+	const char *Filename = fFiles[fFile++].c_str();
+	fH5 = new H5Logger(Filename, NULL, 0, true);
+	if (fH5->CheckError())
+	{
+	    pLogger->Log("# %s: failed to open %s\n", fName.c_str(), Filename);
+	    delete fH5;
+	    fH5 = NULL;
+	    continue;
+	}
+	fCols[0] = fH5->IndexFromName("Time");
+	fCols[1] = fH5->IndexFromName("Mx");
+	fCols[2] = fH5->IndexFromName("My");
+	fCols[3] = fH5->IndexFromName("Mz");
+	fRow     = 0;
+	fNRows   = fH5->NEntries();
+	pLogger->LogTime("%s: %s, %ld rows\n", fName.c_str(), Filename, 
+			 (long) fNRows);
+	return true;
+    }
+    return false;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Fill
+ *
+ * Description : Read the next block of rows, on to the next file 
+ *               as each runs out. 
+ *
+ * Inputs : none
+ *
+ * Returns : false at the end of the last file
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SiteStream::Fill(void)
+{
+    const double *var;
+
+    fPos = fN = 0;
+    while (fN == 0)
+    {
+	if ((fH5 == NULL) || (fRow >= fNRows))
+	{
+	    if (!Open()) return false;
+	}
+	while ((fN < fBuf.size()) && (fRow < fNRows))
+	{
+	    if (fH5->DatasetReadRow(fRow))
+	    {
+		var = fH5->RowData();
+		SiteSample &s = fBuf[fN];
+		s.fTime = var[fCols[0]];
+		s.fM[0] = var[fCols[1]];
+		s.fM[1] = var[fCols[2]];
+		s.fM[2] = var[fCols[3]];
+		if (s.fTime > fLast)
+		{
+		    fLast = s.fTime;
+		    fN++;
+		}
+		else
+		{
+		    fDropped++;
+		}
+	    }
+	    fRow++;
+	}
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Next
+ *
+ * Description : 
+ *
+ * Inputs : s - returned
+ *
+ * Returns : false at the end
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SiteStream::Next(SiteSample &s)
+{
+    if ((fPos >= fN) && !Fill()) return false;
+    s = fBuf[fPos++];
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : MultiStream constructor
+ *
+ * Description : 
+ *
+ * Inputs : Tolerance - seconds, largest time difference in a set
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+MultiStream::MultiStream(double Tolerance)
+{
+    fTol    = fabs(Tolerance);
+    fPrimed = false;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : MultiStream destructor
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+MultiStream::~MultiStream(void)
+{
+    for (size_t i=0; i<fSite.size(); i++) delete fSite[i];
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : 
+ *
+ * Inputs : s - site, owned
+ *
+ * Returns : none
+ *
+ * Error Conditions : at most 32 sites, the mask
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void MultiStream::Add(SiteStream *s)
+{
+    if (fSite.size() >= 32)
+    {
+	delete s;
+	return;
+    }
+    fSite.push_back(s);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Next
+ *
+ * Description : Pop the earliest head, then every head within 
+ *               Tolerance of it. A site is not refilled until the 
+ *               set is done, so it is in a set at most once, and 
+ *               a later sample from it starts a later set. 
+ *
+ * Inputs : Set  - returned, one per site
+ *          Mask - returned, sites in the set
+ *
+ * Returns : false when all sites are done
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool MultiStream::Next(vector<SiteSample> &Set, uint32_t &Mask)
+{
+    uint32_t s;
+    double   t0;
+
+    if (!fPrimed)
+    {
+	fHead.resize(fSite.size());
+	for (s=0; s<fSite.size(); s++)
+	{
+	    if (fSite[s]->Next(fHead[s])) fHeap.push(Head(fHead[s].fTime, s));
+	}
+	fPrimed = true;
+    }
+    Mask = 0;
+    if (fHeap.empty()) return false;
+
+    Set.resize(fSite.size());
+    fTaken.clear();
+    t0 = fHeap.top().first;
+    while (!fHeap.empty() && (fHeap.top().first <= t0 + fTol))
+    {
+	s = fHeap.top().second;
+	fHeap.pop();
+	Set[s] = fHead[s];
+	Mask  |= (1U << s);
+	fTaken.push_back(s);
+    }
+    for (size_t i=0; i<fTaken.size(); i++)
+    {
+	s = fTaken[i];
+	if (fSite[s]->Next(fHead[s])) fHeap.push(Head(fHead[s].fTime, s));
+    }
+    return true;
+}
@@ -0,0 +1,115 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : MultiStream.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Several PiDA sites read together in time order. A 
+ * SiteStream reads one site's files, oldest first, a block of rows
+ * at a time. MultiStream merges the sites on Time with a heap and 
+ * hands back aligned sets, the earliest sample left and, from each
+ * other site, the first sample within Tolerance seconds of it. 
+ * Every sample goes in and out of the heap once, so the work is 
+ * linear in the samples, log of the number of sites each, and the 
+ * memory is one block per site. 
+ *
+ * Restrictions/Limitations : Time must increase within a site, 
+ * rows that go back in time or repeat are dropped. Main thread 
+ * only, no H5Mutex. 
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __MULTISTREAM_hh_
+#define __MULTISTREAM_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <string>
+#  include <vector>
+#  include <queue>
+#  include <functional>
+
+class H5Logger;
+
+/// One row from a site. 
+struct SiteSample
+{
+    double fTime;          // Seconds since 1970, the Time column
+    double fM[3];          // Mx, My, Mz
+};
+
+class SiteStream
+{
+public:
+    /*!
+     * Name  - label for the output
+     * Files - the site's files in time order
+     * Rows  - rows read at a time
+     */
+    SiteStream(const char *Name, const std::vector<std::string> &Files, 
+	       size_t Rows=4096);
+    ~SiteStream(void);
+
+    /// Next sample, false at the end of the last file. 
+    bool   Next(SiteSample &s);
+
+    inline const std::string& Name(void) const {return fName;};
+    inline uint64_t Dropped(void) const {return fDropped;};
+
+private:
+    bool   Fill(void);
+    bool   Open(void);
+
+    std::string  fName;
+    std::vector<std::string> fFiles;
+    size_t       fFile;          // Next file to open
+    H5Logger    *fH5;
+    size_t       fRow, fNRows;   // In the open file
+    int32_t      fCols[4];       // Time, Mx, My, Mz
+    std::vector<SiteSample> fBuf;
+    size_t       fPos, fN;
+    double       fLast;          // Time of the last sample given
+    uint64_t     fDropped;
+};
+
+class MultiStream
+{
+public:
+    MultiStream(double Tolerance=0.5);
+    ~MultiStream(void);
+
+    /// Add a site, owned from here on. Before the first Next. 
+    void   Add(SiteStream *s);
+
+    /*!
+     * Description: 
+     *   Next aligned set. 
+     *
+     * Arguments:
+     *   Set  - one per site, valid where the Mask bit is set
+     *   Mask - bit i set if site i is in the set
+     *
+     * Returns:
+     *   false when every site is done
+     */
+    bool   Next(std::vector<SiteSample> &Set, uint32_t &Mask);
+
+    inline size_t NSites(void) const {return fSite.size();};
+    inline const SiteStream& Site(size_t i) const {return *fSite[i];};
+
+private:
+    typedef std::pair<double, uint32_t> Head;   // Time, site
+    std::priority_queue<Head, std::vector<Head>, std::greater<Head> > fHeap;
+    std::vector<SiteStream*> fSite;
+    std::vector<SiteSample>  fHead;              // Next sample per site
+    std::vector<uint32_t>    fTaken;
+    double   fTol;
+    bool     fPrimed;
+};
+#endif
@@ -10,6 +10,10 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions : 
+ * 19-Oct-26 CBL Compact switch for the NOAAday tree. 
+ * 19-Oct-26 CBL Parse every station, aggregate over a station group. 
+ * 19-Oct-26 CBL Read through LineReader, no more 256 byte lines. 
+ * 19-Oct-26 CBL Lines parsed from the view, no string copy. 
  *
  * Classification : Unclassified
  *
@@ -40,6 +44,8 @@ using namespace libconfig;
 #include "tools.h"
 #include "debug.h"
 #include "Plotting.hh"
+#include "KAggregate.hh"
+#include "LineReader.hh"
 
 AKRead* AKRead::fMainModule;
 
@@ -76,7 +82,11 @@ AKRead::AKRead(const char* ConfigFile) : CObject()
     fInputFileName = strdup("Default.txt");
     fInputFileList = NULL;
     fPlotting      = NULL;
+    fAggregate     = NULL;
+    fLocation      = "Fredericksburg";
+    fStormLevel    = 5;
     fNDays         = 1;
+    fCompact       = true;
 
     /* 
      * Set defaults for configuration file. 
@@ -125,6 +135,8 @@ AKRead::~AKRead(void)
     SET_DEBUG_STACK;
     CLogger *Logger = CLogger::GetThis();
 
+    // Last day of the aggregate has to go in before the file closes.
+    delete fAggregate;
     delete fPlotting;
     
 
@@ -155,8 +167,10 @@ AKRead::~AKRead(void)
  * Function Name : ProcessDate
  *
  * Description : parse the data into indivial items. 
+ *               "2024 Feb 12", year, month name and day. 
  *
- * Inputs : Line containing date information. 
+ * Inputs : Line   - start of the date line, need not be terminated
+ *          Length - number of characters in the line
  *
  * Returns :
  *
@@ -169,42 +183,46 @@ AKRead::~AKRead(void)
  *
  *******************************************************************
  */
-void AKRead::ProcessDate(const string &Line)
+void AKRead::ProcessDate(const char *Line, size_t Length)
 {
     static const char *Month[12] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun",
 			      "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
     SET_DEBUG_STACK;
-    size_t   pos = 0;
-    uint8_t  i   = 0;
-    uint32_t year;
-
-    // Local copy of input line
-    string  LCopy(Line);
-    string  token;
-
-    // Three fields
-    pos   = LCopy.find(" ");
-    token = LCopy.substr(0, pos);
-    year  = stoi(token);
+    const char *End = Line + Length;
+    const char *p   = Line;
+    const char *q;
+    uint8_t  i    = 0;
+    uint32_t year = 0;
+
+    // Three fields, space separated. The view is not terminated, 
+    // so the digits are taken by hand. 
+    while ((p < End) && (*p >= '0') && (*p <= '9'))
+    {
+	year = 10*year + (*p++ - '0');
+    }
     fYear = year - 2020;
-    LCopy.erase(0, pos+1);
+    p = (const char *) memchr(p, ' ', End - p);
+    p = (p != NULL) ? p + 1 : End;
 
-    pos   = LCopy.find(" ");
-    token = LCopy.substr(0, pos);
+    q = (const char *) memchr(p, ' ', End - p);
+    if (q == NULL) q = End;
     // Loop over letters and find match. 
     do {
-	if (token.find(Month[i]) != string::npos)
+	if (memmem(p, q - p, Month[i], 3) != NULL)
 	{
 	    break;
 	}
 	i++;
     } while(i<12);
     fMonth = i;
-    LCopy.erase(0, pos+1);
+    p = (q < End) ? q + 1 : End;
 
-    pos   = LCopy.find(" ");
-    token = LCopy.substr(0, pos);
-    fDay = stoi(token);
+    fDay = 0;
+    while ((p < End) && (*p == ' ')) p++;
+    while ((p < End) && (*p >= '0') && (*p <= '9'))
+    {
+	fDay = 10*fDay + (*p++ - '0');
+    }
 
     SET_DEBUG_STACK;
 }
@@ -215,11 +233,12 @@ void AKRead::ProcessDate(const string &Line)
  *
  * Description : Decide what to do about the current line. 
  *
- * Inputs :
+ * Inputs : Line   - start of the input line, need not be terminated
+ *          Length - number of characters in the line
  *
- * Returns :
+ * Returns : true if a station record was parsed into fAKR
  *
- * Error Conditions :
+ * Error Conditions : lines that do not parse as a record are skipped
  * 
  * Unit Tested on: 
  *
@@ -228,45 +247,39 @@ void AKRead::ProcessDate(const string &Line)
  *
  *******************************************************************
  */
-bool AKRead::ProcessLine(const char *Line, const char *Location)
+bool AKRead::ProcessLine(const char *Line, size_t Length)
 {
     SET_DEBUG_STACK;
     bool rc = true; 
-    string SLine(Line);
 
     fAKR.Clear();
-    if (Location == NULL)
-	return false;
 
-    if (strlen(Line)<=1)
+    if (Length<=1)
     {
 	// blank, just return. 
 	rc = false;
     }
-    else if ((SLine.find(':')!=string::npos)||(SLine.find("#")!=string::npos))
+    else if ((memchr(Line, ':', Length) != NULL) || 
+	     (memchr(Line, '#', Length) != NULL))
     {
 	// Ignore comment lines
 	rc = false;
     }
-    else if (SLine.find("202") == 0)
+    else if ((Length >= 3) && (memcmp(Line, "202", 3) == 0))
     {
 	// Date line??
-	ProcessDate(Line);
+	ProcessDate(Line, Length);
 	// This is incomplete, return a false. 
 	rc = false;
     }
-    else if (SLine.find(Location) == 0)
-    {
-	fAKR.Fill(Line);
-	fAKR.FillDate(fYear, fMonth, fDay);
-    }
     else
     {
-// 	AKRecord akr;
-// 	akr.Fill(Line);
-// 	akr.FillDate(fYear, fMonth, fDay);
-// 	cout << akr;
-	rc = false;
+	/*
+	 * Station record, any station. Anything that 
+	 * does not parse is not a record. 
+	 */
+	rc = fAKR.Fill(Line, Length);
+	if (rc) fAKR.FillDate(fYear, fMonth, fDay);
     }
     SET_DEBUG_STACK;
     return rc;
@@ -332,29 +345,31 @@ bool AKRead::ProcessFile(const char *Filename)
 {
     SET_DEBUG_STACK;
     CLogger *Logger = CLogger::GetThis();
-    char Line[256];
-    int  count = 0;
+    const char *Line;
+    size_t      Length;
+    int         count = 0;
 
-    std::ifstream InData(Filename);
-    // is_open?
-    if (InData.fail())
+    LineReader InData(Filename);
+    if (!InData.IsOpen())
     {
 	Logger->LogTime("Could not open input file: %s\n",  Filename);
 	SetError(-1, __LINE__);
 	return false;
     }
 
-    while (!InData.eof())
+    while (InData.Next(Line, Length))
     {
-	InData.getline(Line, sizeof(Line));
-	if (ProcessLine(Line,"Fredericksburg"))
+	if (ProcessLine(Line, Length))
 	{
-	    count++;
-	    cout << fAKR;
-	    fPlotting->Fill(fAKR);
+	    if (fAKR.fName.find(fLocation) == 0)
+	    {
+		count++;
+		cout << fAKR;
+		fPlotting->Fill(fAKR);
+	    }
+	    fAggregate->Add(fAKR);
 	}
     }
-    InData.close();
     std::cout << "Processed: " << count << " lines. " << std::endl;
     SET_DEBUG_STACK;
     return true;
@@ -425,6 +440,17 @@ bool AKRead::ReadConfiguration(void)
 	MM.lookupValue("Debug"    ,     Debug);
 	MM.lookupValue("InputFile", InputFile);
 	MM.lookupValue("Days"     , fNDays);
+	MM.lookupValue("Compact"  , fCompact);
+	MM.lookupValue("Location" , fLocation);
+	MM.lookupValue("StormLevel", fStormLevel);
+	if (MM.exists("Stations"))
+	{
+	    const Setting &S = MM["Stations"];
+	    for (int i=0; i<S.getLength(); i++)
+	    {
+		fStations.push_back((const char *) S[i]);
+	    }
+	}
 
 	SetDebug(Debug);
 	if (InputFile.length()>0)
@@ -453,7 +479,9 @@ bool AKRead::ReadConfiguration(void)
     {
 	Logger->Log("# Input file list: %s\n", fInputFileName.data());
     }
-    fPlotting = new Plotting(fNDays);
+    fPlotting = new Plotting(fNDays, fCompact);
+    // Histograms go into the file Plotting just opened. 
+    fAggregate = new KAggregate(fNDays, fStations, fStormLevel);
 
     SET_DEBUG_STACK;
     return true;
@@ -495,6 +523,14 @@ bool AKRead::WriteConfiguration(void)
     MM.add("Logging"  , Setting::TypeBoolean) = true;
     MM.add("InputFile", Setting::TypeString)  = fInputFileName;
     MM.add("Days"     , Setting::TypeInt)     = fNDays;
+    MM.add("Compact"  , Setting::TypeBoolean) = fCompact;
+    MM.add("Location" , Setting::TypeString)  = fLocation;
+    MM.add("StormLevel", Setting::TypeInt)    = (int) fStormLevel;
+    Setting &S = MM.add("Stations", Setting::TypeArray);
+    for (size_t i=0; i<fStations.size(); i++)
+    {
+	S.add(Setting::TypeString) = fStations[i];
+    }
 
     // Write out the new configuration.
     try
@@ -10,6 +10,9 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions :
+ * 19-Oct-26 CBL Compact configuration switch. 
+ * 19-Oct-26 CBL Station group K aggregate.
+ * 19-Oct-26 CBL ProcessLine takes a view of the line. 
  *
  * Classification : Unclassified
  *
@@ -25,9 +28,11 @@
 #define __AKREAD_hh_
 #  include <stdint.h>
 #  include <fstream>
+#  include <vector>
 #  include "CObject.hh" // Base class with all kinds of intermediate
 #  include "AKRecord.hh"
 class Plotting;
+class KAggregate;
 
 class AKRead : public CObject
 {
@@ -79,8 +84,15 @@ private:
     uint8_t  fMonth;
     uint8_t  fDay;
     int32_t  fNDays; 
+    bool     fCompact;      // NOAAday tree rather than NOAAtuple
     AKRecord fAKR;
     Plotting *fPlotting;
+    /// Station used for NOAAday/KINDEX
+    string   fLocation;
+    /// Group aggregate, empty station list is all stations. 
+    KAggregate     *fAggregate;
+    vector<string> fStations;
+    int32_t        fStormLevel;
 
     /*! 
      * Configuration file name. 
@@ -92,8 +104,8 @@ private:
     /* Private functions. ==============================  */
 
     bool ProcessFile(const char *Filename);
-    bool ProcessLine(const char *Line, const char *Location);
-    void ProcessDate(const string &Line);
+    bool ProcessLine(const char *Line, size_t Length);
+    void ProcessDate(const char *Line, size_t Length);
 
     /*!
      * Read the configuration file. 
@@ -10,6 +10,7 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions : 
+ * 19-Oct-26 CBL Fill parses straight from the line, no copies. 
  *
  * Classification : Unclassified
  *
@@ -25,6 +26,8 @@ using namespace std;
 
 #include <string>
 #include <cstring>
+#include <cstdlib>
+#include <stdexcept>
 
 /// Local Includes.
 #include "AKRecord.hh"
@@ -32,6 +35,61 @@ using namespace std;
 #include "tools.h"
 #include "debug.h"
 
+/**
+ * Field of N characters at Pos, clipped to the line, copied to Buf
+ * so it is terminated. Buf holds at least N+1. False if the field 
+ * starts past the end of the line. 
+ */
+static bool Field(const char *Line, size_t Length, size_t Pos, size_t N,
+		  char *Buf)
+{
+    if (Pos >= Length) return false;
+    if (N > Length - Pos) N = Length - Pos;
+    memcpy(Buf, Line + Pos, N);
+    Buf[N] = '\0';
+    return true;
+}
+/// Integer field, false if there is no number at its start. 
+static bool IntField(const char *Line, size_t Length, size_t Pos, size_t N,
+		     int32_t &v)
+{
+    char  Buf[16];
+    char *End;
+    if (!Field(Line, Length, Pos, N, Buf)) return false;
+    v = (int32_t) strtol(Buf, &End, 10);
+    return (End != Buf);
+}
+/*
+ * Float field, false if there is no number at its start. The K 
+ * and A fields are whole numbers, those are done by hand, exact and
+ * without the locale lookups of strtof. Anything else goes to 
+ * strtof. 
+ */
+static bool FloatField(const char *Line, size_t Length, size_t Pos, 
+		       size_t N, float &v)
+{
+    char  Buf[16];
+    char *End;
+    const char *p;
+    int32_t     k = 0;
+    bool        Neg;
+
+    if (!Field(Line, Length, Pos, N, Buf)) return false;
+    for (p=Buf; *p == ' '; p++);
+    Neg = (*p == '-');
+    if ((*p == '-') || (*p == '+')) p++;
+    if ((*p >= '0') && (*p <= '9'))
+    {
+	while ((*p >= '0') && (*p <= '9')) k = 10*k + (*p++ - '0');
+	if ((*p == '\0') || (*p == ' '))
+	{
+	    v = (float) (Neg ? -k : k);
+	    return true;
+	}
+    }
+    v = strtof(Buf, &End);
+    return (End != Buf);
+}
 
 /**
  ******************************************************************
@@ -101,11 +159,12 @@ void AKRecord::Clear(void)
  * Description : Fill a record from an input line. The input 
  * file is extremely structured. This should be easy. 
  *
- * Inputs :
+ * Inputs : val - the line
  *
- * Returns :
+ * Returns : true on success
  *
- * Error Conditions :
+ * Error Conditions : throws invalid_argument if a field does not 
+ *                    parse, as stoi did
  * 
  * Unit Tested on: 
  *
@@ -117,9 +176,42 @@ void AKRecord::Clear(void)
 bool AKRecord::Fill(const string &val)
 {
     SET_DEBUG_STACK;
-    bool    rv = true;
-    size_t  pos = 0;
-    string  tok;
+    if (!Fill(val.data(), val.size()))
+    {
+	throw invalid_argument("AKRecord::Fill");
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Fill
+ *
+ * Description : Same fields as above, parsed in place from the 
+ *               line. Each field is clipped to the line and only
+ *               the few characters of a number are copied, to 
+ *               terminate them for strtol and strtof. 
+ *
+ * Inputs : Line   - start of the line, need not be terminated
+ *          Length - characters in the line
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : false if a field does not parse, the record is
+ *                    then partly filled
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool AKRecord::Fill(const char *Line, size_t Length)
+{
+    SET_DEBUG_STACK;
+    size_t      pos = 0;
+    const char *p;
 
     /*
      * Example line
@@ -132,53 +224,52 @@ bool AKRecord::Fill(const string &val)
      * If provisional is found, the beginning parse is a bit different. 
      */
 
-    if ((val.find("provisional") != string::npos) ||
-	(val.find("estimated") != string::npos))
+    if ((memmem(Line, Length, "provisional", 11) != NULL) ||
+	(memmem(Line, Length, "estimated", 9) != NULL))
     {
-	pos = val.find(")") + 1;
-	fName = val.substr(0,pos);
+	p = (const char *) memchr(Line, ')', Length);
+	pos = (p != NULL) ? (p - Line) + 1 : 0;
+	fName.assign(Line, pos);
 	fLat = 0;
 	fLon = 0;
     }
     else
     {
-	fName = val.substr(0, 17);
+	fName.assign(Line, (Length < 17) ? Length : 17);
 
-	tok   = val.substr(18,2);
-	if (tok.compare("--") == 0)
+	if ((Length >= 20) && (memcmp(Line + 18, "--", 2) == 0))
 	{
 	    // Skip
-	    fLat = 0.0;
+	    fLat = 0;
 	}
 	else
 	{
-	    fLat  = stoi(tok);
-	    if (val.compare(17,1,"S") == 0) fLat *= -1;
+	    if (!IntField(Line, Length, 18, 2, fLat)) return false;
+	    if (Line[17] == 'S') fLat *= -1;
 	}
 
-	tok   = val.substr(22,3);
-	if (tok.compare("---")==0)
+	if ((Length >= 25) && (memcmp(Line + 22, "---", 3) == 0))
 	{
-	    fLon = 0.0;
+	    fLon = 0;
 	}
 	else
 	{
-	    fLon  = stoi(tok);
-	    if (val.compare(21,1,"W") == 0) fLon *= -1;
+	    if (!IntField(Line, Length, 22, 3, fLon)) return false;
+	    if (Line[21] == 'W') fLon *= -1;
 	}
     }
     pos   = 25;
-    tok   = val.substr(pos,5); pos += 5;
-    fA_Index  = stof(tok);
+    if (!FloatField(Line, Length, pos, 5, fA_Index)) return false;
+    pos  += 5;
 
     for (uint8_t i=0;i<8;i++)
     {
-	tok = val.substr(pos,5); pos+=6;
-	fK_Index[i] = stof(tok);
+	if (!FloatField(Line, Length, pos, 5, fK_Index[i])) return false;
+	pos += 6;
     }
 
     SET_DEBUG_STACK;
-    return rv;
+    return true;
 }
 /**
  ******************************************************************
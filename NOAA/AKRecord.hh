@@ -10,6 +10,7 @@
  * Restrictions/Limitations : none
  *
  * Change Descriptions :
+ * 19-Oct-26 CBL Fill from a line view, no string needed. 
  *
  * Classification : Unclassified
  *
@@ -31,6 +32,11 @@ class AKRecord
 public:
     AKRecord(void);
     bool Fill(const string &val);
+    /*!
+     * Fill from Length characters at Line, need not be terminated.
+     * Returns false if a field does not parse. 
+     */
+    bool Fill(const char *Line, size_t Length);
     void Clear(void);
 
     string  fName;
@@ -0,0 +1,157 @@
+/********************************************************************
+ *
+ * Module Name : CalTest.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Check of the Calendar against timegm and a timing
+ * of the two, and of mktime, which is what Plotting::Fill used.
+ * Every hour of every day from 1-Jan-2000 through 31-Dec-2099 is
+ * compared, CalEpoch both ways and CalYearDay against tm_yday.
+ * Minutes and seconds are stepped along with the hour so they are
+ * not always 0. Exit status is 0 only if all agree.
+ *
+ *     make CalTest && ./CalTest
+ *
+ * Restrictions/Limitations : stand alone, libc only.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <time.h>
+#include <chrono>
+
+// Local Includes.
+#include "Calendar.hh"
+
+/// Seconds since an arbitrary start.
+static double Now(void)
+{
+    return std::chrono::duration<double>(
+	std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Check
+ *
+ * Description : Every hour of 2000-2099 against timegm.
+ *
+ * Inputs : none
+ *
+ * Returns : number of mismatches
+ *
+ * Error Conditions : the first few mismatches are printed
+ *
+ *******************************************************************
+ */
+static uint32_t Check(void)
+{
+    const time_t Start = 946684800;      // 1-Jan-2000 00:00:00 UTC
+    const time_t End   = 4102444800LL;   // 1-Jan-2100 00:00:00 UTC
+    struct tm    tm;
+    uint32_t     Bad = 0, N = 0, k = 0;
+    int64_t      e1, e2;
+    uint32_t     yd;
+
+    for (time_t t=Start; t<End; t+=3600, k++)
+    {
+	gmtime_r(&t, &tm);
+	tm.tm_min = k%60;
+	tm.tm_sec = (7*k)%60;
+	e1 = CalEpoch(&tm);
+	e2 = CalEpoch(1900 + tm.tm_year, tm.tm_mon, tm.tm_mday,
+		      tm.tm_hour, tm.tm_min, tm.tm_sec);
+	yd = CalYearDay(1900 + tm.tm_year, tm.tm_mon, tm.tm_mday);
+	N++;
+	if ((e1 != (int64_t) timegm(&tm)) || (e2 != e1) ||
+	    (yd != (uint32_t) tm.tm_yday + 1))
+	{
+	    if (Bad < 10)
+	    {
+		printf("Mismatch %04d-%02d-%02d %02d:%02d:%02d %lld %lld %u\n",
+		       1900 + tm.tm_year, tm.tm_mon + 1, tm.tm_mday,
+		       tm.tm_hour, tm.tm_min, tm.tm_sec, (long long) e1,
+		       (long long) timegm(&tm), yd);
+	    }
+	    Bad++;
+	}
+    }
+    printf("Checked %u hours, 2000-2099, %u mismatches.\n", N, Bad);
+    return Bad;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Bench
+ *
+ * Description : Calls per second of CalEpoch, timegm and mktime
+ *               over the same dates, one pass over 2000-2099 a day
+ *               at a time, repeated. The sum is printed so nothing
+ *               is optimized away.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ *
+ *******************************************************************
+ */
+static void Bench(void)
+{
+    const uint32_t NDay  = 36525;
+    const uint32_t NPass = 20;
+    const char    *Name[3] = {"CalEpoch", "timegm", "mktime"};
+    struct tm     *Tm = new struct tm[NDay];
+    time_t         t  = 946684800;
+    double         t0, dt[3];
+    int64_t        Sum[3];
+
+    for (uint32_t i=0; i<NDay; i++, t+=86400)
+    {
+	gmtime_r(&t, &Tm[i]);
+	Tm[i].tm_hour = 3*(i%8);
+    }
+    for (uint32_t m=0; m<3; m++)
+    {
+	Sum[m] = 0;
+	t0 = Now();
+	for (uint32_t p=0; p<NPass; p++)
+	{
+	    for (uint32_t i=0; i<NDay; i++)
+	    {
+		switch (m)
+		{
+		case 0: Sum[m] += CalEpoch(&Tm[i]); break;
+		case 1: Sum[m] += timegm(&Tm[i]);   break;
+		case 2: Tm[i].tm_isdst = 0; Sum[m] += mktime(&Tm[i]); break;
+		}
+	    }
+	}
+	dt[m] = Now() - t0;
+	printf("%-9s %8.1f ns/call  %10.3g calls/s  sum %lld\n", Name[m],
+	       1.0e9*dt[m]/(NDay*NPass), (NDay*NPass)/dt[m],
+	       (long long) Sum[m]);
+    }
+    printf("CalEpoch is %.1fx timegm and %.1fx mktime.\n",
+	   dt[1]/dt[0], dt[2]/dt[0]);
+    delete [] Tm;
+}
+
+int main(void)
+{
+    uint32_t Bad = Check();
+    Bench();
+    return (Bad > 0) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
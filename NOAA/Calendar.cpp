@@ -0,0 +1,163 @@
+/********************************************************************
+ *
+ * Module Name : Calendar.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Table driven UTC calendar. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <stdint.h>
+
+// Local Includes.
+#include "Calendar.hh"
+
+/// Cumulative days at the start of each month, normal and leap years
+static const uint16_t kCumDays[2][13] = {
+    {0,31,59,90,120,151,181,212,243,273,304,334,365},
+    {0,31,60,91,121,152,182,213,244,274,305,335,366}
+};
+
+/// Number of years in the table. 
+static const uint32_t kNYears = kCalLastYear - kCalFirstYear + 1;
+
+/**
+ * Days from 1-Jan-1970 to 1-Jan of each year in the table. 
+ * Filled once at load time, read only after that. 
+ */
+static struct YearTable
+{
+    int32_t fDays[kNYears];
+    YearTable(void)
+    {
+	fDays[0] = 0;
+	for (uint32_t i=1; i<kNYears; i++)
+	{
+	    fDays[i] = fDays[i-1] + (CalIsLeap(kCalFirstYear+i-1) ? 366:365);
+	}
+    };
+} YearTab;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : DaysToYear
+ *
+ * Description : Days from 1-Jan-1970 to 1-Jan of Year. Table 
+ *               lookup inside the table range, otherwise count 
+ *               the leap days. 
+ *
+ * Inputs : Year - full year
+ *
+ * Returns : days
+ *
+ * Error Conditions : none
+ *
+ *******************************************************************
+ */
+static inline int32_t DaysToYear(uint32_t Year)
+{
+    if ((Year >= kCalFirstYear) && (Year <= kCalLastYear))
+    {
+	return YearTab.fDays[Year - kCalFirstYear];
+    }
+    // 477 leap days between 1-Jan-0001 and 1-Jan-1970
+    int32_t y = Year - 1;
+    return 365*((int32_t)Year - 1970) + (y/4 - y/100 + y/400) - 477;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : CalYearDay
+ *
+ * Description : Day of year, Jan 1 is day 1. 
+ *
+ * Inputs : Year  - full year
+ *          Month - 0-11
+ *          Day   - 1-31
+ *
+ * Returns : day of year
+ *
+ * Error Conditions : Month is clamped to 0-11
+ *
+ *******************************************************************
+ */
+uint32_t CalYearDay(uint32_t Year, uint32_t Month, uint32_t Day)
+{
+    if (Month > 11) Month = 11;
+    return kCumDays[CalIsLeap(Year)][Month] + Day;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : CalDays
+ *
+ * Description : Days since 1-Jan-1970
+ *
+ * Inputs : Year  - full year
+ *          Month - 0-11
+ *          Day   - 1-31
+ *
+ * Returns : days
+ *
+ * Error Conditions : none
+ *
+ *******************************************************************
+ */
+int32_t CalDays(uint32_t Year, uint32_t Month, uint32_t Day)
+{
+    return DaysToYear(Year) + CalYearDay(Year, Month, Day) - 1;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : CalEpoch
+ *
+ * Description : UTC seconds since 1-Jan-1970 00:00:00
+ *
+ * Inputs : Year  - full year
+ *          Month - 0-11
+ *          Day   - 1-31
+ *          Hour, Min, Sec 
+ *
+ * Returns : epoch seconds
+ *
+ * Error Conditions : none
+ *
+ *******************************************************************
+ */
+int64_t CalEpoch(uint32_t Year, uint32_t Month, uint32_t Day, 
+		 uint32_t Hour, uint32_t Min, uint32_t Sec)
+{
+    return 86400LL * CalDays(Year, Month, Day) + 
+	3600LL * Hour + 60LL * Min + Sec;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : CalEpoch
+ *
+ * Description : timegm replacement, fields are taken as UTC. 
+ *
+ * Inputs : tm - broken down time, tm_year is years since 1900. 
+ *
+ * Returns : epoch seconds
+ *
+ * Error Conditions : none
+ *
+ *******************************************************************
+ */
+int64_t CalEpoch(const struct tm *tm)
+{
+    return CalEpoch(1900 + tm->tm_year, tm->tm_mon, tm->tm_mday, 
+		    tm->tm_hour, tm->tm_min, tm->tm_sec);
+}
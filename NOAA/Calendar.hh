@@ -0,0 +1,61 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Calendar.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Table driven UTC calendar. Day of year and epoch
+ * seconds from year, month, day, hour without using mktime. 
+ * mktime applies the local time zone and takes the libc tz lock. 
+ * Everything here is pure arithmetic on constant tables so it
+ * may be called from any thread. 
+ *
+ * Restrictions/Limitations : Gregorian calendar, years >= 1970. 
+ * Months are 0-11 (as in struct tm), days are 1-31. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Used by Analysis as well, in place of YearDay. 
+ *               CalTest checks it against timegm. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __CALENDAR_hh_
+#define __CALENDAR_hh_
+#  include <stdint.h>
+#  include <time.h>
+
+/// First and last year held in the precomputed year table. 
+const uint32_t kCalFirstYear = 1970;
+const uint32_t kCalLastYear  = 2099;
+
+/// True if Year is a leap year.
+inline bool CalIsLeap(uint32_t Year) 
+{return ((Year%4 == 0) && (Year%100 != 0)) || (Year%400 == 0);};
+
+/*!
+ * Day of year, Jan 1 is 1. 
+ * Year is the full year, Month 0-11, Day 1-31
+ */
+uint32_t CalYearDay(uint32_t Year, uint32_t Month, uint32_t Day);
+
+/*!
+ * Days since 1-Jan-1970 for the given date. 
+ */
+int32_t  CalDays(uint32_t Year, uint32_t Month, uint32_t Day);
+
+/*!
+ * UTC seconds since 1-Jan-1970 00:00:00
+ */
+int64_t  CalEpoch(uint32_t Year, uint32_t Month, uint32_t Day, 
+		  uint32_t Hour=0, uint32_t Min=0, uint32_t Sec=0);
+
+/*!
+ * Same as timegm, tm is taken to be UTC. 
+ */
+int64_t  CalEpoch(const struct tm *tm);
+#endif
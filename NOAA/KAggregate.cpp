@@ -0,0 +1,260 @@
+/********************************************************************
+ *
+ * Module Name : KAggregate.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Kp like aggregate over a group of NOAA stations. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstring>
+
+// CERN root includes 
+#include <TH2D.h>
+
+// Local Includes.
+#include "debug.h"
+#include "AKRecord.hh"
+#include "Calendar.hh"
+#include "KAggregate.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : KAggregate constructor
+ *
+ * Description : Create the histograms, these follow KINDEX, 
+ *               day of year on X and time of day on Y. 
+ *
+ * Inputs : NDays      - number of day bins
+ *          Stations   - group of stations, empty for all
+ *          StormLevel - K at which an interval is flagged. 
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+KAggregate::KAggregate(uint32_t NDays, const vector<string> &Stations, 
+		       uint32_t StormLevel)
+{
+    SET_DEBUG_STACK;
+    const double kSecPerDay = 86400.0;
+    const double XMax       = (double) NDays;
+
+    fStations   = Stations;
+    fStormLevel = StormLevel;
+    fYear       = -1;
+    fMonth      = 0;
+    fDay        = 0;
+    memset(fCount, 0, sizeof(fCount));
+
+    fMean     = new TH2D("KMEAN", "Station group mean K", 
+			 NDays, 0.0, XMax, kNInterval, 0.0, kSecPerDay);
+    fMedian   = new TH2D("KMEDIAN", "Station group median K", 
+			 NDays, 0.0, XMax, kNInterval, 0.0, kSecPerDay);
+    fMax      = new TH2D("KMAX", "Station group max K", 
+			 NDays, 0.0, XMax, kNInterval, 0.0, kSecPerDay);
+    fStorm    = new TH2D("KSTORM", 
+			 "Storm interval, median K at or above level", 
+			 NDays, 0.0, XMax, kNInterval, 0.0, kSecPerDay);
+    fNStation = new TH2D("KNSTATION", "Stations reporting", 
+			 NDays, 0.0, XMax, kNInterval, 0.0, kSecPerDay);
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : KAggregate destructor
+ *
+ * Description : Write out the last day. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+KAggregate::~KAggregate(void)
+{
+    SET_DEBUG_STACK;
+    Flush();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : InGroup
+ *
+ * Description : Is the station part of the group? The record 
+ *               names are padded so match on the start of the name. 
+ *               With no group specified all stations are used 
+ *               except the planetary estimate. 
+ *
+ * Inputs : Name - station name from the record
+ *
+ * Returns : true if in the group
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool KAggregate::InGroup(const string &Name) const
+{
+    if (fStations.empty())
+    {
+	return (Name.find("Planetary") == string::npos);
+    }
+    for (size_t i=0; i<fStations.size(); i++)
+    {
+	if (Name.find(fStations[i]) == 0) return true;
+    }
+    return false;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : Accumulate one station-day. 
+ *
+ * Inputs : record - parsed record
+ *
+ * Returns : true if used
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool KAggregate::Add(const AKRecord &record)
+{
+    SET_DEBUG_STACK;
+    int32_t K;
+
+    if (!InGroup(record.fName)) return false;
+
+    if ((record.fYear != fYear) || (record.fMonth != fMonth) ||
+	(record.fDay != fDay))
+    {
+	Flush();
+	fYear  = record.fYear;
+	fMonth = record.fMonth;
+	fDay   = record.fDay;
+    }
+
+    for (uint32_t i=0; i<kNInterval; i++)
+    {
+	// -1 is a missing interval in the NOAA files. 
+	K = (int32_t) record.fK_Index[i];
+	if ((K >= 0) && (K < (int32_t) kNK))
+	{
+	    fCount[i][K]++;
+	}
+    }
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Flush
+ *
+ * Description : Reduce the K counts for the current day to mean, 
+ *               median and max per interval and fill. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void KAggregate::Flush(void)
+{
+    SET_DEBUG_STACK;
+    uint32_t N, Sum, Max, Cum, Lo, Hi;
+    double   T, Median;
+
+    if (fYear < 0) return;
+
+    uint32_t Day = CalYearDay(2020 + fYear, fMonth, fDay);
+
+    for (uint32_t i=0; i<kNInterval; i++)
+    {
+	N   = 0;
+	Sum = 0;
+	Max = 0;
+	for (uint32_t k=0; k<kNK; k++)
+	{
+	    N   += fCount[i][k];
+	    Sum += k*fCount[i][k];
+	    if (fCount[i][k]>0) Max = k;
+	}
+	if (N == 0) continue;
+
+	// Median from the counts, average the middle two when even. 
+	Lo  = Hi = kNK;
+	Cum = 0;
+	for (uint32_t k=0; k<kNK; k++)
+	{
+	    Cum += fCount[i][k];
+	    if ((Lo == kNK) && (Cum >= (N+1)/2)) Lo = k;
+	    if ((Hi == kNK) && (Cum >= N/2+1))   Hi = k;
+	}
+	Median = 0.5*(Lo + Hi);
+
+	T = 3.0 * i * 3600.0;
+	fMean->Fill    (Day, T, ((double) Sum)/((double) N));
+	fMedian->Fill  (Day, T, Median);
+	fMax->Fill     (Day, T, Max);
+	fNStation->Fill(Day, T, N);
+	if (Median >= fStormLevel)
+	{
+	    fStorm->Fill(Day, T, 1.0);
+	}
+    }
+    memset(fCount, 0, sizeof(fCount));
+    fYear = -1;
+    SET_DEBUG_STACK;
+}
@@ -0,0 +1,89 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : KAggregate.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Kp like aggregate over a group of NOAA stations. 
+ * For each 3 hour interval the mean, median and max K across the
+ * group are histogrammed day by day along with a storm flag. 
+ * Records are taken one at a time as they are parsed. Only the 
+ * current day is held and then only as a count of stations per
+ * K value, so memory does not depend on the number of records. 
+ *
+ * Restrictions/Limitations : Records are expected in date order, 
+ * as they are in the NOAA daily files. 
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ * https://www.swpc.noaa.gov/products/station-k-and-indices
+ *
+ *******************************************************************
+ */
+#ifndef __KAGGREGATE_hh_
+#define __KAGGREGATE_hh_
+#  include <stdint.h>
+#  include <string>
+#  include <vector>
+
+class AKRecord;
+class TH2D;
+
+class KAggregate {
+public:
+    /*!
+     * Create the aggregate histograms in the current root directory. 
+     * 
+     * Arguments:
+     *   NDays      - number of day bins, same as KINDEX
+     *   Stations   - station names in the group, empty for all. 
+     *   StormLevel - median K at or above this flags a storm interval
+     */
+    KAggregate(uint32_t NDays, const std::vector<std::string> &Stations, 
+	       uint32_t StormLevel=5);
+    /// Flushes any partial day. Histograms belong to the root file. 
+    ~KAggregate(void);
+
+    /*!
+     * Description: 
+     *   Add one station-day. If the date differs from the day 
+     *   being accumulated, that day is written out first. 
+     *
+     * Arguments:
+     *   record - parsed station record
+     *
+     * Returns:
+     *   true if the station is part of the group. 
+     */
+    bool Add(const AKRecord &record);
+
+    /// Write the current day to the histograms and start over. 
+    void Flush(void);
+
+    /// True if the station name is in the group
+    bool InGroup(const std::string &Name) const;
+
+private:
+    static const uint32_t kNInterval = 8;   // 3 hour intervals
+    static const uint32_t kNK        = 10;  // K 0-9
+
+    std::vector<std::string> fStations;
+    uint32_t fStormLevel;
+    int32_t  fYear;        // Day currently being accumulated, -1 none
+    uint32_t fMonth;
+    uint32_t fDay;
+
+    /// Number of stations reporting each K per interval.
+    uint32_t fCount[kNInterval][kNK];
+
+    TH2D *fMean;
+    TH2D *fMedian;
+    TH2D *fMax;
+    TH2D *fStorm;
+    TH2D *fNStation;
+};
+#endif
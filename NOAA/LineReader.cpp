@@ -0,0 +1,234 @@
+/********************************************************************
+ *
+ * Module Name : LineReader.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : mmap line iterator with buffered fallback. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Local Includes.
+#include "debug.h"
+#include "LineReader.hh"
+
+/// Initial size of the buffer for unmappable input. 
+static const size_t kBufferSize = 65536;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : LineReader constructor
+ *
+ * Description : Open the file. Regular files are mapped read only
+ *               and advised for sequential access. 
+ *
+ * Inputs : Filename - file to read, "-" is stdin. 
+ *
+ * Returns : none
+ *
+ * Error Conditions : IsOpen false if the file can't be opened. 
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+LineReader::LineReader(const char *Filename)
+{
+    SET_DEBUG_STACK;
+    struct stat sb;
+    void       *p;
+
+    fMap  = NULL;
+    fSize = 0;
+    fPos  = 0;
+    fEnd  = 0;
+    fEOF  = false;
+
+    if (strcmp(Filename, "-") == 0)
+    {
+	fFd = dup(STDIN_FILENO);
+    }
+    else
+    {
+	fFd = open(Filename, O_RDONLY);
+    }
+    if (fFd < 0) return;
+
+    if ((fstat(fFd, &sb) == 0) && S_ISREG(sb.st_mode) && (sb.st_size > 0))
+    {
+	p = mmap(NULL, sb.st_size, PROT_READ, MAP_PRIVATE, fFd, 0);
+	if (p != MAP_FAILED)
+	{
+	    fMap  = (const char *) p;
+	    fSize = sb.st_size;
+	    madvise(p, fSize, MADV_SEQUENTIAL);
+	    return;
+	}
+    }
+    // Pipe, empty file or mmap failed. 
+    fBuffer.resize(kBufferSize);
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : LineReader destructor
+ *
+ * Description : unmap and close
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+LineReader::~LineReader(void)
+{
+    SET_DEBUG_STACK;
+    if (fMap)
+    {
+	munmap((void *) fMap, fSize);
+    }
+    if (fFd >= 0)
+    {
+	close(fFd);
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Fill
+ *
+ * Description : Buffered mode only. Move the unread part of the
+ *               buffer to the front, grow it if full, and read more. 
+ *
+ * Inputs : none
+ *
+ * Returns : false if nothing more was read. 
+ *
+ * Error Conditions : read errors are treated as end of file. 
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool LineReader::Fill(void)
+{
+    SET_DEBUG_STACK;
+    ssize_t n;
+
+    if (fEOF) return false;
+
+    if (fPos > 0)
+    {
+	memmove(&fBuffer[0], &fBuffer[fPos], fEnd - fPos);
+	fEnd -= fPos;
+	fPos  = 0;
+    }
+    if (fEnd == fBuffer.size())
+    {
+	// One line bigger than the buffer. 
+	fBuffer.resize(2*fBuffer.size());
+    }
+    do {
+	n = read(fFd, &fBuffer[fEnd], fBuffer.size() - fEnd);
+    } while ((n < 0) && (errno == EINTR));
+
+    if (n <= 0)
+    {
+	fEOF = true;
+	return false;
+    }
+    fEnd += n;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Next
+ *
+ * Description : Return a view of the next line. The '\n' and 
+ *               any '\r' before it are not part of the line. 
+ *
+ * Inputs : Line, Length - set on return
+ *
+ * Returns : false at end of file
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool LineReader::Next(const char *&Line, size_t &Length)
+{
+    const char *start, *nl;
+    size_t      avail;
+
+    if (fFd < 0) return false;
+
+    if (fMap)
+    {
+	if (fPos >= fSize) return false;
+	start = fMap + fPos;
+	avail = fSize - fPos;
+	nl    = (const char *) memchr(start, '\n', avail);
+	Length = (nl) ? (size_t)(nl - start) : avail;
+	fPos  += Length + ((nl) ? 1 : 0);
+    }
+    else
+    {
+	// Look for a line end, reading more until one turns up. 
+	nl = NULL;
+	while (true)
+	{
+	    start = &fBuffer[fPos];
+	    avail = fEnd - fPos;
+	    nl    = (const char *) memchr(start, '\n', avail);
+	    if (nl || !Fill()) break;
+	}
+	start = &fBuffer[fPos];
+	avail = fEnd - fPos;
+	if (avail == 0) return false;
+	Length = (nl) ? (size_t)(nl - start) : avail;
+	fPos  += Length + ((nl) ? 1 : 0);
+    }
+    if ((Length > 0) && (start[Length-1] == '\r'))
+    {
+	Length--;
+    }
+    Line = start;
+    return true;
+}
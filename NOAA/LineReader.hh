@@ -0,0 +1,67 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : LineReader.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Line iterator over a text file. Regular files are 
+ * memory mapped and the lines handed back are views into the map, 
+ * no copy and no line length limit. Pipes and anything else that 
+ * will not map are read through a growing buffer. 
+ *
+ * Restrictions/Limitations : The view returned by Next is not NULL 
+ * terminated and is only good until the next call to Next. 
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __LINEREADER_hh_
+#define __LINEREADER_hh_
+#  include <stddef.h>
+#  include <vector>
+
+class LineReader {
+public:
+    /// Open the file, map it if possible. 
+    LineReader(const char *Filename);
+    /// Unmap and close. 
+    ~LineReader(void);
+
+    /// True if the file was opened. 
+    inline bool IsOpen(void) const {return (fFd >= 0);};
+    /// True if the file is memory mapped rather than buffered. 
+    inline bool IsMapped(void) const {return (fMap != NULL);};
+
+    /*!
+     * Description: 
+     *   Get the next line, without the line terminator. 
+     *
+     * Arguments:
+     *   Line   - set to the start of the line
+     *   Length - set to the number of characters in the line
+     *
+     * Returns:
+     *   false at end of file. 
+     */
+    bool Next(const char *&Line, size_t &Length);
+
+private:
+    int          fFd;
+    const char   *fMap;     // NULL if buffered
+    size_t       fSize;     // size of the map
+    size_t       fPos;      // Current position in map or buffer
+
+    /// Buffered fallback
+    std::vector<char> fBuffer;
+    size_t       fEnd;      // valid data in fBuffer
+    bool         fEOF;
+
+    bool Fill(void);
+};
+#endif
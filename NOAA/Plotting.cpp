@@ -9,6 +9,9 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 19-Oct-26 CBL One NOAAday entry per station-day, K as uint8 
+ *               and a single epoch. Legacy NOAAtuple on a switch. 
+ *               Day and epoch from Calendar, UTC and no mktime. 
  *
  * Classification : Unclassified
  *
@@ -21,17 +24,19 @@
 using namespace std;
 #include <string>
 #include <cmath>
+#include <cstring>
 
 // CERN root includes 
 #include <TROOT.h>
 #include <TFile.h>
 #include <TNtupleD.h>
+#include <TTree.h>
 #include <TH2D.h>
 
 // Local Includes.
 #include "debug.h"
 #include "CLogger.hh"
-#include "YearDay.hh"
+#include "Calendar.hh"
 #include "Plotting.hh"
 #include "AKRead.hh"
 
@@ -40,9 +45,11 @@ using namespace std;
  *
  * Function Name : Plotting constructor
  *
- * Description :
+ * Description : Open Sunspots.root and create the output objects. 
  *
- * Inputs :
+ * Inputs : NDays   - number of days on the KINDEX X axis. 
+ *          Compact - true for the NOAAday tree, false for the 
+ *                    legacy NOAAtuple. 
  *
  * Returns :
  *
@@ -55,12 +62,15 @@ using namespace std;
  *
  *******************************************************************
  */
-Plotting::Plotting (uint32_t NDays)
+Plotting::Plotting (uint32_t NDays, bool Compact)
 {
     SET_DEBUG_STACK;
     // Super wasteful ntuple since only K changes. 
     const char *Names = "DAY:UTC:Time:Lat:Lon:TYPE:INDEX";
     const char *Filename = "Sunspots.root";
+
+    fNtuple = NULL;
+    fDay    = NULL;
     //CLogger *Logger = CLogger::GetThis();
 
     /*
@@ -75,7 +85,26 @@ Plotting::Plotting (uint32_t NDays)
     fRootFile->cd();
     //Logger->LogTime(" Output file %s opened.\n", Filename);
 
-    fNtuple = new TNtupleD("NOAAtuple", "NOAA A and K", Names);
+    if (Compact)
+    {
+	/*
+	 * One entry per station-day. Only K changes over the 
+	 * day so store it as an array. K is 0-9, fits in a byte. 
+	 * Use NOAAExpand.C to get back the NOAAtuple layout. 
+	 */
+	fDay = new TTree("NOAAday", "NOAA A and K per station-day");
+	fDay->Branch("STATION", fStation, "STATION/C");
+	fDay->Branch("EPOCH"  , &fEpoch , "EPOCH/i");
+	fDay->Branch("DAY"    , &fDOY   , "DAY/s");
+	fDay->Branch("Lat"    , &fLat   , "Lat/S");
+	fDay->Branch("Lon"    , &fLon   , "Lon/S");
+	fDay->Branch("A"      , &fA     , "A/S");
+	fDay->Branch("K"      , fK      , "K[8]/b");
+    }
+    else
+    {
+	fNtuple = new TNtupleD("NOAAtuple", "NOAA A and K", Names);
+    }
 
 
     f2D = new TH2D("KINDEX","Day by Day K INDEX", 
@@ -119,13 +148,14 @@ Plotting::~Plotting (void)
  *
  * Function Name : Plotting function
  *
- * Description :
+ * Description : Fill the KINDEX histogram and either the compact 
+ *               NOAAday tree or the legacy ntuple. 
  *
- * Inputs :
+ * Inputs : record - one station-day of A and K
  *
- * Returns :
+ * Returns : none
  *
- * Error Conditions :
+ * Error Conditions : none
  * 
  * Unit Tested on: 
  *
@@ -136,50 +166,85 @@ Plotting::~Plotting (void)
  */
 void Plotting::Fill(const AKRecord &record)
 {
-//    static int dmo[12] = {0,31,59,90,120,151,181,212,243,273,304,334};
-    time_t recordTime;
-    struct tm tm_rec; 
-    Double_t var[6];
+    uint32_t Year = 2020 + record.fYear;
+    uint32_t Day  = CalYearDay(Year, record.fMonth, record.fDay); 
 
-    memset(&tm_rec, 0, sizeof(struct tm));
-
-    uint32_t Day = YearDay(record.fYear, record.fMonth, record.fDay); 
-
-//     uint32_t JulianDay = dmo[record.fMonth] + record.fDay;
+    // time is GMT on A and K index
+    time_t recordTime = CalEpoch(Year, record.fMonth, record.fDay);
 
-//     if ((record.fMonth>1) && (record.fYear%2 == 0))
-//     {
-// 	JulianDay++;
-//     }
+    // K index is every 3 hours. first one 0-3 GMT
+    for (uint32_t i=0;i<8;i++)
+    {
+	f2D->Fill(Day, 3.0 * i * 3600.0, record.fK_Index[i]);
+    }
 
-    // time is GMT on A and K index
-    tm_rec.tm_year = 120 + record.fYear;
-    tm_rec.tm_mon  = record.fMonth;
-    tm_rec.tm_mday = record.fDay;
-    tm_rec.tm_hour = 0.0; // GMT, need to fix. 
-    recordTime = mktime(&tm_rec);
+    if (fNtuple)
+    {
+	FillLegacy(record, Day, recordTime);
+    }
+    if (fDay)
+    {
+	strncpy(fStation, record.fName.c_str(), sizeof(fStation)-1);
+	fStation[sizeof(fStation)-1] = 0;
+	fEpoch = (uint32_t) recordTime;
+	fDOY   = Day;
+	fLat   = record.fLat;
+	fLon   = record.fLon;
+	fA     = (int16_t) record.fA_Index;
+	for (uint32_t i=0;i<8;i++)
+	{
+	    // NOAA marks missing intervals with -1
+	    if (record.fK_Index[i] < 0.0)
+		fK[i] = kKMissing;
+	    else
+		fK[i] = (uint8_t) record.fK_Index[i];
+	}
+	fDay->Fill();
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : FillLegacy
+ *
+ * Description : Old style NOAAtuple, 9 rows per station-day. 
+ *               One for A, then one per K interval. 
+ *
+ * Inputs : record - one station-day of A and K
+ *          Day    - Day of year
+ *          Epoch  - time at 00:00 of the record day. 
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Plotting::FillLegacy(const AKRecord &record, uint32_t Day, time_t Epoch)
+{
+    Double_t var[7];
 
     var[0] = Day;
     var[1] = 0;
-    var[2] = recordTime;
+    var[2] = Epoch;
     var[3] = record.fLat;
     var[4] = record.fLon;
     var[5] = 0; // A Index
     var[6] = record.fA_Index;
     fNtuple->Fill(var);
 
-
     // K index is every 3 hours. first one 0-3 GMT
     for (uint32_t i=0;i<8;i++)
     {
-	tm_rec.tm_hour = 3.0 * i; // GMT, need to fix. 
-	recordTime = mktime(&tm_rec);
 	var[1] = 3.0 * i * 3600.0;
-	var[2] = recordTime;
+	var[2] = Epoch + (time_t) var[1];
 	var[5] = i+1; // K Index
 	var[6] = record.fK_Index[i];
 	fNtuple->Fill(var);
-	f2D->Fill(Day, var[1], var[6]);
     }
 }
-
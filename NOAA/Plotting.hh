@@ -10,6 +10,8 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 19-Oct-26 CBL Added compact per station-day tree NOAAday, the
+ *               old 7 column NOAAtuple is kept behind a switch. 
  *
  * Classification : Unclassified
  *
@@ -19,26 +21,38 @@
  */
 #ifndef __PLOTTING_hh_
 #define __PLOTTING_hh_
+#  include <stdint.h>
+#  include <time.h>
 
 class TFile;
 class AKRecord;
 class TNtupleD;
+class TTree;
 class TH2D;
 
 /// Plotting documentation here. 
 class Plotting {
 public:
+    /// Value stored in NOAAday K[] when the station did not report. 
+    static const uint8_t kKMissing = 0xFF;
+
     /// Default Constructor
-    Plotting(uint32_t NDays=44);
+    /*!
+     * Arguments:
+     *   NDays   - number of day bins on the KINDEX histogram.
+     *   Compact - true, one NOAAday entry per station-day. 
+     *             false, the legacy NOAAtuple with 9 rows per day. 
+     */
+    Plotting(uint32_t NDays=44, bool Compact=true);
     /// Default destructor
     ~Plotting(void);
     /// Plotting function
     /*!
      * Description: 
-     *   
+     *   Add one station-day record to the output. 
      *
      * Arguments:
-     *   
+     *   record - parsed A and K indicies for one station and day. 
      *
      * Returns:
      *
@@ -54,7 +68,19 @@ private:
     const   uint32_t kNTimeBin  = 8;  // 3 hour intervals
 
     TFile    *fRootFile;
-    TNtupleD *fNtuple;
+    TNtupleD *fNtuple;    // Legacy, only if not compact. 
+    TTree    *fDay;       // Compact, one entry per station-day
     TH2D     *f2D;
+
+    /// Branch buffers for fDay
+    char     fStation[32];
+    uint32_t fEpoch;      // UTC at 00:00 of the record day
+    uint16_t fDOY;        // Day of year
+    int16_t  fLat;
+    int16_t  fLon;
+    int16_t  fA;
+    uint8_t  fK[8];
+
+    void FillLegacy(const AKRecord &record, uint32_t Day, time_t Epoch);
 };
 #endif
@@ -0,0 +1,274 @@
+/********************************************************************
+ *
+ * Module Name : Products.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Product selection and what it needs. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <strings.h>
+#include <string>
+using namespace std;
+
+// Local Includes.
+#include "Products.hh"
+#include "RowBlock.hh"
+
+#define BIT(x) (1U << (x))
+
+/// What each product and stage needs. 
+struct Need {
+    const char *fName;
+    uint32_t    fStages;
+    uint32_t    fColumns;
+};
+
+static const Need kProduct[Products::kNProduct] = {
+    {"NTUPLE"   , BIT(Products::kTime), BIT(RowBlock::kNInputCol) - 1},
+    {"GRAPH"    , BIT(Products::kTime) | BIT(Products::kFilter), 0},
+    {"PROFILE"  , BIT(Products::kTime) | BIT(Products::kMag), 0},
+    {"ABSMAG2D" , BIT(Products::kTime) | BIT(Products::kMag), 0},
+    {"Z2D"      , BIT(Products::kTime), BIT(RowBlock::kMZ)},
+    {"KINDEX"   , BIT(Products::kTime), BIT(RowBlock::kMZ)},
+    {"QUANTILES", BIT(Products::kTime) | BIT(Products::kMag), 0},
+    {"DESPIKE"  , 0, 
+     BIT(RowBlock::kMX) | BIT(RowBlock::kMY) | BIT(RowBlock::kMZ)},
+    {"PSD"      , BIT(Products::kMag), 
+     BIT(RowBlock::kMX) | BIT(RowBlock::kMY) | BIT(RowBlock::kMZ)},
+    {"SQ"       , BIT(Products::kTime) | BIT(Products::kMag), 
+     BIT(RowBlock::kMZ)},
+    {"TILT"     , BIT(Products::kTime) | BIT(Products::kTiltStage), 0},
+    {"TEMPFIT"  , 0, BIT(RowBlock::kTemp) | 
+     BIT(RowBlock::kMX) | BIT(RowBlock::kMY) | BIT(RowBlock::kMZ)},
+    {"ROLLUP"   , BIT(Products::kTime) | BIT(Products::kMag), 
+     BIT(RowBlock::kMZ)},
+};
+
+static const Need kStage[Products::kNStage] = {
+    {"TIME"  , 0, BIT(RowBlock::kUTC)},
+    {"MAG"   , 0, BIT(RowBlock::kMX) | BIT(RowBlock::kMY) | BIT(RowBlock::kMZ)},
+    {"FILTER", BIT(Products::kMag), 0},
+    {"TILT"  , 0, BIT(RowBlock::kAX) | BIT(RowBlock::kAY) | BIT(RowBlock::kAZ) |
+     BIT(RowBlock::kMX) | BIT(RowBlock::kMY) | BIT(RowBlock::kMZ)},
+};
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Products constructor
+ *
+ * Description : Nothing asked for. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Products::Products(void)
+{
+    fWant    = 0;
+    fStages  = 0;
+    fColumns = 0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Select
+ *
+ * Description : 
+ *
+ * Inputs : Names - product names
+ *
+ * Returns : false if a name was not known
+ *
+ * Error Conditions : unknown name
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Products::Select(const vector<string> &Names)
+{
+    bool rc = true;
+    bool Found;
+
+    for (size_t i=0; i<Names.size(); i++)
+    {
+	Found = false;
+	for (uint32_t p=0; p<kNProduct; p++)
+	{
+	    if (strcasecmp(Names[i].c_str(), kProduct[p].fName) == 0)
+	    {
+		Want(p);
+		Found = true;
+	    }
+	}
+	rc = rc && Found;
+    }
+    return rc;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Default
+ *
+ * Description : Ntuple, graph, profile and the three day maps. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Products::Default(void)
+{
+    Want(kNtuple);
+    Want(kGraph);
+    Want(kProfile);
+    Want(kAbsMag2D);
+    Want(kZ2D);
+    Want(kKIndex);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Resolve
+ *
+ * Description : Products down to stages, then stages on stages 
+ *               until nothing new, then the columns of all of 
+ *               them. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Products::Resolve(void)
+{
+    uint32_t Last;
+
+    fStages  = 0;
+    fColumns = 0;
+    for (uint32_t p=0; p<kNProduct; p++)
+    {
+	if (!Has(p)) continue;
+	fStages  |= kProduct[p].fStages;
+	fColumns |= kProduct[p].fColumns;
+    }
+    do
+    {
+	Last = fStages;
+	for (uint32_t s=0; s<kNStage; s++)
+	{
+	    if (Stage(s)) fStages |= kStage[s].fStages;
+	}
+    } while (fStages != Last);
+    for (uint32_t s=0; s<kNStage; s++)
+    {
+	if (Stage(s)) fColumns |= kStage[s].fColumns;
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Name
+ *
+ * Description : 
+ *
+ * Inputs : p - product
+ *
+ * Returns : name as used in the configuration
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+const char* Products::Name(uint32_t p)
+{
+    return (p < kNProduct) ? kProduct[p].fName : "";
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Describe
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : e.g. "KINDEX, stages TIME, 2 of 15 columns"
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+string Products::Describe(void) const
+{
+    string   rc;
+    uint32_t N = 0;
+
+    for (uint32_t p=0; p<kNProduct; p++)
+    {
+	if (!Has(p)) continue;
+	if (rc.length() > 0) rc += " ";
+	rc += kProduct[p].fName;
+    }
+    rc += ", stages";
+    for (uint32_t s=0; s<kNStage; s++)
+    {
+	if (Stage(s)) rc += string(" ") + kStage[s].fName;
+    }
+    for (uint32_t c=0; c<RowBlock::kNInputCol; c++)
+    {
+	if (Column(c)) N++;
+    }
+    rc += ", " + to_string(N) + " of " + 
+	to_string(RowBlock::kNInputCol) + " columns";
+    return rc;
+}
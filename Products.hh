@@ -0,0 +1,96 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Products.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Which outputs a run makes and so what it has to 
+ * compute. Each product names the stages and input columns it 
+ * needs, each stage the stages and columns under it. Resolve 
+ * follows that down from the products asked for, and Analysis 
+ * skips every stage and column that is not reached. 
+ *
+ *   product     stages                   columns
+ *   NTUPLE      TIME                     all of the HDF5 row
+ *   GRAPH       TIME FILTER
+ *   PROFILE     TIME MAG
+ *   ABSMAG2D    TIME MAG
+ *   Z2D         TIME                     MZ
+ *   KINDEX      TIME                     MZ
+ *   QUANTILES   TIME MAG
+ *   DESPIKE                              MX MY MZ
+ *   PSD         MAG                      MX MY MZ
+ *   SQ          TIME MAG                 MZ
+ *   TILT        TIME TILT
+ *   TEMPFIT                              Temp MX MY MZ
+ *   ROLLUP      TIME MAG                 MZ
+ *
+ *   stage       needs
+ *   TIME        UTC                      (UTC to seconds, JD, DSEC)
+ *   MAG         MX MY MZ
+ *   FILTER      MAG
+ *   TILT        AX AY AZ MX MY MZ
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL ROLLUP
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __PRODUCTS_hh_
+#define __PRODUCTS_hh_
+#  include <stdint.h>
+#  include <string>
+#  include <vector>
+
+class Products
+{
+public:
+    enum {kNtuple=0, kGraph, kProfile, kAbsMag2D, kZ2D, kKIndex, 
+	  kQuantiles, kDespike, kPSD, kSq, kTilt, kTempFit, kRollup, 
+	  kNProduct};
+    enum {kTime=0, kMag, kFilter, kTiltStage, kNStage};
+
+    Products(void);
+
+    /*!
+     * Description: 
+     *   Ask for products by name, case does not matter. 
+     *
+     * Returns:
+     *   false if a name is not known, the rest are still taken
+     */
+    bool Select(const std::vector<std::string> &Names);
+    /// Ask for one product. 
+    inline void Want(uint32_t p) {fWant |= (1U << p);};
+    /// The products the original Analysis always made. 
+    void Default(void);
+
+    /// Stages and columns for what was asked for. 
+    void Resolve(void);
+    /// One more input column, after Resolve. 
+    inline void AddColumn(uint32_t c) {fColumns |= (1U << c);};
+
+    inline bool Has(uint32_t p)   const {return (fWant   & (1U << p)) != 0;};
+    inline bool Stage(uint32_t s) const {return (fStages & (1U << s)) != 0;};
+    /// Input column c, a RowBlock column number. 
+    inline bool Column(uint32_t c) const {return (fColumns & (1U << c)) != 0;};
+    inline uint32_t Columns(void) const {return fColumns;};
+    inline bool Empty(void) const {return fWant == 0;};
+
+    static const char* Name(uint32_t p);
+    /// Products, stages and number of columns, for the log. 
+    std::string Describe(void) const;
+
+private:
+    uint32_t fWant;
+    uint32_t fStages;
+    uint32_t fColumns;
+};
+#endif
@@ -0,0 +1,863 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Render.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Batch plots from worker processes.
+ *
+ * Restrictions/Limitations : none
+ *
+ * Change Descriptions : 
+ * 19-Oct-26 CBL Graph built from IMUIndex goes with the canvas. 
+ *
+ * Classification : Unclassified
+ *
+ * References : 
+ *
+ *******************************************************************
+ */
+// System includes.
+#include <iostream>
+using namespace std;
+
+#include <string>
+#include <cmath>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <map>
+#include <set>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <libconfig.h++>
+using namespace libconfig;
+
+/// Root includes
+#include <TROOT.h>
+#include <TClass.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TList.h>
+#include <TCanvas.h>
+#include <TH2.h>
+#include <TProfile.h>
+#include <TGraph.h>
+#include <TMultiGraph.h>
+#include <TObjArray.h>
+
+/// Local Includes.
+#include "Render.hh"
+#include "TileExport.hh"
+#include "CLogger.hh"
+#include "tools.h"
+#include "debug.h"
+
+Render* Render::fRender = NULL;
+
+static const char *kTypeName[] = {"map", "profile", "graph", "multigraph",
+				  "tiles"};
+/// Class a key has to inherit from for each type.
+static const char *kTypeClass[] = {"TH2", "TProfile", "TGraph", "TMultiGraph",
+				   "TH2"};
+
+/**
+ * The plots the macros made, used when Render.cfg has no Plots.
+ * Ranges are the ones Plot2D.C had for 62 Kane.
+ */
+static const struct {
+    const char *fName, *fFile, *fObject, *fType, *fOption;
+    const char *fXTitle, *fYTitle, *fZTitle;
+    double      fXMin, fXMax, fZMin, fZMax;
+} kStandard[] = {
+    {"ABSMAG2D", "IMU.root", "ABSMAG2D", "map", "SURF2",
+     "Day", "Time", "Total Field (uT)", 260.0, 317.0, 65.0, 120.0},
+    {"Z2D", "IMU.root", "Z2D", "map", "SURF2",
+     "Day", "Time", "Total Field (uT)", 0.0, 0.0, 65.0, 67.0},
+    {"KINDEX", "IMU.root", "KINDEX", "map", "SURF2",
+     "Day", "Time", "Total Field (uT)", 0.0, 0.0, 2.65, 2.72},
+    {"Profile", "IMU.root", "IMU*", "profile", "",
+     "Time", "Total Field (uT)", "", 0.0, 0.0, 0.0, 0.0},
+    {"IMUData", "IMU.root", "IMUData", "multigraph", "AP",
+     "Time", "Total Field (uT)", "", 0.0, 0.0, 0.0, 0.0},
+    {"Graph", "IMU.root", "IMUGraph*", "graph", "AP",
+     "Time", "Total Field (uT)", "", 0.0, 0.0, 0.0, 0.0},
+    {"NOAA_KINDEX", "Sunspots.root", "KINDEX", "map", "SURF2",
+     "Day", "Time", "K", 0.0, 0.0, 0.0, 0.0},
+    {"ABSMAG2D_tiles", "IMU.root", "ABSMAG2D", "tiles", "COUNT2D",
+     "", "", "", 0.0, 0.0, 0.0, 0.0},
+    {"Z2D_tiles", "IMU.root", "Z2D", "tiles", "COUNT2D",
+     "", "", "", 0.0, 0.0, 0.0, 0.0},
+    {"KINDEX_tiles", "IMU.root", "KINDEX", "tiles", "",
+     "", "", "", 0.0, 0.0, 0.0, 0.0},
+};
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Render constructor
+ *
+ * Description : initialize CObject variables
+ *
+ * Inputs : ConfigFile - configuration file name
+ *
+ * Returns : none
+ *
+ * Error Conditions : ENO_FILE, ECONFIG_READ_FAIL
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Render::Render(const char* ConfigFile) : CObject()
+{
+    CLogger *Logger = CLogger::GetThis();
+
+    /* Store the this pointer. */
+    fRender = this;
+    SetName("Render");
+    SetError(); // No error.
+
+    fRun       = true;
+    fOutputDir = "plots";
+    fFormats.push_back("png");
+    fWorkers   = 4;
+    fWidth     = 1200;
+    fHeight    = 600;
+    for (size_t i=0; i<sizeof(kStandard)/sizeof(kStandard[0]); i++)
+    {
+	Plot P;
+	P.fName   = kStandard[i].fName;
+	P.fFile   = kStandard[i].fFile;
+	P.fObject = kStandard[i].fObject;
+	P.fType   = Type(kStandard[i].fType);
+	P.fOption = kStandard[i].fOption;
+	P.fXTitle = kStandard[i].fXTitle;
+	P.fYTitle = kStandard[i].fYTitle;
+	P.fZTitle = kStandard[i].fZTitle;
+	P.fXMin   = kStandard[i].fXMin;
+	P.fXMax   = kStandard[i].fXMax;
+	P.fZMin   = kStandard[i].fZMin;
+	P.fZMax   = kStandard[i].fZMax;
+	P.fTime   = true;
+	fPlots.push_back(P);
+    }
+
+    if(!ConfigFile)
+    {
+	SetError(ENO_FILE,__LINE__);
+	return;
+    }
+
+    fConfigFileName = strdup(ConfigFile);
+    if(!ReadConfiguration())
+    {
+	SetError(ECONFIG_READ_FAIL,__LINE__);
+	return;
+    }
+    Logger->Log("# Render constructed.\n");
+
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Render Destructor
+ *
+ * Description : write configuration
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Render::~Render(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+
+    if(!WriteConfiguration())
+    {
+	SetError(ECONFIG_WRITE_FAIL,__LINE__);
+	Logger->LogError(__FILE__,__LINE__, 'W',
+			 "Failed to write config file.\n");
+    }
+    free(fConfigFileName);
+
+    Logger->Log("# Render closed.\n");
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Do
+ *
+ * Description : List the jobs, then fork the workers and wait for
+ *               them. One worker, or a fork that fails, runs in
+ *               this process.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : EINPUT_FAIL nothing to draw or no output
+ *                    directory, EWORKER_FAIL a worker had a plot
+ *                    fail
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Render::Do(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    std::chrono::steady_clock::time_point Start =
+	std::chrono::steady_clock::now();
+    vector<pid_t>    Pid;
+    vector<uint32_t> Here;
+    uint32_t NWorker, NFail = 0;
+    int      Status;
+    pid_t    p;
+
+    /*
+     * Initialize Root package.
+     * We don't really need to track the return pointer.
+     * We just need to initialize it.
+     */
+    ::new TROOT("Render","Batch plots");
+    gROOT->SetBatch(kTRUE);
+
+    if (!Expand())
+    {
+	SetError(EINPUT_FAIL, __LINE__);
+	return;
+    }
+    if ((mkdir(fOutputDir.c_str(), 0755) != 0) && (errno != EEXIST))
+    {
+	pLogger->Log("# Can not make %s\n", fOutputDir.c_str());
+	SetError(EINPUT_FAIL, __LINE__);
+	return;
+    }
+
+    NWorker = fWorkers;
+    if (NWorker > fJobs.size()) NWorker = fJobs.size();
+    if (NWorker == 0) NWorker = 1;
+    for (uint32_t w=0; (w<NWorker) && (NWorker>1); w++)
+    {
+	p = fork();
+	if (p == 0)
+	{
+	    // Worker. Ctrl+C stops it, it does not write the config.
+	    signal(SIGINT , SIG_DFL);
+	    signal(SIGTERM, SIG_DFL);
+	    signal(SIGHUP , SIG_DFL);
+	    _exit((Worker(w, NWorker) > 0) ? 1 : 0);
+	}
+	else if (p < 0)
+	{
+	    pLogger->Log("# fork failed for worker %d, run here.\n", w);
+	    Here.push_back(w);
+	}
+	else
+	{
+	    Pid.push_back(p);
+	}
+    }
+    if (NWorker == 1) Here.push_back(0);
+    for (size_t i=0; i<Here.size(); i++)
+    {
+	if (Worker(Here[i], NWorker) > 0) NFail++;
+    }
+    for (size_t i=0; i<Pid.size(); i++)
+    {
+	if ((waitpid(Pid[i], &Status, 0) < 0) || !WIFEXITED(Status) ||
+	    (WEXITSTATUS(Status) != 0))
+	{
+	    NFail++;
+	}
+    }
+    if (NFail > 0) SetError(EWORKER_FAIL, __LINE__);
+
+    pLogger->LogTime("Render: %d plots, %d workers, %d with failures, "
+		     "%f s.\n", (int) fJobs.size(), NWorker, NFail,
+		     std::chrono::duration<double>(
+			 std::chrono::steady_clock::now() - Start).count());
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Expand
+ *
+ * Description : One job per plot, or per matching key for a
+ *               name with a *. Each input file is opened once to
+ *               check it and list its keys, and closed again before
+ *               the fork, a TFile is not shared across processes.
+ *
+ * Inputs : none
+ *
+ * Returns : true if there is something to draw
+ *
+ * Error Conditions : plots with a missing file are logged and left
+ *                    out
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Render::Expand(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    map<string, TFile*> Files;
+    set<string> Seen;
+    TKey   *Key;
+    TClass *Class;
+    Job     J;
+
+    fJobs.clear();
+    for (size_t i=0; i<fPlots.size(); i++)
+    {
+	const Plot &P = fPlots[i];
+	TFile *&f = Files[P.fFile];
+	if (f == NULL) f = TFile::Open(P.fFile.c_str());
+	if ((f == NULL) || f->IsZombie())
+	{
+	    pLogger->Log("# %s: can not open %s, left out.\n",
+			 P.fName.c_str(), P.fFile.c_str());
+	    continue;
+	}
+	J.fPlot = i;
+	size_t Star = P.fObject.find('*');
+	if (Star == string::npos)
+	{
+	    J.fObject = P.fObject;
+	    J.fOut    = P.fName;
+	    fJobs.push_back(J);
+	    continue;
+	}
+	string Prefix = P.fObject.substr(0, Star);
+	Seen.clear();
+	TIter Next(f->GetListOfKeys());
+	while ((Key = (TKey *) Next()))
+	{
+	    string Name = Key->GetName();
+	    if (Name.compare(0, Prefix.size(), Prefix) != 0) continue;
+	    // Only the right kind, IMU* also matches IMUTuple.
+	    Class = TClass::GetClass(Key->GetClassName());
+	    if ((Class == NULL) || !Class->InheritsFrom(kTypeClass[P.fType]))
+		continue;
+	    // Cycles of one key are one plot.
+	    if (!Seen.insert(Name).second) continue;
+	    J.fObject = Name;
+	    J.fOut    = P.fName + "_" + Name.substr(Prefix.size());
+	    fJobs.push_back(J);
+	}
+    }
+    for (map<string, TFile*>::iterator it=Files.begin();
+	 it!=Files.end(); it++)
+    {
+	delete it->second;
+    }
+    pLogger->LogTime("Render: %d plots from %d entries.\n",
+		     (int) fJobs.size(), (int) fPlots.size());
+    SET_DEBUG_STACK;
+    return !fJobs.empty();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Worker
+ *
+ * Description : Jobs w, w+NWorker, ... Each file is opened the
+ *               first time a job needs it and kept open. One canvas
+ *               for all of them.
+ *
+ * Inputs : w       - this worker
+ *          NWorker - number of workers
+ *
+ * Returns : number of jobs that failed
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int Render::Worker(uint32_t w, uint32_t NWorker)
+{
+    SET_DEBUG_STACK;
+    map<string, TFile*> Files;
+    int      NFail = 0;
+    string   Out;
+
+    TCanvas *c = new TCanvas(Form("Render%d", w), "Render", 5, 5,
+			     fWidth, fHeight);
+    for (size_t j=w; (j<fJobs.size()) && fRun; j+=NWorker)
+    {
+	const Job  &J = fJobs[j];
+	TFile *&f = Files[fPlots[J.fPlot].fFile];
+	if (f == NULL) f = TFile::Open(fPlots[J.fPlot].fFile.c_str());
+	if (fPlots[J.fPlot].fType == kTiles)
+	{
+	    // Nothing drawn, so no canvas.
+	    if ((f == NULL) || f->IsZombie() || !Tiles(f, J)) NFail++;
+	    continue;
+	}
+	if ((f == NULL) || f->IsZombie() || !Draw(f, J, c))
+	{
+	    NFail++;
+	    continue;
+	}
+	for (size_t k=0; k<fFormats.size(); k++)
+	{
+	    Out = fOutputDir + "/" + J.fOut + "." + fFormats[k];
+	    c->SaveAs(Out.c_str());
+	}
+    }
+    delete c;
+    for (map<string, TFile*>::iterator it=Files.begin();
+	 it!=Files.end(); it++)
+    {
+	delete it->second;
+    }
+    SET_DEBUG_STACK;
+    return NFail;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Draw
+ *
+ * Description : One plot onto the canvas, styled like the macros.
+ *
+ * Inputs : f - open input file
+ *          J - job
+ *          c - canvas
+ *
+ * Returns : true if drawn
+ *
+ * Error Conditions : no such key, or not the type asked for
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Render::Draw(TFile *f, const Job &J, TCanvas *c)
+{
+    SET_DEBUG_STACK;
+    const Plot &P    = fPlots[J.fPlot];
+    TObject    *Obj  = f->Get(J.fObject.c_str());
+    TH1        *h    = NULL;
+    TAxis      *Time = NULL;
+
+    c->Clear();
+    c->cd();
+    c->SetGrid();
+    // With StreamOutput there is no IMUData, only IMUIndex.
+    if ((Obj == NULL) && (P.fType == kMultiGraph))
+	Obj = f->Get("IMUIndex");
+    if (Obj == NULL) return false;
+
+    switch (P.fType)
+    {
+    case kMap:
+	h = dynamic_cast<TH2 *>(Obj);
+	if (h == NULL) return false;
+	h->Draw(P.fOption.empty() ? "SURF2" : P.fOption.c_str());
+	Time = h->GetYaxis();
+	break;
+    case kProfile:
+	h = dynamic_cast<TProfile *>(Obj);
+	if (h == NULL) return false;
+	h->Draw(P.fOption.c_str());
+	Time = h->GetXaxis();
+	break;
+    case kGraph:
+    {
+	TGraph *g = dynamic_cast<TGraph *>(Obj);
+	if (g == NULL) return false;
+	g->Draw(P.fOption.empty() ? "AP" : P.fOption.c_str());
+	h    = g->GetHistogram();
+	Time = g->GetXaxis();
+    }
+	break;
+    case kMultiGraph:
+    {
+	TMultiGraph *mg    = dynamic_cast<TMultiGraph *>(Obj);
+	TObjArray   *Index = dynamic_cast<TObjArray *>(Obj);
+	if (Index)
+	{
+	    // StreamOutput, one graph per file, as in PlotResult.C
+	    mg = new TMultiGraph(J.fOut.c_str(), "IMU Data");
+	    for (Int_t i=0; i<Index->GetEntries(); i++)
+	    {
+		TGraph *g = (TGraph *) f->Get(Index->At(i)->GetName());
+		if (g) mg->Add(g);
+	    }
+	    // Ours, deleted with its graphs by the next c->Clear().
+	    mg->SetBit(TObject::kCanDelete);
+	}
+	if (mg == NULL) return false;
+	mg->Draw(P.fOption.empty() ? "AP" : P.fOption.c_str());
+	h    = mg->GetHistogram();
+	Time = mg->GetXaxis();
+	TObject *Legend = f->Get("IMULegend");
+	if (Legend) Legend->Draw();
+    }
+	break;
+    default:
+	return false;
+    }
+    if (h == NULL) return false;
+
+    if (P.fTime && Time) TimeAxis(Time);
+    if (!P.fXTitle.empty()) h->SetXTitle(P.fXTitle.c_str());
+    if (!P.fYTitle.empty()) h->SetYTitle(P.fYTitle.c_str());
+    if (!P.fZTitle.empty()) h->SetZTitle(P.fZTitle.c_str());
+    h->SetLabelSize(0.03,"X");
+    h->SetLabelSize(0.03,"Y");
+    if (P.fZMax > P.fZMin)
+    {
+	h->SetMinimum(P.fZMin);
+	h->SetMaximum(P.fZMax);
+    }
+    if (P.fXMax > P.fXMin) h->GetXaxis()->SetRangeUser(P.fXMin, P.fXMax);
+    c->Update();
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Tiles
+ *
+ * Description : Tile pyramid of a map in OutputDir/<output name>.
+ *               The count map is only used if its bins match.
+ *
+ * Inputs : f - open input file
+ *          J - job
+ *
+ * Returns : true if written
+ *
+ * Error Conditions : no such TH2, or a tile could not be written
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Render::Tiles(TFile *f, const Job &J)
+{
+    SET_DEBUG_STACK;
+    const Plot &P     = fPlots[J.fPlot];
+    TH2        *h     = dynamic_cast<TH2 *>(f->Get(J.fObject.c_str()));
+    TH2        *Count = NULL;
+
+    if (h == NULL) return false;
+    if (!P.fOption.empty())
+	Count = dynamic_cast<TH2 *>(f->Get(P.fOption.c_str()));
+
+    TileExport Pyramid((fOutputDir + "/" + J.fOut).c_str());
+    SET_DEBUG_STACK;
+    return Pyramid.Write(h, Count);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : TimeAxis
+ *
+ * Description : Time of day labels, as the macros set them.
+ *
+ * Inputs : Axis - axis in seconds of the day
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Render::TimeAxis(TAxis *Axis)
+{
+    Axis->SetTimeDisplay(1);
+    Axis->SetNdivisions(513);
+    Axis->SetTimeFormat("%H:%M:%S");
+    Axis->SetTimeOffset(0,"gmt");
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Type
+ *
+ * Description : 
+ *
+ * Inputs : Name - map, profile, graph or multigraph
+ *
+ * Returns : type
+ *
+ * Error Conditions : anything else is a map
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t Render::Type(const char *Name)
+{
+    for (uint32_t i=0; i<kNType; i++)
+    {
+	if (strcasecmp(Name, kTypeName[i]) == 0) return i;
+    }
+    return kMap;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : TypeName
+ *
+ * Description : 
+ *
+ * Inputs : Type
+ *
+ * Returns : its name
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+const char* Render::TypeName(uint32_t Type)
+{
+    return kTypeName[(Type < kNType) ? Type : (uint32_t) kMap];
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ReadConfiguration
+ *
+ * Description : Open read the configuration file.
+ *
+ * Inputs : none
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Render::ReadConfiguration(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    ClearError(__LINE__);
+    Config *pCFG = new Config();
+
+    /*
+     * Open the configuragtion file.
+     */
+    try{
+	pCFG->readFile(fConfigFileName);
+    }
+    catch( const FileIOException &fioex)
+    {
+	Logger->LogError(__FILE__,__LINE__,'F',
+			 "I/O error while reading configuration file.\n");
+	return false;
+    }
+    catch (const ParseException &pex)
+    {
+	Logger->Log("# Parse error at: %s : %d - %s\n",
+		    pex.getFile(), pex.getLine(), pex.getError());
+	return false;
+    }
+
+    const Setting& root = pCFG->getRoot();
+    try
+    {
+	int    Debug;
+	const Setting &MM = root["Render"];
+	MM.lookupValue("Debug"     , Debug);
+	MM.lookupValue("OutputDir" , fOutputDir);
+	MM.lookupValue("Workers"   , fWorkers);
+	MM.lookupValue("Width"     , fWidth);
+	MM.lookupValue("Height"    , fHeight);
+	if (MM.exists("Formats"))
+	{
+	    const Setting &F = MM["Formats"];
+	    fFormats.clear();
+	    for (int i=0; i<F.getLength(); i++)
+	    {
+		fFormats.push_back((const char *) F[i]);
+	    }
+	}
+	if (MM.exists("Plots"))
+	{
+	    const Setting &S = MM["Plots"];
+	    string Type;
+	    fPlots.clear();
+	    for (int i=0; i<S.getLength(); i++)
+	    {
+		const Setting &G = S[i];
+		Plot P;
+		P.fFile = "IMU.root";
+		P.fXMin = P.fXMax = P.fZMin = P.fZMax = 0.0;
+		P.fTime = true;
+		Type    = "map";
+		G.lookupValue("Name"   , P.fName);
+		G.lookupValue("File"   , P.fFile);
+		G.lookupValue("Object" , P.fObject);
+		G.lookupValue("Type"   , Type);
+		G.lookupValue("Option" , P.fOption);
+		G.lookupValue("XTitle" , P.fXTitle);
+		G.lookupValue("YTitle" , P.fYTitle);
+		G.lookupValue("ZTitle" , P.fZTitle);
+		G.lookupValue("XMin"   , P.fXMin);
+		G.lookupValue("XMax"   , P.fXMax);
+		G.lookupValue("ZMin"   , P.fZMin);
+		G.lookupValue("ZMax"   , P.fZMax);
+		G.lookupValue("Time"   , P.fTime);
+		P.fType = this->Type(Type.c_str());
+		if (P.fName.empty()) P.fName = P.fObject;
+		fPlots.push_back(P);
+	    }
+	}
+	SetDebug(Debug);
+    }
+    catch(const SettingNotFoundException &nfex)
+    {
+	// Ignore.
+    }
+    delete pCFG;
+    pCFG = 0;
+
+    Logger->Log("# Render %d plots to %s with %d workers.\n",
+		(int) fPlots.size(), fOutputDir.c_str(), fWorkers);
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteConfigurationFile
+ *
+ * Description : Write out final configuration
+ *
+ * Inputs : none
+ *
+ * Returns : NONE
+ *
+ * Error Conditions : NONE
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Render::WriteConfiguration(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *Logger = CLogger::GetThis();
+    ClearError(__LINE__);
+    Config *pCFG = new Config();
+
+    Setting &root = pCFG->getRoot();
+
+    Setting &MM = root.add("Render", Setting::TypeGroup);
+    MM.add("Debug"     , Setting::TypeInt)    = 0;
+    MM.add("OutputDir" , Setting::TypeString) = fOutputDir;
+    MM.add("Workers"   , Setting::TypeInt)    = (int) fWorkers;
+    MM.add("Width"     , Setting::TypeInt)    = (int) fWidth;
+    MM.add("Height"    , Setting::TypeInt)    = (int) fHeight;
+    Setting &F = MM.add("Formats", Setting::TypeArray);
+    for (size_t i=0; i<fFormats.size(); i++)
+    {
+	F.add(Setting::TypeString) = fFormats[i];
+    }
+    Setting &S = MM.add("Plots", Setting::TypeList);
+    for (size_t i=0; i<fPlots.size(); i++)
+    {
+	const Plot &P = fPlots[i];
+	Setting &G = S.add(Setting::TypeGroup);
+	G.add("Name"   , Setting::TypeString)  = P.fName;
+	G.add("File"   , Setting::TypeString)  = P.fFile;
+	G.add("Object" , Setting::TypeString)  = P.fObject;
+	G.add("Type"   , Setting::TypeString)  = TypeName(P.fType);
+	G.add("Option" , Setting::TypeString)  = P.fOption;
+	G.add("XTitle" , Setting::TypeString)  = P.fXTitle;
+	G.add("YTitle" , Setting::TypeString)  = P.fYTitle;
+	G.add("ZTitle" , Setting::TypeString)  = P.fZTitle;
+	G.add("XMin"   , Setting::TypeFloat)   = P.fXMin;
+	G.add("XMax"   , Setting::TypeFloat)   = P.fXMax;
+	G.add("ZMin"   , Setting::TypeFloat)   = P.fZMin;
+	G.add("ZMax"   , Setting::TypeFloat)   = P.fZMax;
+	G.add("Time"   , Setting::TypeBoolean) = P.fTime;
+    }
+
+    // Write out the new configuration.
+    try
+    {
+	pCFG->writeFile(fConfigFileName);
+	Logger->Log("# New configuration successfully written to: %s\n",
+		    fConfigFileName);
+
+    }
+    catch(const FileIOException &fioex)
+    {
+	Logger->Log("# I/O error while writing file: %s \n",
+		    fConfigFileName);
+	delete pCFG;
+	return(false);
+    }
+    delete pCFG;
+
+    SET_DEBUG_STACK;
+    return true;
+}
@@ -0,0 +1,143 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Render.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Batch plots from the Analysis and ReadAK outputs,
+ * in place of running Plot2D.C, PlotProf.C, PlotResult.C and
+ * PlotK.C by hand. Each plot in Render.cfg names a file, an object
+ * and how to draw it, ranges and titles included, so nothing is
+ * edited to change a plot. An object name ending in * is every key
+ * in the file that starts with the rest, IMU* for the per file
+ * profiles, one output each.
+ *
+ * The parent lists the jobs and forks Workers processes. Each
+ * worker opens every input file it needs once, in batch mode, and
+ * draws every Workers'th job to PNG, PDF or whatever Formats
+ * asks for. Nothing is shared between workers but the job list.
+ *
+ *   type         object
+ *   map          TH2, day by time, time on Y (SURF2)
+ *   profile      TProfile, time on X
+ *   graph        TGraph, time on X
+ *   multigraph   TMultiGraph, or the IMUIndex of a streamed run,
+ *                with IMULegend if it is there
+ *   tiles        TH2, written as a TileExport pyramid in
+ *                OutputDir/Name for PlotTiles.C to pan and zoom,
+ *                Option names a count map to weight by, COUNT2D
+ *
+ * Restrictions/Limitations : fork, so not on Windows.
+ *
+ * Change Descriptions :
+ * 
+ * 19-Oct-26 CBL tiles type for the zoomable pyramids.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __RENDER_hh_
+#define __RENDER_hh_
+#  include <stdint.h>
+#  include <string>
+#  include <vector>
+#  include "CObject.hh" // Base class with all kinds of intermediate
+
+class TFile;
+class TCanvas;
+class TAxis;
+
+class Render : public CObject
+{
+public:
+    /**
+     * Build on CObject error codes.
+     */
+    enum {ENO_FILE=1, ECONFIG_READ_FAIL, ECONFIG_WRITE_FAIL, EINPUT_FAIL,
+	  EWORKER_FAIL};
+    /**
+     * Constructor, all inputs are in the configuration file.
+     */
+    Render(const char *ConfigFile);
+
+    /**
+     * Destructor for Render
+     */
+    ~Render(void);
+
+    /*! Access the This pointer. */
+    static Render* GetThis(void) {return fRender;};
+
+    /**
+     * Main Module DO
+     *
+     */
+    void Do(void);
+
+    /**
+     * Tell the program to stop.
+     */
+    void Stop(void) {fRun=false;};
+
+private:
+    enum {kMap=0, kProfile, kGraph, kMultiGraph, kTiles, kNType};
+
+    /// One entry of Plots in the configuration.
+    struct Plot {
+	string   fName;       // Output file name, less the extension
+	string   fFile;       // Input root file
+	string   fObject;     // Key, or prefix followed by *
+	uint32_t fType;
+	string   fOption;     // Draw option, empty for the type default
+	string   fXTitle, fYTitle, fZTitle;
+	double   fXMin, fXMax;   // Range on X, not set if equal
+	double   fZMin, fZMax;   // Range of values, not set if equal
+	bool     fTime;          // Time of day axis
+    };
+    /// One output, a plot and the key it draws.
+    struct Job {
+	size_t   fPlot;
+	string   fObject;
+	string   fOut;
+    };
+
+    bool     fRun;
+    string   fOutputDir;
+    std::vector<string> fFormats;    // png, pdf, ...
+    uint32_t fWorkers;
+    uint32_t fWidth, fHeight;
+    std::vector<Plot> fPlots;
+    std::vector<Job>  fJobs;
+
+    /*!
+     * Configuration file name.
+     */
+    char     *fConfigFileName;
+
+    /* Private functions. ==============================  */
+
+    bool   Expand(void);
+    int    Worker(uint32_t w, uint32_t NWorker);
+    bool   Draw(TFile *f, const Job &J, TCanvas *c);
+    bool   Tiles(TFile *f, const Job &J);
+    static void TimeAxis(TAxis *Axis);
+    static uint32_t    Type(const char *Name);
+    static const char* TypeName(uint32_t Type);
+
+    /*!
+     * Read the configuration file.
+     */
+    bool ReadConfiguration(void);
+    /*!
+     * Write the configuration file.
+     */
+    bool WriteConfiguration(void);
+
+    /*! The static 'this' pointer. */
+    static Render *fRender;
+};
+#endif
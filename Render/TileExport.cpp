@@ -0,0 +1,309 @@
+/********************************************************************
+ *
+ * Module Name : TileExport.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Tile pyramid of a day by time map.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <fstream>
+#include <string>
+#include <cstring>
+#include <cmath>
+#include <cerrno>
+#include <limits>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+// CERN root includes
+#include <TH2.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "TileExport.hh"
+
+static_assert(sizeof(TileHeader) == 72, "TileHeader is not 72 bytes");
+
+/**
+ ******************************************************************
+ *
+ * Function Name : TileExport constructor
+ *
+ * Description : 
+ *
+ * Inputs : Dir - directory for the pyramid
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+TileExport::TileExport(const char *Dir)
+{
+    fDir     = Dir;
+    fMaxZoom = 0;
+    fNTile   = 0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Write
+ *
+ * Description : Load the map as the last zoom, then write each zoom
+ *               and sum it 2x2 into the next one out.
+ *
+ * Inputs : h     - map
+ *          Count - weights, or NULL
+ *
+ * Returns : true if every tile was written
+ *
+ * Error Conditions : directories can not be made, a tile can not
+ *                    be written, Count binned unlike h
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool TileExport::Write(const TH2 *h, const TH2 *Count)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    Level    In, Out;
+    double   v, w;
+    bool     rc = true;
+
+    fNTile   = 0;
+    fMaxZoom = 0;
+    In.fNX   = h->GetNbinsX();
+    In.fNY   = h->GetNbinsY();
+    if ((In.fNX == 0) || (In.fNY == 0)) return false;
+    if (Count && ((Count->GetNbinsX() != (Int_t) In.fNX) ||
+		  (Count->GetNbinsY() != (Int_t) In.fNY)))
+    {
+	pLogger->Log("# Tiles: count map does not match, not used.\n");
+	Count = NULL;
+    }
+    while ((((uint32_t) kSize) << fMaxZoom) < max(In.fNX, In.fNY))
+	fMaxZoom++;
+
+    if ((mkdir(fDir.c_str(), 0755) != 0) && (errno != EEXIST))
+    {
+	pLogger->Log("# Tiles: can not make %s\n", fDir.c_str());
+	return false;
+    }
+
+    const size_t N = (size_t) In.fNX*In.fNY;
+    In.fSum.assign(N, 0.0);
+    In.fW.assign(N, 0.0);
+    In.fMin.assign(N, 0.0f);
+    In.fMax.assign(N, 0.0f);
+    for (uint32_t iy=0; iy<In.fNY; iy++)
+    {
+	for (uint32_t ix=0; ix<In.fNX; ix++)
+	{
+	    v = h->GetBinContent(ix+1, iy+1);
+	    w = Count ? Count->GetBinContent(ix+1, iy+1) :
+		((v != 0.0) ? 1.0 : 0.0);
+	    if (!(w > 0.0) || !isfinite(v)) continue;
+	    size_t k = (size_t) iy*In.fNX + ix;
+	    In.fSum[k] = v*w;
+	    In.fW[k]   = w;
+	    In.fMin[k] = In.fMax[k] = (float) v;
+	}
+    }
+
+    const TAxis *X = h->GetXaxis();
+    const TAxis *Y = h->GetYaxis();
+    double DX = (X->GetXmax() - X->GetXmin())/In.fNX;
+    double DY = (Y->GetXmax() - Y->GetXmin())/In.fNY;
+    for (int32_t z=fMaxZoom; z>=0; z--)
+    {
+	rc = WriteLevel(In, z, X->GetXmin(), DX, Y->GetXmin(), DY) && rc;
+	if (z == 0) break;
+	Reduce(In, Out);
+	swap(In, Out);
+	DX *= 2.0;
+	DY *= 2.0;
+    }
+    pLogger->LogTime("Tiles: %s, %d zooms, %d tiles.\n", fDir.c_str(),
+		     fMaxZoom+1, fNTile);
+    SET_DEBUG_STACK;
+    return rc;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Reduce
+ *
+ * Description : One zoom out, each cell the 2x2 of In under it.
+ *               An odd last row or column has fewer.
+ *
+ * Inputs : In  - zoom z
+ *          Out - filled with zoom z-1
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TileExport::Reduce(const Level &In, Level &Out) const
+{
+    Out.fNX = (In.fNX + 1)/2;
+    Out.fNY = (In.fNY + 1)/2;
+    const size_t N = (size_t) Out.fNX*Out.fNY;
+    Out.fSum.assign(N, 0.0);
+    Out.fW.assign(N, 0.0);
+    Out.fMin.assign(N, 0.0f);
+    Out.fMax.assign(N, 0.0f);
+
+    for (uint32_t iy=0; iy<In.fNY; iy++)
+    {
+	for (uint32_t ix=0; ix<In.fNX; ix++)
+	{
+	    size_t i = (size_t) iy*In.fNX + ix;
+	    if (In.fW[i] <= 0.0) continue;
+	    size_t k = (size_t) (iy/2)*Out.fNX + ix/2;
+	    if (Out.fW[k] <= 0.0)
+	    {
+		Out.fMin[k] = In.fMin[i];
+		Out.fMax[k] = In.fMax[i];
+	    }
+	    else
+	    {
+		Out.fMin[k] = min(Out.fMin[k], In.fMin[i]);
+		Out.fMax[k] = max(Out.fMax[k], In.fMax[i]);
+	    }
+	    Out.fSum[k] += In.fSum[i];
+	    Out.fW[k]   += In.fW[i];
+	}
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : WriteLevel
+ *
+ * Description : Every tile of one zoom that has data, and 0_0 at
+ *               zoom 0 regardless.
+ *
+ * Inputs : L      - the zoom's cells
+ *          Zoom   - zoom
+ *          X0, DX - low edge of the map and cell width on X
+ *          Y0, DY - same for Y
+ *
+ * Returns : true if all were written
+ *
+ * Error Conditions : directory or file can not be made
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool TileExport::WriteLevel(const Level &L, uint32_t Zoom, double X0,
+			    double DX, double Y0, double DY)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    const float  NaN   = numeric_limits<float>::quiet_NaN();
+    const size_t NCell = (size_t) kSize*kSize;
+    vector<float> Cell(3*NCell);
+    float  *Mean = Cell.data();
+    float  *Min  = Mean + NCell;
+    float  *Max  = Min  + NCell;
+    TileHeader H;
+    string Dir  = fDir + "/" + to_string(Zoom);
+    string Name;
+    bool   Any;
+
+    if ((mkdir(Dir.c_str(), 0755) != 0) && (errno != EEXIST))
+    {
+	pLogger->Log("# Tiles: can not make %s\n", Dir.c_str());
+	return false;
+    }
+
+    memset(&H, 0, sizeof(H));
+    memcpy(H.fMagic, "TILE", 4);
+    H.fVersion = kVersion;
+    H.fSize    = kSize;
+    H.fZoom    = Zoom;
+    H.fMaxZoom = fMaxZoom;
+    H.fNX      = L.fNX;
+    H.fNY      = L.fNY;
+    H.fDX      = DX;
+    H.fDY      = DY;
+    for (uint32_t ty=0; ty*kSize<L.fNY; ty++)
+    {
+	for (uint32_t tx=0; tx*kSize<L.fNX; tx++)
+	{
+	    Any = (Zoom == 0);
+	    for (uint32_t y=0; y<kSize; y++)
+	    {
+		uint32_t iy = ty*kSize + y;
+		for (uint32_t x=0; x<kSize; x++)
+		{
+		    uint32_t ix = tx*kSize + x;
+		    size_t   c  = (size_t) y*kSize + x;
+		    size_t   k  = (size_t) iy*L.fNX + ix;
+		    if ((ix >= L.fNX) || (iy >= L.fNY) || (L.fW[k] <= 0.0))
+		    {
+			Mean[c] = Min[c] = Max[c] = NaN;
+			continue;
+		    }
+		    Mean[c] = (float) (L.fSum[k]/L.fW[k]);
+		    Min[c]  = L.fMin[k];
+		    Max[c]  = L.fMax[k];
+		    Any     = true;
+		}
+	    }
+	    if (!Any) continue;
+
+	    H.fTX = tx;
+	    H.fTY = ty;
+	    H.fX0 = X0 + (double) tx*kSize*DX;
+	    H.fY0 = Y0 + (double) ty*kSize*DY;
+	    Name  = Dir + "/" + to_string(tx) + "_" + to_string(ty) + ".tile";
+	    ofstream out(Name.c_str(), ios::binary);
+	    out.write((const char *) &H, sizeof(H));
+	    out.write((const char *) Cell.data(), Cell.size()*sizeof(float));
+	    if (out.fail())
+	    {
+		pLogger->Log("# Tiles: can not write %s\n", Name.c_str());
+		return false;
+	    }
+	    fNTile++;
+	}
+    }
+    SET_DEBUG_STACK;
+    return true;
+}
@@ -0,0 +1,99 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : TileExport.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : A day by time map as a pyramid of fixed size tiles
+ * so a viewer can pan and zoom over years of data at a constant cost
+ * per view, kSize by kSize cells at any zoom.
+ *
+ *   Dir/<zoom>/<tx>_<ty>.tile
+ *
+ * Zoom MaxZoom is the map bin for bin, each zoom out halves both
+ * axes, a cell being the 2x2 below it, down to zoom 0 which is the
+ * whole map in one tile. Each cell keeps the mean, weighted by the
+ * count map if one is given, and the min and max of the bins in it,
+ * so a spike does not vanish when zoomed out. Bins with no count, or
+ * 0 with no count map, are empty. Empty cells are NaN and a tile
+ * with nothing in it is not written, except 0/0_0 which a viewer
+ * reads first for MaxZoom and the map origin.
+ *
+ * A tile is a TileHeader then Mean, Min and Max, kSize*kSize floats
+ * each, X fastest, in the byte order of the machine that wrote it.
+ *
+ * Restrictions/Limitations : The full resolution level is held in
+ * memory, 24 bytes a bin, as it is built from a TH2 that is.
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __TILEEXPORT_hh_
+#define __TILEEXPORT_hh_
+#  include <stdint.h>
+#  include <string>
+#  include <vector>
+
+class TH2;
+
+/// On disk at the start of each tile, 72 bytes.
+struct TileHeader {
+    char     fMagic[4];        // "TILE"
+    uint32_t fVersion;
+    uint32_t fSize;            // cells on a side
+    uint32_t fZoom, fMaxZoom;
+    uint32_t fTX, fTY;         // tile column and row
+    uint32_t fNX, fNY;         // cells in the map at this zoom
+    uint32_t fSpare;
+    double   fX0, fDX;         // low edge of the tile and cell width, X
+    double   fY0, fDY;         // and Y, in the units of the map axes
+};
+
+class TileExport {
+public:
+    enum {kSize=256, kVersion=1};
+
+    /*!
+     * Dir - directory the pyramid is written to, made if need be
+     */
+    TileExport(const char *Dir);
+
+    /*!
+     * Description:
+     *   Write the pyramid for a day by time map.
+     *
+     * Arguments:
+     *   h     - map, uniform bins on both axes
+     *   Count - rows per bin to weight the means by, or NULL
+     *
+     * Returns:
+     *   true if every tile was written
+     */
+    bool Write(const TH2 *h, const TH2 *Count=NULL);
+
+    inline uint32_t MaxZoom(void) const {return fMaxZoom;};
+    inline uint32_t NTile(void)   const {return fNTile;};
+
+private:
+    /// One zoom, weighted sums so a zoom out is just a sum.
+    struct Level {
+	uint32_t fNX, fNY;
+	std::vector<double> fSum, fW;
+	std::vector<float>  fMin, fMax;
+    };
+
+    void Reduce(const Level &In, Level &Out) const;
+    bool WriteLevel(const Level &L, uint32_t Zoom, double X0, double DX,
+		    double Y0, double DY);
+
+    std::string fDir;
+    uint32_t    fMaxZoom;
+    uint32_t    fNTile;
+};
+#endif
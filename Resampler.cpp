@@ -0,0 +1,328 @@
+/********************************************************************
+ *
+ * Module Name : Resampler.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Rows onto a uniform time grid.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL ClearCounts. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <cmath>
+#include <cstring>
+#include <strings.h>
+using namespace std;
+
+// Local Includes.
+#include "Resampler.hh"
+#include "UTC2Sec.hh"
+
+static const double kSecPerDay = 86400.0;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Resampler constructor
+ *
+ * Description : 
+ *
+ * Inputs : Step    - grid spacing, seconds
+ *          MaxFill - longest gap filled, in steps
+ *          Mode    - kLinear or kNaN
+ *
+ * Returns : none
+ *
+ * Error Conditions : Step of 0 or less is taken as 1
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Resampler::Resampler(double Step, uint32_t MaxFill, uint32_t Mode)
+{
+    fStep       = (Step > 0.0) ? Step : 1.0;
+    fMaxFill    = MaxFill;
+    fMode       = Mode;
+    ClearCounts();
+    Reset();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : ClearCounts
+ *
+ * Description : So rows that are gridded only to carry on from 
+ *               are not counted, they are counted where they are
+ *               gridded for output. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Resampler::ClearCounts(void)
+{
+    fDuplicates = fGaps = fBreaks = fFilled = fRows = 0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Reset
+ *
+ * Description : Forget the last sample, the counts are kept.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Resampler::Reset(void)
+{
+    fHave    = false;
+    fLastT   = 0.0;
+    fLastRaw = 0.0;
+    fOffset  = 0.0;
+    fNext    = 0;
+    memset(fLast, 0, sizeof(fLast));
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Run
+ *
+ * Description : Each sample closes the interval from the last one,
+ *               the grid points in it are emitted. A duplicate
+ *               closes nothing, a break starts the grid again.
+ *
+ * Inputs : In   - rows as read
+ *          Need - columns to carry
+ *          Out  - grid rows, returned
+ *
+ * Returns : rows in Out
+ *
+ * Error Conditions : rows with no time are dropped
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+size_t Resampler::Run(const RowBlock &In, uint32_t Need, RowBlock &Out)
+{
+    const double *UTC   = In.Time(RowBlock::kUTC);
+    const double  MaxDT = (fMaxFill + 1) * fStep;
+    double Row[RowBlock::kNInputCol];
+    double S, T, dT;
+    size_t n = 0;
+
+    memset(Row, 0, sizeof(Row));
+    Out.fFirst   = In.fFirst;
+    Out.fSeconds = true;
+    for (size_t i=0; i<In.fN; i++)
+    {
+	S = In.fSeconds ? UTC[i] : UTC2Sec(UTC[i]);
+	if (std::isnan(S)) continue;
+	if (fHave && (S < fLastRaw - 0.5*kSecPerDay)) fOffset += kSecPerDay;
+	fLastRaw = S;
+	T = S + fOffset;
+	for (uint32_t c=0; c<RowBlock::kNInputCol; c++)
+	{
+	    if (Need & (1U << c)) Row[c] = In.Get(c, i);
+	}
+
+	if (!fHave)
+	{
+	    Start(T, Row, Need, Out, n);
+	    continue;
+	}
+	dT = T - fLastT;
+	if (dT <= 0.0)
+	{
+	    fDuplicates++;
+	    continue;
+	}
+	if (dT > MaxDT)
+	{
+	    fBreaks++;
+	    Start(T, Row, Need, Out, n);
+	    continue;
+	}
+	if (dT > 1.5*fStep) fGaps++;
+	while (fNext*fStep <= T)
+	{
+	    Emit(fNext*fStep, T, Row, Need, Out, n);
+	    fNext++;
+	}
+	fLastT = T;
+	memcpy(fLast, Row, sizeof(Row));
+    }
+    Out.fN = n;
+    return n;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Start
+ *
+ * Description : First sample of a file or after a break. The grid
+ *               starts at the first multiple of Step at or after it.
+ *
+ * Inputs : T    - sample time
+ *          Row  - sample
+ *          Need - columns to carry
+ *          Out  - grid rows
+ *          n    - rows in Out, advanced
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Resampler::Start(double T, const double *Row, uint32_t Need,
+		      RowBlock &Out, size_t &n)
+{
+    fHave  = true;
+    fLastT = T;
+    memcpy(fLast, Row, sizeof(fLast));
+    fNext  = (int64_t) ceil(T/fStep);
+    if (fNext*fStep <= T)
+    {
+	Emit(T, T, Row, Need, Out, n);
+	fNext++;
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Emit
+ *
+ * Description : One grid row between the last sample and this one.
+ *               Filled if neither is within Step/2 of it.
+ *
+ * Inputs : G    - grid time
+ *          T    - sample time, at or after G
+ *          Row  - sample
+ *          Need - columns to carry
+ *          Out  - grid rows
+ *          n    - rows in Out, advanced
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Resampler::Emit(double G, double T, const double *Row, uint32_t Need,
+		     RowBlock &Out, size_t &n)
+{
+    const double dT    = T - fLastT;
+    const double w     = (dT > 0.0) ? (G - fLastT)/dT : 1.0;
+    const bool   Fill  = ((G - fLastT) >= 0.5*fStep) && 
+	((T - G) >= 0.5*fStep);
+    const bool   Blank = Fill && (fMode == kNaN);
+
+    if (n >= Out.Capacity()) Out.Resize((n > 0) ? 2*n : 1024);
+    for (uint32_t c=0; c<RowBlock::kNInputCol; c++)
+    {
+	if ((Need & (1U << c)) == 0) continue;
+	Out.Set(c, n, Blank ? NAN : fLast[c] + w*(Row[c] - fLast[c]));
+    }
+    Out.fTime[RowBlock::kUTC][n] = fmod(G, kSecPerDay);
+    Out.fCol[RowBlock::kFILL][n] = Fill ? 1.0 : 0.0;
+    if (Fill) fFilled++;
+    fRows++;
+    n++;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Merge
+ *
+ * Description : 
+ *
+ * Inputs : R - counts to add
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Resampler::Merge(const Resampler &R)
+{
+    fDuplicates += R.fDuplicates;
+    fGaps       += R.fGaps;
+    fBreaks     += R.fBreaks;
+    fFilled     += R.fFilled;
+    fRows       += R.fRows;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Mode
+ *
+ * Description : 
+ *
+ * Inputs : Name - "linear" or "nan", case does not matter
+ *
+ * Returns : kLinear or kNaN
+ *
+ * Error Conditions : anything else is kLinear
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t Resampler::Mode(const char *Name)
+{
+    return (Name && (strcasecmp(Name, "nan") == 0)) ? kNaN : kLinear;
+}
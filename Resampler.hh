@@ -0,0 +1,108 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Resampler.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Put the rows of a file on a uniform time grid.
+ * Times come from the UTC column. Grid points are whole multiples
+ * of Step seconds, so any two runs over the same rows, or two
+ * tasks of one file, land on the same grid. Each grid point is
+ * interpolated between the samples either side of it.
+ *
+ *   duplicate - a time at or before the last one, dropped
+ *   gap       - more than 1.5 Step between samples, the grid points
+ *               with no sample within Step/2 are filled, linear or
+ *               NaN, and marked in the FILL column
+ *   break     - more than MaxFill Step, nothing is filled, the
+ *               grid starts again at the next sample
+ *
+ * One linear pass, the last sample is kept from one block to the
+ * next so a gap between blocks is seen.
+ *
+ * Restrictions/Limitations : one file at a time, Reset between.
+ * Midnight in a file is taken from UTC going back by more than
+ * half a day.
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL ClearCounts, for rows run only to warm up. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __RESAMPLER_hh_
+#define __RESAMPLER_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include "RowBlock.hh"
+
+class Resampler
+{
+public:
+    enum {kLinear=0, kNaN};
+
+    /*!
+     * Step    - grid spacing, seconds
+     * MaxFill - longest gap filled, in steps
+     * Mode    - kLinear or kNaN for the filled points
+     */
+    Resampler(double Step=1.0, uint32_t MaxFill=30, uint32_t Mode=kLinear);
+
+    /// A new file, nothing carried over.
+    void   Reset(void);
+    /// Counts to 0, the last sample is kept, after warm up rows.
+    void   ClearCounts(void);
+
+    /*!
+     * Description:
+     *   Grid rows for the rows of In. Out grows if it has to.
+     *   fFile and fDay of Out are left alone.
+     *
+     * Arguments:
+     *   In   - rows as read, UTC as HHMMSS.ss unless fSeconds
+     *   Need - bit per RowBlock input column to carry, as ReadRows
+     *   Out  - grid rows, UTC in seconds of the day, FILL set
+     *
+     * Returns:
+     *   rows in Out, may be 0
+     */
+    size_t Run(const RowBlock &In, uint32_t Need, RowBlock &Out);
+
+    /// Counts of another, a task of the same run.
+    void   Merge(const Resampler &R);
+
+    inline uint64_t Duplicates(void) const {return fDuplicates;};
+    inline uint64_t Gaps(void)       const {return fGaps;};
+    inline uint64_t Breaks(void)     const {return fBreaks;};
+    inline uint64_t Filled(void)     const {return fFilled;};
+    inline uint64_t Rows(void)       const {return fRows;};
+    inline double   Step(void)       const {return fStep;};
+    inline uint32_t Mode(void)       const {return fMode;};
+
+    /// "linear" or "nan", anything else is linear.
+    static uint32_t Mode(const char *Name);
+
+private:
+    double   fStep;
+    uint32_t fMaxFill;
+    uint32_t fMode;
+
+    bool     fHave;                          // fLast is a sample
+    double   fLastT;                         // Seconds, runs past midnight
+    double   fLastRaw;                       // Seconds of the day
+    double   fOffset;                        // Days passed, in seconds
+    double   fLast[RowBlock::kNInputCol];
+    int64_t  fNext;                          // Next grid point, in steps
+
+    uint64_t fDuplicates, fGaps, fBreaks, fFilled, fRows;
+
+    void     Start(double T, const double *Row, uint32_t Need,
+		   RowBlock &Out, size_t &n);
+    void     Emit(double G, double T, const double *Row, uint32_t Need,
+		  RowBlock &Out, size_t &n);
+};
+#endif
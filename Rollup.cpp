@@ -0,0 +1,553 @@
+/********************************************************************
+ *
+ * Module Name : Rollup.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Day, month and year rollups of the day maps.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Pack and Unpack. 
+ * 19-Oct-26 CBL Month bounds from the Calendar, not timegm. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstdio>
+#include <ctime>
+#include <cstring>
+#include <algorithm>
+
+// CERN root includes
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TString.h>
+#include <TParameter.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "Rollup.hh"
+#include "NOAA/Calendar.hh"
+
+static const char *kTreeName[Rollup::kNLevel] =
+{"RollDay", "RollMonth", "RollYear"};
+static const int32_t kSecPerDay = 86400;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Rollup constructor
+ *
+ * Description : 
+ *
+ * Inputs : File - root file for the rollups
+ *          NBin - time bins per day at the day level
+ *
+ * Returns : none
+ *
+ * Error Conditions : NBin is rounded down to a multiple of 12
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Rollup::Rollup(const char *File, uint32_t NBin)
+{
+    fFilename      = File;
+    fNBin[kDay]    = (NBin >= 12) ? 12*(NBin/12) : 12;
+    fNBin[kMonth]  = fNBin[kDay]/3;
+    fNBin[kYear]   = fNBin[kDay]/12;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Read
+ *
+ * Description : Load the three levels from the file.
+ *
+ * Inputs : none
+ *
+ * Returns : true if the file was loaded
+ *
+ * Error Conditions : no file, or NBin does not match, start empty
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Rollup::Read(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    TDirectory *Save = gDirectory;
+    Int_t    Key;
+
+    for (uint32_t L=0; L<kNLevel; L++) fLevel[L].clear();
+    TFile *f = TFile::Open(fFilename.c_str());
+    Save->cd();
+    if ((f == NULL) || f->IsZombie())
+    {
+	pLogger->Log("# No rollup file %s, starting empty.\n",
+		     fFilename.c_str());
+	delete f;
+	return false;
+    }
+    TParameter<Long64_t> *NB = (TParameter<Long64_t> *) f->Get("NBin");
+    if ((NB == NULL) || (NB->GetVal() != (Long64_t) fNBin[kDay]))
+    {
+	pLogger->Log("# Rollup file %s does not match, starting empty.\n",
+		     fFilename.c_str());
+	f->Close();
+	delete f;
+	Save->cd();
+	return false;
+    }
+    for (uint32_t L=0; L<kNLevel; L++)
+    {
+	const uint32_t N = kNQuantity*fNBin[L];
+	vector<double> Sum(N), Min(N), Max(N), Count(N);
+	TTree *T = (TTree *) f->Get(kTreeName[L]);
+	if (T == NULL) continue;
+	T->SetBranchAddress("Key"  , &Key);
+	T->SetBranchAddress("Sum"  , Sum.data());
+	T->SetBranchAddress("Min"  , Min.data());
+	T->SetBranchAddress("Max"  , Max.data());
+	T->SetBranchAddress("Count", Count.data());
+	for (Long64_t i=0; i<T->GetEntries(); i++)
+	{
+	    T->GetEntry(i);
+	    Period &P = fLevel[L][Key];
+	    P.fKey   = Key;
+	    P.fSum   = Sum;
+	    P.fMin   = Min;
+	    P.fMax   = Max;
+	    P.fCount = Count;
+	}
+    }
+    f->Close();
+    delete f;
+    Save->cd();
+    pLogger->LogTime("Rollup %s, %d days, %d months, %d years.\n",
+		     fFilename.c_str(), (int) fLevel[kDay].size(),
+		     (int) fLevel[kMonth].size(), 
+		     (int) fLevel[kYear].size());
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Write
+ *
+ * Description : Write to Filename.tmp then rename, like the
+ *               checkpoint.
+ *
+ * Inputs : none
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : file can not be created or renamed
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Rollup::Write(void) const
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    string   Tmp     = fFilename + ".tmp";
+    TDirectory *Save = gDirectory;
+    Int_t    Key;
+
+    TFile *f = new TFile(Tmp.c_str(), "RECREATE", "Rollups");
+    if (f->IsZombie())
+    {
+	pLogger->Log("# Could not create rollup file %s\n", Tmp.c_str());
+	delete f;
+	Save->cd();
+	return false;
+    }
+    TParameter<Long64_t> NB("NBin", fNBin[kDay]);
+    f->WriteTObject(&NB);
+    for (uint32_t L=0; L<kNLevel; L++)
+    {
+	const uint32_t N = kNQuantity*fNBin[L];
+	vector<double> Sum(N), Min(N), Max(N), Count(N);
+	TTree *T = new TTree(kTreeName[L],
+			     Form("%s, |M| then Z, %d bins a day",
+				  kTreeName[L], fNBin[L]));
+	T->Branch("Key"  , &Key, "Key/I");
+	T->Branch("Sum"  , Sum.data()  , Form("Sum[%d]/D"  , N));
+	T->Branch("Min"  , Min.data()  , Form("Min[%d]/D"  , N));
+	T->Branch("Max"  , Max.data()  , Form("Max[%d]/D"  , N));
+	T->Branch("Count", Count.data(), Form("Count[%d]/D", N));
+	for (map<int32_t, Period>::const_iterator it=fLevel[L].begin();
+	     it!=fLevel[L].end(); it++)
+	{
+	    const Period &P = it->second;
+	    Key = P.fKey;
+	    std::copy(P.fSum.begin(),   P.fSum.end(),   Sum.begin());
+	    std::copy(P.fMin.begin(),   P.fMin.end(),   Min.begin());
+	    std::copy(P.fMax.begin(),   P.fMax.end(),   Max.begin());
+	    std::copy(P.fCount.begin(), P.fCount.end(), Count.begin());
+	    T->Fill();
+	}
+	T->Write();
+    }
+    f->Close();
+    delete f;     // Deletes the trees with it.
+    Save->cd();
+
+    if (rename(Tmp.c_str(), fFilename.c_str()) != 0)
+    {
+	pLogger->Log("# Could not rename rollup file %s\n", Tmp.c_str());
+	return false;
+    }
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : Statistics for a day, then its month and year.
+ *
+ * Inputs : Key                  - days since 1970
+ *          Sum, Min, Max, Count - kNQuantity*NBin each
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Rollup::Add(int32_t Key, const double *Sum, const double *Min,
+		 const double *Max, const double *Count)
+{
+    SET_DEBUG_STACK;
+    const uint32_t N = kNQuantity*fNBin[kDay];
+    Period  New;
+    Period &D = fLevel[kDay][Key];
+
+    if (fTouched.insert(Key).second)
+    {
+	// First time this run, drop what the file had.
+	Clear(D, kDay);
+	D.fKey = Key;
+    }
+    New.fKey = Key;
+    New.fSum.assign(Sum, Sum + N);
+    New.fMin.assign(Min, Min + N);
+    New.fMax.assign(Max, Max + N);
+    New.fCount.assign(Count, Count + N);
+    Fold(New, kDay, D, kDay);
+    RemakeAbove(Key);
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Pack
+ *
+ * Description : Number of days, then for each added this run its 
+ *               key and the Sum, Min, Max and Count. 
+ *
+ * Inputs : v - appended to
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Rollup::Pack(vector<double> &v) const
+{
+    v.push_back(fTouched.size());
+    for (set<int32_t>::const_iterator it=fTouched.begin(); 
+	 it!=fTouched.end(); it++)
+    {
+	const Period &D = fLevel[kDay].find(*it)->second;
+	v.push_back(D.fKey);
+	v.insert(v.end(), D.fSum.begin(), D.fSum.end());
+	v.insert(v.end(), D.fMin.begin(), D.fMin.end());
+	v.insert(v.end(), D.fMax.begin(), D.fMax.end());
+	v.insert(v.end(), D.fCount.begin(), D.fCount.end());
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Unpack
+ *
+ * Description : Days from Pack replace those held, then their 
+ *               months and years are remade. 
+ *
+ * Inputs : p   - packed data, advanced past it
+ *          End - end of the data
+ *
+ * Returns : false if the data ran out
+ *
+ * Error Conditions : short data, the days before it are kept
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Rollup::Unpack(const double *&p, const double *End)
+{
+    SET_DEBUG_STACK;
+    const uint32_t N = kNQuantity*fNBin[kDay];
+    size_t  NDay;
+    int32_t Key;
+
+    if (p >= End) return false;
+    NDay = (size_t) *p++;
+    for (size_t i=0; i<NDay; i++)
+    {
+	if (p + 1 + 4*N > End) return false;
+	Key = (int32_t) *p++;
+	Period &D = fLevel[kDay][Key];
+	D.fKey = Key;
+	D.fSum.assign(p, p + N);   p += N;
+	D.fMin.assign(p, p + N);   p += N;
+	D.fMax.assign(p, p + N);   p += N;
+	D.fCount.assign(p, p + N); p += N;
+	fTouched.insert(Key);
+	RemakeAbove(Key);
+    }
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : RemakeAbove
+ *
+ * Description : Months hold days, years hold months, so the month
+ *               and year a day is in. 
+ *
+ * Inputs : Day - days since 1970
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Rollup::RemakeAbove(int32_t Day)
+{
+    const int32_t Month = MonthKey(Day);
+    const int32_t Year  = YearKey(Day);
+    const int32_t First = CalDays(Month/12, Month%12, 1);
+    const int32_t Last  = CalDays((Month+1)/12, (Month+1)%12, 1);
+    Remake(kMonth, Month, First, Last);
+    Remake(kYear, Year, 12*Year, 12*Year + 12);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : MonthKey
+ *
+ * Description : 
+ *
+ * Inputs : Day - days since 1970
+ *
+ * Returns : year*12 + month, month 0-11
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int32_t Rollup::MonthKey(int32_t Day)
+{
+    time_t    t = (time_t) Day * kSecPerDay;
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    return 12*(tm.tm_year + 1900) + tm.tm_mon;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : YearKey
+ *
+ * Description : 
+ *
+ * Inputs : Day - days since 1970
+ *
+ * Returns : the year
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int32_t Rollup::YearKey(int32_t Day)
+{
+    return MonthKey(Day)/12;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Clear
+ *
+ * Description : Zero a period for level L.
+ *
+ * Inputs : P - period
+ *          L - level
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Rollup::Clear(Period &P, uint32_t L) const
+{
+    const uint32_t N = kNQuantity*fNBin[L];
+    P.fSum.assign(N, 0.0);
+    P.fMin.assign(N, 0.0);
+    P.fMax.assign(N, 0.0);
+    P.fCount.assign(N, 0.0);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Fold
+ *
+ * Description : Merge From into To, From bins taken down to the
+ *               coarser bins of To. Min and Max are only what
+ *               bins with data had.
+ *
+ * Inputs : From, LFrom - period and its level
+ *          To, LTo     - period and its level, added to
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Rollup::Fold(const Period &From, uint32_t LFrom, Period &To,
+		  uint32_t LTo) const
+{
+    const uint32_t NF = fNBin[LFrom];
+    const uint32_t NT = fNBin[LTo];
+    const uint32_t R  = NF/NT;
+    uint32_t f, t;
+
+    for (uint32_t q=0; q<kNQuantity; q++)
+    {
+	for (uint32_t i=0; i<NF; i++)
+	{
+	    f = q*NF + i;
+	    t = q*NT + i/R;
+	    if (From.fCount[f] <= 0.0) continue;
+	    if (To.fCount[t] <= 0.0)
+	    {
+		To.fMin[t] = From.fMin[f];
+		To.fMax[t] = From.fMax[f];
+	    }
+	    else
+	    {
+		To.fMin[t] = std::min(To.fMin[t], From.fMin[f]);
+		To.fMax[t] = std::max(To.fMax[t], From.fMax[f]);
+	    }
+	    To.fSum[t]   += From.fSum[f];
+	    To.fCount[t] += From.fCount[f];
+	}
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Remake
+ *
+ * Description : A month or year again from the level under it.
+ *
+ * Inputs : L           - kMonth or kYear
+ *          Key         - its key
+ *          First, Last - keys of the level under, Last not included
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Rollup::Remake(uint32_t L, int32_t Key, int32_t First, int32_t Last)
+{
+    const map<int32_t, Period> &Under = fLevel[L-1];
+    Period &P = fLevel[L][Key];
+
+    Clear(P, L);
+    P.fKey = Key;
+    map<int32_t, Period>::const_iterator it  = Under.lower_bound(First);
+    map<int32_t, Period>::const_iterator End = Under.lower_bound(Last);
+    for (; it != End; it++)
+    {
+	Fold(it->second, L-1, P, L);
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Rollup.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Rollups of the day maps for long range plots.
+ * Each day, month and year is kept as the sum, min, max and count
+ * of |M| and Z per time of day bin,
+ *
+ *   level   key                  bins per day
+ *   day     days since 1970      NBin      (288, 5 minutes)
+ *   month   year*12 + month 0-11 NBin/3    (96, 15 minutes)
+ *   year    year                 NBin/12   (24, 1 hour)
+ *
+ * and the mean is Sum/Count. A month is made from its days and a
+ * year from its months, so a day added only remakes the month and
+ * year it is in. Five years of months and years are a few hundred
+ * rows. All three levels are kept in one root file, a tree each,
+ * RollDay, RollMonth and RollYear.
+ *
+ * Restrictions/Limitations : A day that is added again in a later
+ * run replaces the stored one, like SqBaseline.
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Pack and Unpack of the days added, for checkpoints. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __ROLLUP_hh_
+#define __ROLLUP_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <string>
+#  include <vector>
+#  include <map>
+#  include <set>
+
+class Rollup {
+public:
+    enum {kDay=0, kMonth, kYear, kNLevel};
+    enum {kMag=0, kZ, kNQuantity};
+
+    /// One day, month or year. Quantity major, kNQuantity*NBin.
+    struct Period {
+	int32_t  fKey;
+	std::vector<double> fSum, fMin, fMax, fCount;
+    };
+
+    /*!
+     * File - root file the rollups are kept in
+     * NBin - time bins per day at the day level, a multiple of 12
+     */
+    Rollup(const char *File, uint32_t NBin=288);
+
+    /*!
+     * Description:
+     *   Load all three levels. Missing or made with another NBin is
+     *   not an error, it starts empty.
+     */
+    bool Read(void);
+    /*!
+     * Description:
+     *   Write all three levels, under a temporary name then renamed.
+     */
+    bool Write(void) const;
+
+    /*!
+     * Description:
+     *   Add statistics for a day. The first Add of a day in this
+     *   run replaces a stored copy, later ones merge with it. The
+     *   month and year it is in are remade.
+     *
+     * Arguments:
+     *   Key                  - days since 1970
+     *   Sum, Min, Max, Count - kNQuantity*NBin, |M| then Z
+     */
+    void Add(int32_t Key, const double *Sum, const double *Min,
+	     const double *Max, const double *Count);
+
+    /*!
+     * Description:
+     *   The days added this run, for a checkpoint, and back on
+     *   resume. Unpack puts them as they were at the checkpoint
+     *   whatever the file has since, marks them added so the rest
+     *   of a day cut by the checkpoint merges with them, and 
+     *   remakes their months and years.
+     */
+    void Pack(std::vector<double> &v) const;
+    bool Unpack(const double *&p, const double *End);
+    inline const std::set<int32_t>& Touched(void) const {return fTouched;};
+    inline const std::map<int32_t, Period>& Level(uint32_t L) const
+	{return fLevel[L];};
+    inline uint32_t NBin(uint32_t L) const {return fNBin[L];};
+
+    /// Month and year keys of a day key.
+    static int32_t MonthKey(int32_t Day);
+    static int32_t YearKey(int32_t Day);
+
+private:
+    void   Clear(Period &P, uint32_t L) const;
+    void   Fold(const Period &From, uint32_t LFrom, Period &To,
+		uint32_t LTo) const;
+    void   Remake(uint32_t L, int32_t Key, int32_t First, int32_t Last);
+    void   RemakeAbove(int32_t Day);
+
+    std::string fFilename;
+    uint32_t    fNBin[kNLevel];
+    std::map<int32_t, Period> fLevel[kNLevel];
+    std::set<int32_t>         fTouched;
+};
+#endif
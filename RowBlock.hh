@@ -0,0 +1,104 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : RowBlock.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : A block of rows from an HDF5 input file held 
+ * column by column. This is the unit of work passed between the 
+ * reader, compute and writer stages. The first kNTupleCol columns
+ * are the IMUTuple columns in order, followed by columns derived
+ * in the compute stage. 
+ *
+ * Samples are Sample_t, double, or float when built with FLOAT32,
+ * which halves the memory the blocks take and lets the kernels work
+ * on twice as many values at a time. The field columns in the H5 
+ * files are calibrated uT doubles, not counts, so float rounds each
+ * sample to 24 bits, at most 6e-8 relative, about 3e-6 uT at 50 uT,
+ * far below the 0.15 uT step of the device. Time, UTC, JD and DSEC
+ * stay double, DSEC runs to 3e7 seconds which float only holds to 
+ * 2 s. 
+ * Get, Set and Row take either kind of column as a double. 
+ *
+ * Restrictions/Limitations : none
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL REJ column, set by the despiker. 
+ * 19-Oct-26 CBL FILL column and fSeconds, for the Resampler. 
+ * 19-Oct-26 CBL Sample_t, float columns with FLOAT32. 
+ * 19-Oct-26 CBL fKey, the file's day since 1970. 
+ * 19-Oct-26 CBL What float does to the field, corrected. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __ROWBLOCK_hh_
+#define __ROWBLOCK_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <vector>
+
+#ifdef FLOAT32
+typedef float  Sample_t;
+#else
+typedef double Sample_t;
+#endif
+
+struct RowBlock
+{
+    /// Column numbers. Same order as the IMUTuple.
+    enum {kTime=0, kAX, kAY, kAZ, kGX, kGY, kGZ, kMX, kMY, kMZ, kTemp, 
+	  kLat, kLon, kAlt, kUTC, kJD, kDSEC, 
+	  kNTupleCol,                  // Number of columns in IMUTuple
+	  kMAG = kNTupleCol,           // |M|
+	  kFILT,                       // Filtered |M|
+	  kREJ,                        // 1 if the despiker replaced it
+	  kMXL, kMYL, kMZL,            // Tilt compensated, level frame
+	  kH, kD, kI,                  // Horizontal, declination, inclination
+	  kTDOT,                       // dTemp/dt
+	  kFILL,                       // 1 if no sample near the grid time
+	  kNCol};
+    /// Number of columns copied directly from the HDF5 row. 
+    static const uint32_t kNInputCol = kUTC + 1;
+
+    size_t   fN;         // Rows in use. 0 marks end of stream. 
+    size_t   fFirst;     // Row number in the file of the first row
+    uint32_t fFile;      // File count
+    double   fDay;       // Day of year for the file. 
+    int32_t  fKey;       // Days since 1970 of the file, -1 unknown
+    bool     fSeconds;   // UTC already in seconds of the day
+    std::vector<Sample_t> fCol[kNCol];   // Sample columns
+    std::vector<double>   fTime[kNCol];  // Time columns, IsTime
+
+    RowBlock(void) : fN(0), fFirst(0), fFile(0), fDay(0.0), fKey(-1),
+		     fSeconds(false) {};
+
+    /// Columns kept in fTime, double whatever Sample_t is. 
+    static inline bool IsTime(uint32_t c)
+	{return (c == kTime) || ((c >= kUTC) && (c <= kDSEC));};
+
+    /// Set the number of rows the block can hold. 
+    inline void Resize(size_t Rows) 
+	{for (uint32_t i=0;i<kNCol;i++) 
+	    {if (IsTime(i)) fTime[i].resize(Rows); else fCol[i].resize(Rows);}};
+    inline size_t Capacity(void) const {return fTime[kUTC].size();};
+    inline Sample_t *Col(uint32_t c) {return fCol[c].data();};
+    inline const Sample_t *Col(uint32_t c) const {return fCol[c].data();};
+    inline double *Time(uint32_t c) {return fTime[c].data();};
+    inline const double *Time(uint32_t c) const {return fTime[c].data();};
+
+    /// Any column as a double. 
+    inline double Get(uint32_t c, size_t i) const
+	{return IsTime(c) ? fTime[c][i] : (double) fCol[c][i];};
+    inline void Set(uint32_t c, size_t i, double v)
+	{if (IsTime(c)) fTime[c][i] = v; else fCol[c][i] = (Sample_t) v;};
+
+    /// Gather row i of the ntuple columns. 
+    inline void Row(size_t i, double *row) const
+	{for (uint32_t c=0;c<kNTupleCol;c++) row[c] = Get(c, i);};
+};
+#endif
@@ -0,0 +1,90 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SPSCQueue.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Bounded single producer, single consumer lock free 
+ * ring. Used to pass RowBlock pointers between pipeline stages. 
+ * The producer waits when the ring is full, which is what gives 
+ * back-pressure between stages. 
+ *
+ * Restrictions/Limitations : Exactly one thread may Push and one
+ * thread may Pop. 
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SPSCQUEUE_hh_
+#define __SPSCQUEUE_hh_
+#  include <stddef.h>
+#  include <atomic>
+#  include <vector>
+#  include <thread>
+#  include <chrono>
+
+template <class T> class SPSCQueue
+{
+public:
+    /// Size is rounded up to a power of two. 
+    SPSCQueue(size_t Size) : fHead(0), fTail(0)
+    {
+	size_t n = 2;
+	while (n < Size) n <<= 1;
+	fRing.resize(n);
+	fMask = n - 1;
+    };
+
+    /// Returns false if the ring is full. 
+    inline bool Push(const T &v)
+    {
+	size_t tail = fTail.load(std::memory_order_relaxed);
+	if (tail - fHead.load(std::memory_order_acquire) > fMask) 
+	    return false;
+	fRing[tail & fMask] = v;
+	fTail.store(tail+1, std::memory_order_release);
+	return true;
+    };
+    /// Returns false if the ring is empty. 
+    inline bool Pop(T &v)
+    {
+	size_t head = fHead.load(std::memory_order_relaxed);
+	if (head == fTail.load(std::memory_order_acquire)) 
+	    return false;
+	v = fRing[head & fMask];
+	fHead.store(head+1, std::memory_order_release);
+	return true;
+    };
+    /// Spin, yield and then sleep until there is room. 
+    inline void PushWait(const T &v)
+    {
+	for (unsigned n=0; !Push(v); n++) Backoff(n);
+    };
+    /// Spin, yield and then sleep until there is something to take. 
+    inline void PopWait(T &v)
+    {
+	for (unsigned n=0; !Pop(v); n++) Backoff(n);
+    };
+
+private:
+    std::vector<T> fRing;
+    size_t         fMask;
+    /// Consumer and producer indices on their own cache lines. 
+    alignas(64) std::atomic<size_t> fHead;
+    alignas(64) std::atomic<size_t> fTail;
+
+    static inline void Backoff(unsigned n)
+    {
+	if (n > 1024) 
+	    std::this_thread::sleep_for(std::chrono::microseconds(50));
+	else if (n > 64) 
+	    std::this_thread::yield();
+    };
+};
+#endif
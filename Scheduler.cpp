@@ -0,0 +1,273 @@
+/********************************************************************
+ *
+ * Module Name : Scheduler.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Work stealing over row range tasks. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Tasks in sequence order, not a contiguous run each.
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+
+// Local Includes.
+#include "debug.h"
+#include "Scheduler.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Scheduler constructor
+ *
+ * Description : 
+ *
+ * Inputs : NWorkers - worker threads
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Scheduler::Scheduler(uint32_t NWorkers) : fRemaining(0), fSteals(0), 
+					  fRun(true)
+{
+    if (NWorkers == 0) NWorkers = 1;
+    for (uint32_t i=0; i<NWorkers; i++)
+    {
+	fQueue.push_back(new WorkQueue);
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Scheduler destructor
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Scheduler::~Scheduler(void)
+{
+    Stop();
+    Join();
+    for (size_t i=0; i<fQueue.size(); i++) delete fQueue[i];
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : AddFile
+ *
+ * Description : Even split, so a file of 1.1 TaskRows does not
+ *               leave a tiny task at the end. 
+ *
+ * Inputs : File     - manifest entry
+ *          NRows    - rows in the file
+ *          TaskRows - largest task
+ *
+ * Returns : number of tasks made
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t Scheduler::AddFile(uint32_t File, size_t NRows, size_t TaskRows)
+{
+    Task     t;
+    uint32_t n;
+
+    if (NRows == 0) return 0;
+    if (TaskRows == 0) TaskRows = NRows;
+    n = (NRows + TaskRows - 1)/TaskRows;
+
+    t.fFile = File;
+    for (uint32_t i=0; i<n; i++)
+    {
+	t.fSeq       = fTasks.size();
+	t.fFirst     = (NRows * i)/n;
+	t.fLast      = (NRows * (i+1))/n;
+	t.fEndOfFile = (i == n-1);
+	fTasks.push_back(t);
+    }
+    return n;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Start
+ *
+ * Description : Task i to worker i mod NWorkers, then start them.
+ *               The results are merged in sequence with only a few
+ *               held per worker, so the workers have to move along
+ *               the sequence together. A contiguous run each had 
+ *               all but the first worker waiting on the merge. 
+ *
+ * Inputs : Work - called for each task
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Scheduler::Start(std::function<void(uint32_t, const Task&)> Work)
+{
+    SET_DEBUG_STACK;
+    const uint32_t NW = fQueue.size();
+
+    for (size_t i=0; i<fTasks.size(); i++)
+    {
+	fQueue[i % NW]->fTasks.push_back(fTasks[i]);
+    }
+    fRemaining = fTasks.size();
+
+    for (uint32_t i=0; i<NW; i++)
+    {
+	fWorker.push_back(std::thread([this, i, Work]()
+	{
+	    Task t;
+	    while (fRun && Next(i, t))
+	    {
+		Work(i, t);
+	    }
+	}));
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Join
+ *
+ * Description : Wait for all the workers to finish. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Scheduler::Join(void)
+{
+    for (size_t i=0; i<fWorker.size(); i++)
+    {
+	if (fWorker[i].joinable()) fWorker[i].join();
+    }
+    fWorker.clear();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Next
+ *
+ * Description : Front of our own queue. Failing that, the front 
+ *               of the queue with the lowest sequence number there,
+ *               the next the merge needs. Each queue is looked at 
+ *               under its own lock, so the front is checked again 
+ *               when it is taken. 
+ *
+ * Inputs : Worker - our queue
+ *          t      - task returned
+ *
+ * Returns : false when there is no work left
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool Scheduler::Next(uint32_t Worker, Task &t)
+{
+    WorkQueue *q = fQueue[Worker];
+    {
+	std::lock_guard<std::mutex> Lock(q->fLock);
+	if (!q->fTasks.empty())
+	{
+	    t = q->fTasks.front();
+	    q->fTasks.pop_front();
+	    fRemaining--;
+	    return true;
+	}
+    }
+
+    while (fRemaining > 0)
+    {
+	uint32_t Victim = Worker;
+	uint64_t Lowest = UINT64_MAX;
+	for (uint32_t i=0; i<fQueue.size(); i++)
+	{
+	    if (i == Worker) continue;
+	    std::lock_guard<std::mutex> Lock(fQueue[i]->fLock);
+	    if (!fQueue[i]->fTasks.empty() && 
+		(fQueue[i]->fTasks.front().fSeq < Lowest))
+	    {
+		Lowest = fQueue[i]->fTasks.front().fSeq;
+		Victim = i;
+	    }
+	}
+	if (Victim == Worker) 
+	{
+	    // Last tasks are being taken, look again.
+	    std::this_thread::yield();
+	    continue;
+	}
+	q = fQueue[Victim];
+	std::lock_guard<std::mutex> Lock(q->fLock);
+	if (!q->fTasks.empty())
+	{
+	    t = q->fTasks.front();
+	    q->fTasks.pop_front();
+	    fRemaining--;
+	    fSteals++;
+	    return true;
+	}
+    }
+    return false;
+}
@@ -0,0 +1,91 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Scheduler.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Work stealing over row range tasks. Files are cut
+ * into tasks of at most TaskRows rows and numbered in the order 
+ * the results have to be merged. The tasks are dealt round robin,
+ * so the workers go through the sequence together, and each takes 
+ * from the front of its own queue. A worker with nothing left 
+ * steals the front of the queue holding the lowest sequence number,
+ * the task the merge will want soonest. The merge only holds a few
+ * results per worker, a task far ahead of it would have to wait. 
+ *
+ * Restrictions/Limitations : Tasks are all added before Start.
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Round robin deal, steal the lowest sequence. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __SCHEDULER_hh_
+#define __SCHEDULER_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <deque>
+#  include <vector>
+#  include <mutex>
+#  include <atomic>
+#  include <thread>
+#  include <functional>
+
+/// Rows [fFirst, fLast) of one file. 
+struct Task
+{
+    uint64_t fSeq;       // Merge order
+    uint32_t fFile;      // Manifest entry
+    size_t   fFirst;
+    size_t   fLast;
+    bool     fEndOfFile; // Last task of the file
+    inline size_t Rows(void) const {return fLast - fFirst;};
+};
+
+class Scheduler
+{
+public:
+    Scheduler(uint32_t NWorkers);
+    ~Scheduler(void);
+
+    /*!
+     * Cut rows [0, NRows) of a file into tasks and queue them. 
+     * Returns the number of tasks. 
+     */
+    uint32_t AddFile(uint32_t File, size_t NRows, size_t TaskRows);
+
+    /*!
+     * Deal the tasks out round robin and start the workers. Work is
+     * called on a worker thread for each task. 
+     */
+    void     Start(std::function<void(uint32_t Worker, const Task&)> Work);
+    /// Workers finish the task in hand and take no more. 
+    inline void Stop(void) {fRun = false;};
+    /// Wait for the workers. 
+    void     Join(void);
+
+    inline uint32_t NWorkers(void) const {return fQueue.size();};
+    inline uint64_t NTasks(void)   const {return fTasks.size();};
+    inline uint64_t Steals(void)   const {return fSteals;};
+
+private:
+    struct WorkQueue
+    {
+	std::mutex          fLock;
+	std::deque<Task>    fTasks;
+    };
+    std::vector<Task>        fTasks;   // Before Start
+    std::vector<WorkQueue*>  fQueue;
+    std::vector<std::thread> fWorker;
+    std::atomic<uint64_t>    fRemaining;
+    std::atomic<uint64_t>    fSteals;
+    std::atomic<bool>        fRun;
+
+    bool Next(uint32_t Worker, Task &t);
+};
+#endif
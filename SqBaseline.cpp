@@ -0,0 +1,516 @@
+/********************************************************************
+ *
+ * Module Name : SqBaseline.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Solar quiet baseline from the quietest days. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Pack and Unpack. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <string>
+#include <cstdio>
+#include <algorithm>
+
+// CERN root includes 
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TString.h>
+#include <TParameter.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "SqBaseline.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : SqBaseline constructor
+ *
+ * Description : 
+ *
+ * Inputs : CacheFile - root file for the days
+ *          NBin      - time bins per day
+ *          NQuiet    - quiet days per baseline
+ *          Window    - days looked back over
+ *          Coverage  - fraction of bins needed to be a quiet day
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+SqBaseline::SqBaseline(const char *CacheFile, uint32_t NBin, uint32_t NQuiet,
+		       uint32_t Window, double Coverage)
+{
+    fFilename = CacheFile;
+    fNBin     = (NBin >= 8) ? NBin : 8;
+    fNQuiet   = (NQuiet > 0) ? NQuiet : 1;
+    fWindow   = (Window >= fNQuiet) ? Window : fNQuiet;
+    fCoverage = Coverage;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Read
+ *
+ * Description : Load the days from the cache file. 
+ *
+ * Inputs : none
+ *
+ * Returns : true if the cache was loaded
+ *
+ * Error Conditions : no cache, or NBin does not match, start empty
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SqBaseline::Read(void)
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    TDirectory *Save = gDirectory;
+    Int_t    Key, Doy;
+    Double_t Act;
+    vector<double> SumMag(fNBin), SumZ(fNBin), Count(fNBin);
+    vector<double> BaseMag(fNBin), BaseZ(fNBin);
+
+    fDays.clear();
+    TFile *f = TFile::Open(fFilename.c_str());
+    Save->cd();
+    if ((f == NULL) || f->IsZombie())
+    {
+	pLogger->Log("# No Sq cache %s, starting empty.\n", fFilename.c_str());
+	delete f;
+	return false;
+    }
+    TParameter<Long64_t> *NB = (TParameter<Long64_t> *) f->Get("NBin");
+    TTree *T = (TTree *) f->Get("SqDays");
+    if ((NB == NULL) || (T == NULL) || (NB->GetVal() != (Long64_t) fNBin))
+    {
+	pLogger->Log("# Sq cache %s does not match, starting empty.\n", 
+		     fFilename.c_str());
+	f->Close();
+	delete f;
+	Save->cd();
+	return false;
+    }
+    T->SetBranchAddress("Key"     , &Key);
+    T->SetBranchAddress("Doy"     , &Doy);
+    T->SetBranchAddress("Activity", &Act);
+    T->SetBranchAddress("SumMag"  , SumMag.data());
+    T->SetBranchAddress("SumZ"    , SumZ.data());
+    T->SetBranchAddress("Count"   , Count.data());
+    T->SetBranchAddress("BaseMag" , BaseMag.data());
+    T->SetBranchAddress("BaseZ"   , BaseZ.data());
+    for (Long64_t i=0; i<T->GetEntries(); i++)
+    {
+	T->GetEntry(i);
+	Day &D      = fDays[Key];
+	D.fKey      = Key;
+	D.fDoy      = Doy;
+	D.fActivity = Act;
+	D.fSumMag   = SumMag;
+	D.fSumZ     = SumZ;
+	D.fCount    = Count;
+	D.fBaseMag  = BaseMag;
+	D.fBaseZ    = BaseZ;
+	D.fHasBase  = true;
+    }
+    f->Close();
+    delete f;
+    Save->cd();
+    pLogger->LogTime("Sq cache %s, %d days.\n", fFilename.c_str(), 
+		     (int) fDays.size());
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Write
+ *
+ * Description : Write to Filename.tmp then rename, like the 
+ *               checkpoint. 
+ *
+ * Inputs : none
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : file can not be created or renamed
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SqBaseline::Write(void) const
+{
+    SET_DEBUG_STACK;
+    CLogger *pLogger = CLogger::GetThis();
+    string   Tmp     = fFilename + ".tmp";
+    TDirectory *Save = gDirectory;
+    Int_t    Key, Doy;
+    Double_t Act;
+    vector<double> SumMag(fNBin), SumZ(fNBin), Count(fNBin);
+    vector<double> BaseMag(fNBin), BaseZ(fNBin);
+
+    TFile *f = new TFile(Tmp.c_str(), "RECREATE", "Sq baseline days");
+    if (f->IsZombie())
+    {
+	pLogger->Log("# Could not create Sq cache %s\n", Tmp.c_str());
+	delete f;
+	Save->cd();
+	return false;
+    }
+    TParameter<Long64_t> NB("NBin", fNBin);
+    TTree *T = new TTree("SqDays", "Sq baseline days");
+    T->Branch("Key"     , &Key, "Key/I");
+    T->Branch("Doy"     , &Doy, "Doy/I");
+    T->Branch("Activity", &Act, "Activity/D");
+    T->Branch("SumMag"  , SumMag.data() , Form("SumMag[%d]/D" , fNBin));
+    T->Branch("SumZ"    , SumZ.data()   , Form("SumZ[%d]/D"   , fNBin));
+    T->Branch("Count"   , Count.data()  , Form("Count[%d]/D"  , fNBin));
+    T->Branch("BaseMag" , BaseMag.data(), Form("BaseMag[%d]/D", fNBin));
+    T->Branch("BaseZ"   , BaseZ.data()  , Form("BaseZ[%d]/D"  , fNBin));
+    for (map<int32_t, Day>::const_iterator it=fDays.begin(); 
+	 it!=fDays.end(); it++)
+    {
+	const Day &D = it->second;
+	Key = D.fKey;
+	Doy = D.fDoy;
+	Act = D.fActivity;
+	std::copy(D.fSumMag.begin(),  D.fSumMag.end(),  SumMag.begin());
+	std::copy(D.fSumZ.begin(),    D.fSumZ.end(),    SumZ.begin());
+	std::copy(D.fCount.begin(),   D.fCount.end(),   Count.begin());
+	std::copy(D.fBaseMag.begin(), D.fBaseMag.end(), BaseMag.begin());
+	std::copy(D.fBaseZ.begin(),   D.fBaseZ.end(),   BaseZ.begin());
+	T->Fill();
+    }
+    f->WriteTObject(&NB);
+    T->Write();
+    f->Close();
+    delete f;     // Deletes T with it. 
+    Save->cd();
+
+    if (rename(Tmp.c_str(), fFilename.c_str()) != 0)
+    {
+	pLogger->Log("# Could not rename Sq cache %s\n", Tmp.c_str());
+	return false;
+    }
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : Sums for a day, then the baselines that can change
+ *               with it. 
+ *
+ * Inputs : Key          - days since 1970
+ *          Doy          - day in year
+ *          SumMag, SumZ - NBin sums
+ *          Count        - NBin sample counts
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SqBaseline::Add(int32_t Key, int32_t Doy, const double *SumMag, 
+		     const double *SumZ, const double *Count)
+{
+    SET_DEBUG_STACK;
+    Day &D = fDays[Key];
+
+    if (fTouched.insert(Key).second)
+    {
+	// First time this run, drop what the cache had. 
+	D.fKey = Key;
+	D.fDoy = Doy;
+	D.fSumMag.assign(fNBin, 0.0);
+	D.fSumZ.assign(fNBin, 0.0);
+	D.fCount.assign(fNBin, 0.0);
+	D.fBaseMag.assign(fNBin, 0.0);
+	D.fBaseZ.assign(fNBin, 0.0);
+	D.fHasBase = false;
+    }
+    for (uint32_t i=0; i<fNBin; i++)
+    {
+	D.fSumMag[i] += SumMag[i];
+	D.fSumZ[i]   += SumZ[i];
+	D.fCount[i]  += Count[i];
+    }
+    Activity(D);
+
+    map<int32_t, Day>::iterator it  = fDays.find(Key);
+    map<int32_t, Day>::iterator End = fDays.lower_bound(Key + fWindow);
+    for (; it != End; it++)
+    {
+	Update(it->second);
+    }
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Pack
+ *
+ * Description : Number of days, then for each added this run its 
+ *               key, day in year and the NBin sums and counts. 
+ *
+ * Inputs : v - appended to
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SqBaseline::Pack(vector<double> &v) const
+{
+    v.push_back(fTouched.size());
+    for (set<int32_t>::const_iterator it=fTouched.begin(); 
+	 it!=fTouched.end(); it++)
+    {
+	const Day &D = fDays.find(*it)->second;
+	v.push_back(D.fKey);
+	v.push_back(D.fDoy);
+	v.insert(v.end(), D.fSumMag.begin(), D.fSumMag.end());
+	v.insert(v.end(), D.fSumZ.begin(), D.fSumZ.end());
+	v.insert(v.end(), D.fCount.begin(), D.fCount.end());
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Unpack
+ *
+ * Description : Days from Pack replace those held, then the 
+ *               baselines that can change with them are remade. 
+ *
+ * Inputs : p   - packed data, advanced past it
+ *          End - end of the data
+ *
+ * Returns : false if the data ran out
+ *
+ * Error Conditions : short data, the days before it are kept
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool SqBaseline::Unpack(const double *&p, const double *End)
+{
+    SET_DEBUG_STACK;
+    size_t  N;
+    int32_t Key;
+    bool    rc = true;
+
+    if (p >= End) return false;
+    N = (size_t) *p++;
+    for (size_t i=0; i<N; i++)
+    {
+	if (p + 2 + 3*fNBin > End)
+	{
+	    rc = false;
+	    break;
+	}
+	Key = (int32_t) p[0];
+	Day &D = fDays[Key];
+	D.fKey = Key;
+	D.fDoy = (int32_t) p[1];
+	p += 2;
+	D.fSumMag.assign(p, p + fNBin); p += fNBin;
+	D.fSumZ.assign(p, p + fNBin);   p += fNBin;
+	D.fCount.assign(p, p + fNBin);  p += fNBin;
+	D.fBaseMag.assign(fNBin, 0.0);
+	D.fBaseZ.assign(fNBin, 0.0);
+	D.fHasBase = false;
+	Activity(D);
+	fTouched.insert(Key);
+    }
+    // Baselines look back, remake from the first day put back on. 
+    if (fTouched.size() > 0)
+    {
+	map<int32_t, Day>::iterator it = fDays.find(*fTouched.begin());
+	for (; it != fDays.end(); it++) Update(it->second);
+    }
+    SET_DEBUG_STACK;
+    return rc;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Find
+ *
+ * Description : 
+ *
+ * Inputs : Key - days since 1970
+ *
+ * Returns : the day or NULL
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+const SqBaseline::Day* SqBaseline::Find(int32_t Key) const
+{
+    map<int32_t, Day>::const_iterator it = fDays.find(Key);
+    return (it == fDays.end()) ? NULL : &it->second;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Activity
+ *
+ * Description : Sum over the eight 3 hour intervals of the range 
+ *               of the Z bin means. Too few bins with data and the
+ *               day is not a candidate. 
+ *
+ * Inputs : D - day
+ *
+ * Returns : none, fActivity set
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SqBaseline::Activity(Day &D) const
+{
+    const uint32_t Per = fNBin/8;
+    uint32_t NGood = 0;
+    double   Sum   = 0.0;
+    double   Lo, Hi, Z;
+
+    for (uint32_t k=0; k<8; k++)
+    {
+	Lo =  1.0e300;
+	Hi = -1.0e300;
+	for (uint32_t i=k*Per; i<(k+1)*Per; i++)
+	{
+	    if (D.fCount[i] <= 0.0) continue;
+	    NGood++;
+	    Z  = D.fSumZ[i]/D.fCount[i];
+	    Lo = std::min(Lo, Z);
+	    Hi = std::max(Hi, Z);
+	}
+	if (Hi >= Lo) Sum += Hi - Lo;
+    }
+    D.fActivity = (NGood >= fCoverage * 8 * Per) ? Sum : -1.0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Update
+ *
+ * Description : Baseline of D, per bin median of the bin means of 
+ *               the NQuiet least active days in the Window days 
+ *               ending on D. 
+ *
+ * Inputs : D - day
+ *
+ * Returns : none
+ *
+ * Error Conditions : no quiet day in the window, fHasBase false
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void SqBaseline::Update(Day &D)
+{
+    vector<pair<double, const Day*> > Cand;
+    vector<double> M, Z;
+
+    map<int32_t, Day>::const_iterator it  = 
+	fDays.lower_bound(D.fKey - (int32_t) fWindow + 1);
+    map<int32_t, Day>::const_iterator End = fDays.upper_bound(D.fKey);
+    for (; it != End; it++)
+    {
+	if (it->second.fActivity >= 0.0)
+	{
+	    Cand.push_back(make_pair(it->second.fActivity, &it->second));
+	}
+    }
+    D.fHasBase = !Cand.empty();
+    if (Cand.size() > fNQuiet)
+    {
+	std::nth_element(Cand.begin(), Cand.begin() + fNQuiet, Cand.end());
+	Cand.resize(fNQuiet);
+    }
+    for (uint32_t i=0; i<fNBin; i++)
+    {
+	M.clear();
+	Z.clear();
+	for (size_t j=0; j<Cand.size(); j++)
+	{
+	    const Day *Q = Cand[j].second;
+	    if (Q->fCount[i] > 0.0)
+	    {
+		M.push_back(Q->fSumMag[i]/Q->fCount[i]);
+		Z.push_back(Q->fSumZ[i]/Q->fCount[i]);
+	    }
+	}
+	D.fBaseMag[i] = D.fBaseZ[i] = 0.0;
+	if (M.empty()) continue;
+	std::nth_element(M.begin(), M.begin() + M.size()/2, M.end());
+	std::nth_element(Z.begin(), Z.begin() + Z.size()/2, Z.end());
+	D.fBaseMag[i] = M[M.size()/2];
+	D.fBaseZ[i]   = Z[Z.size()/2];
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : SqBaseline.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Solar quiet (Sq) baseline. Each day is kept as 
+ * sums and counts of |M| and Z per time bin with an activity 
+ * number, the sum over 3 hour intervals of the range of Z, the 
+ * same intervals as the K index. The baseline of a day is the 
+ * median per time bin of the NQuiet least active days in the 
+ * Window days that end on it. It only looks back, so a new day 
+ * costs one median over at most Window days and the baselines 
+ * already made do not change. Days and baselines are cached in a
+ * small root file between runs. 
+ *
+ * Restrictions/Limitations : A day that is added again replaces 
+ * the cached one, and the baselines of the Window days after it 
+ * are remade. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Pack and Unpack of the days added, for checkpoints. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ * Mayaud, "Derivation, Meaning and Use of Geomagnetic Indices", 
+ * AGU Monograph 22, 1980. Quiet day selection. 
+ *
+ *******************************************************************
+ */
+#ifndef __SQBASELINE_hh_
+#define __SQBASELINE_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <string>
+#  include <vector>
+#  include <map>
+#  include <set>
+
+class SqBaseline {
+public:
+    /// One day, sums over the time bins and its baseline.
+    struct Day {
+	int32_t  fKey;       // Days since 1970
+	int32_t  fDoy;       // Day in year, 0-365
+	double   fActivity;  // Sum of 3 hour Z ranges, -1 too little data
+	std::vector<double> fSumMag, fSumZ, fCount;
+	std::vector<double> fBaseMag, fBaseZ;   // 0 where unknown
+	bool     fHasBase;
+    };
+
+    /*!
+     * CacheFile - root file the days are kept in
+     * NBin      - time bins per day
+     * NQuiet    - quiet days per baseline
+     * Window    - days looked back over, including the day
+     * Coverage  - fraction of bins with data to be a quiet day
+     */
+    SqBaseline(const char *CacheFile, uint32_t NBin, uint32_t NQuiet=5, 
+	       uint32_t Window=27, double Coverage=0.8);
+
+    /*!
+     * Description: 
+     *   Load the cache. Missing or made with another NBin is not 
+     *   an error, it starts empty. 
+     */
+    bool Read(void);
+    /*!
+     * Description: 
+     *   Write the cache, under a temporary name then renamed. 
+     */
+    bool Write(void) const;
+
+    /*!
+     * Description: 
+     *   Add sums for a day. The first Add of a day in this run 
+     *   replaces a cached copy, later ones add to it, so a day 
+     *   split across files or checkpoints comes out whole. The 
+     *   baselines of the day and the Window days after it are 
+     *   remade. 
+     *
+     * Arguments:
+     *   Key, Doy       - days since 1970 and day in year
+     *   SumMag, SumZ   - NBin sums
+     *   Count          - NBin samples
+     */
+    void Add(int32_t Key, int32_t Doy, const double *SumMag, 
+	     const double *SumZ, const double *Count);
+
+    /*!
+     * Description: 
+     *   The days added this run, for a checkpoint, and back on 
+     *   resume. Unpack puts them as they were at the checkpoint 
+     *   whatever the cache has since, and marks them added so the
+     *   rest of a day cut by the checkpoint adds to them. 
+     */
+    void Pack(std::vector<double> &v) const;
+    bool Unpack(const double *&p, const double *End);
+    /// Days added this run, by key.
+    inline const std::set<int32_t>& Touched(void) const {return fTouched;};
+    /// Day by key, NULL if not held. 
+    const Day* Find(int32_t Key) const;
+    inline size_t Size(void) const {return fDays.size();};
+
+private:
+    void   Activity(Day &D) const;
+    void   Update(Day &D);
+
+    std::string fFilename;
+    uint32_t    fNBin;
+    uint32_t    fNQuiet;
+    uint32_t    fWindow;
+    double      fCoverage;
+    std::map<int32_t, Day> fDays;
+    std::set<int32_t>      fTouched;
+};
+#endif
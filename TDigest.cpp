@@ -0,0 +1,334 @@
+/********************************************************************
+ *
+ * Module Name : TDigest.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Merging t-digest. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <cmath>
+#include <limits>
+#include <algorithm>
+using namespace std;
+
+// Local Includes.
+#include "TDigest.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : TDigest constructor
+ *
+ * Description : No memory is taken until the first Add. 
+ *
+ * Inputs : Compression - delta, larger is more accurate
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+TDigest::TDigest(double Compression)
+{
+    fCompression = (Compression > 10.0) ? Compression : 10.0;
+    fTotal       = 0.0;
+    fBufWeight   = 0.0;
+    fMin         =  numeric_limits<double>::infinity();
+    fMax         = -numeric_limits<double>::infinity();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : Buffer the sample, compress when the buffer is 
+ *               full. 
+ *
+ * Inputs : x - sample
+ *          w - weight
+ *
+ * Returns : none
+ *
+ * Error Conditions : NaN samples are dropped
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TDigest::Add(double x, double w)
+{
+    if (std::isnan(x) || (w <= 0.0)) return;
+    const size_t BufSize = (size_t) (4.0*fCompression);
+    if (fBuf.capacity() == 0)
+    {
+	fBuf.reserve(BufSize);
+	fC.reserve((size_t) (2.0*fCompression) + 1);
+    }
+    Centroid c = {x, w};
+    fBuf.push_back(c);
+    fBufWeight += w;
+    if (x < fMin) fMin = x;
+    if (x > fMax) fMax = x;
+    if (fBuf.size() >= BufSize) Compress();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Merge
+ *
+ * Description : The other digest's centroids are added as samples
+ *               with their weights. 
+ *
+ * Inputs : d - digest to add
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TDigest::Merge(const TDigest &d)
+{
+    for (size_t i=0; i<d.fC.size(); i++)   Add(d.fC[i].fMean, d.fC[i].fWeight);
+    for (size_t i=0; i<d.fBuf.size(); i++) Add(d.fBuf[i].fMean, d.fBuf[i].fWeight);
+    if (d.fMin < fMin) fMin = d.fMin;
+    if (d.fMax > fMax) fMax = d.fMax;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Compress
+ *
+ * Description : Sort buffer and centroids together and merge 
+ *               neighbours while the result stays under the size
+ *               limit, k1 scale function:
+ *                  k(q) = delta/(2 pi) asin(2q - 1)
+ *               a centroid may span at most one unit of k. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TDigest::Compress(void)
+{
+    if (fBuf.empty()) return;
+    const double Scale = fCompression/(2.0*M_PI);
+    vector<Centroid> All;
+    All.reserve(fC.size() + fBuf.size());
+    All.insert(All.end(), fC.begin(), fC.end());
+    All.insert(All.end(), fBuf.begin(), fBuf.end());
+    sort(All.begin(), All.end());
+
+    const double Total = fTotal + fBufWeight;
+    double   SoFar = 0.0;
+    double   QLimit;
+    Centroid Cur = All[0];
+
+    QLimit = Total * (sin((Scale*asin(-1.0) + 1.0)/Scale) + 1.0)/2.0;
+    fC.clear();
+    for (size_t i=1; i<All.size(); i++)
+    {
+	if (SoFar + Cur.fWeight + All[i].fWeight <= QLimit)
+	{
+	    // Weighted mean, the form that does not lose precision.
+	    Cur.fWeight += All[i].fWeight;
+	    Cur.fMean   += (All[i].fMean - Cur.fMean)*All[i].fWeight/Cur.fWeight;
+	}
+	else
+	{
+	    SoFar += Cur.fWeight;
+	    fC.push_back(Cur);
+	    double k = Scale*asin(2.0*min(SoFar/Total, 1.0) - 1.0);
+	    QLimit = Total * (sin(min((k + 1.0)/Scale, M_PI/2.0)) + 1.0)/2.0;
+	    Cur = All[i];
+	}
+    }
+    fC.push_back(Cur);
+    fTotal     = Total;
+    fBuf.clear();
+    fBufWeight = 0.0;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Quantile
+ *
+ * Description : Each centroid's weight is taken as spread half 
+ *               either side of its mean, interpolate between 
+ *               centroid means, and to min/max at the ends. 
+ *
+ * Inputs : q - quantile, 0 to 1
+ *
+ * Returns : value
+ *
+ * Error Conditions : NaN if empty
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+double TDigest::Quantile(double q)
+{
+    Compress();
+    if (fC.empty()) return numeric_limits<double>::quiet_NaN();
+    if (fC.size() == 1) return fC[0].fMean;
+    if (q <= 0.0) return fMin;
+    if (q >= 1.0) return fMax;
+
+    const double Target = q * fTotal;
+    double Left = 0.0;      // Weight before the current centroid
+    double Mid, NextMid;
+
+    // Before the first centroid's middle. 
+    Mid = fC[0].fWeight/2.0;
+    if (Target < Mid)
+    {
+	return fMin + (fC[0].fMean - fMin)*Target/Mid;
+    }
+    for (size_t i=0; i<fC.size()-1; i++)
+    {
+	NextMid = Left + fC[i].fWeight + fC[i+1].fWeight/2.0;
+	if (Target < NextMid)
+	{
+	    return fC[i].fMean + (fC[i+1].fMean - fC[i].fMean) * 
+		(Target - Mid)/(NextMid - Mid);
+	}
+	Left += fC[i].fWeight;
+	Mid   = NextMid;
+    }
+    // Past the last centroid's middle. 
+    const Centroid &L = fC.back();
+    return L.fMean + (fMax - L.fMean)*(Target - Mid)/(fTotal - Mid);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Clear
+ *
+ * Description : Empty, keeps the memory. 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TDigest::Clear(void)
+{
+    fC.clear();
+    fBuf.clear();
+    fTotal     = 0.0;
+    fBufWeight = 0.0;
+    fMin       =  numeric_limits<double>::infinity();
+    fMax       = -numeric_limits<double>::infinity();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Pack
+ *
+ * Description : Append n, min, max then mean,weight pairs. 
+ *
+ * Inputs : v - appended to
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TDigest::Pack(vector<double> &v)
+{
+    Compress();
+    v.push_back((double) fC.size());
+    if (fC.empty()) return;
+    v.push_back(fMin);
+    v.push_back(fMax);
+    for (size_t i=0; i<fC.size(); i++)
+    {
+	v.push_back(fC[i].fMean);
+	v.push_back(fC[i].fWeight);
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Unpack
+ *
+ * Description : Merge a packed digest into this one. 
+ *
+ * Inputs : p   - packed data, advanced past it
+ *          End - end of the data
+ *
+ * Returns : false if the data ran out
+ *
+ * Error Conditions : short data
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool TDigest::Unpack(const double *&p, const double *End)
+{
+    if (p >= End) return false;
+    size_t n = (size_t) *p++;
+    if (n == 0) return true;
+    if (p + 2 + 2*n > End) return false;
+    double Min = *p++;
+    double Max = *p++;
+    for (size_t i=0; i<n; i++, p+=2) Add(p[0], p[1]);
+    if (Min < fMin) fMin = Min;
+    if (Max > fMax) fMax = Max;
+    return true;
+}
@@ -0,0 +1,71 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : TDigest.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Merging t-digest, a streaming quantile sketch. 
+ * Samples go into a small buffer, when it fills the buffer and the
+ * centroids are sorted and merged so that no centroid holds more 
+ * than the scale function allows. Centroids near q=0 and q=1 stay
+ * small, which is what keeps p5 and p95 accurate. Memory is fixed 
+ * by the compression, about 2*Compression centroids plus a buffer
+ * of 4*Compression samples, and is not taken until the first Add. 
+ * Two digests merge by adding one's centroids to the other. 
+ *
+ * Restrictions/Limitations : not thread safe, one digest per thread
+ * then Merge. 
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ * T. Dunning, O. Ertl, "Computing Extremely Accurate Quantiles 
+ * Using t-Digests", 2019. 
+ *
+ *******************************************************************
+ */
+#ifndef __TDIGEST_hh_
+#define __TDIGEST_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <vector>
+
+class TDigest
+{
+public:
+    TDigest(double Compression=100.0);
+
+    /// Add a sample with weight w. 
+    void   Add(double x, double w=1.0);
+    /// Add all of another digest. 
+    void   Merge(const TDigest &d);
+    /// Value at quantile q, 0 to 1. NaN if empty. 
+    double Quantile(double q);
+
+    inline double Count(void) const {return fTotal + fBufWeight;};
+    inline bool   Empty(void) const {return Count() <= 0.0;};
+    void   Clear(void);
+
+    /// Append to v, and read back from p, advanced past it. 
+    void   Pack(std::vector<double> &v);
+    bool   Unpack(const double *&p, const double *End);
+
+private:
+    struct Centroid {
+	double fMean;
+	double fWeight;
+	bool operator<(const Centroid &c) const {return fMean < c.fMean;};
+    };
+    double fCompression;
+    std::vector<Centroid> fC;       // Merged, sorted
+    std::vector<Centroid> fBuf;     // Not yet merged
+    double fTotal;                  // Weight in fC
+    double fBufWeight;              // Weight in fBuf
+    double fMin, fMax;
+
+    void   Compress(void);
+};
+#endif
@@ -0,0 +1,303 @@
+/********************************************************************
+ *
+ * Module Name : TempFit.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Streaming temperature coefficient fit. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <cmath>
+#include <cstring>
+using namespace std;
+
+// Local Includes.
+#include "TempFit.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : TempFit constructor
+ *
+ * Description : 
+ *
+ * Inputs : Rate - fit dT/dt too
+ *          Ref  - reference temperature
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+TempFit::TempFit(bool Rate, double Ref)
+{
+    fRate = Rate;
+    fRef  = Ref;
+    fN    = 0.0;
+    memset(fXX, 0, sizeof(fXX));
+    memset(fXY, 0, sizeof(fXY));
+    memset(fYY, 0, sizeof(fYY));
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Add
+ *
+ * Description : x = (1, T - Ref, dT/dt), sums of x x', x y, y y. 
+ *
+ * Inputs : T, dT      - temperature and rate
+ *          MX, MY, MZ - field
+ *          n          - rows
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TempFit::Add(const Sample_t *T, const Sample_t *dT, 
+		  const Sample_t *MX, const Sample_t *MY, const Sample_t *MZ,
+		  size_t n)
+{
+    double x[kNPar], y[kNAxis];
+
+    for (size_t i=0; i<n; i++)
+    {
+	x[0] = 1.0;
+	x[1] = T[i] - fRef;
+	x[2] = fRate ? dT[i] : 0.0;
+	y[0] = MX[i];
+	y[1] = MY[i];
+	y[2] = MZ[i];
+	if (std::isnan(x[1] + x[2] + y[0] + y[1] + y[2])) continue;
+	fN += 1.0;
+	for (uint32_t j=0; j<kNPar; j++)
+	{
+	    for (uint32_t k=0; k<kNPar; k++) fXX[j][k] += x[j]*x[k];
+	    for (uint32_t a=0; a<kNAxis; a++) fXY[a][j] += x[j]*y[a];
+	}
+	for (uint32_t a=0; a<kNAxis; a++) fYY[a] += y[a]*y[a];
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Merge
+ *
+ * Description : 
+ *
+ * Inputs : f - fit to add
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TempFit::Merge(const TempFit &f)
+{
+    fN += f.fN;
+    for (uint32_t j=0; j<kNPar; j++)
+    {
+	for (uint32_t k=0; k<kNPar; k++) fXX[j][k] += f.fXX[j][k];
+	for (uint32_t a=0; a<kNAxis; a++) fXY[a][j] += f.fXY[a][j];
+    }
+    for (uint32_t a=0; a<kNAxis; a++) fYY[a] += f.fYY[a];
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Solve
+ *
+ * Description : Gauss elimination with partial pivoting on the 2x2
+ *               or 3x3 normal equations, all three axes at once. 
+ *               RMS from y'y - c'X'y. 
+ *
+ * Inputs : Coef - returned
+ *          RMS  - returned if not NULL
+ *
+ * Returns : true on success
+ *
+ * Error Conditions : singular, too few rows
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool TempFit::Solve(double Coef[kNAxis][kNPar], double *RMS) const
+{
+    const uint32_t P = fRate ? 3 : 2;
+    double A[kNPar][kNPar + kNAxis];
+    double t, Piv;
+    uint32_t m;
+
+    memset(Coef, 0, sizeof(double)*kNAxis*kNPar);
+    if (fN < 10.0*P) return false;
+
+    for (uint32_t j=0; j<P; j++)
+    {
+	for (uint32_t k=0; k<P; k++)      A[j][k]   = fXX[j][k];
+	for (uint32_t a=0; a<kNAxis; a++) A[j][P+a] = fXY[a][j];
+    }
+    for (uint32_t c=0; c<P; c++)
+    {
+	m = c;
+	for (uint32_t r=c+1; r<P; r++)
+	{
+	    if (fabs(A[r][c]) > fabs(A[m][c])) m = r;
+	}
+	// Relative to the diagonal, a constant temperature is singular.
+	if (fabs(A[m][c]) <= 1.0e-12 * fabs(fXX[c][c]) || (A[m][c] == 0.0))
+	{
+	    return false;
+	}
+	for (uint32_t k=0; k<P+kNAxis; k++) 
+	{
+	    t = A[c][k]; A[c][k] = A[m][k]; A[m][k] = t;
+	}
+	Piv = A[c][c];
+	for (uint32_t r=0; r<P; r++)
+	{
+	    if (r == c) continue;
+	    t = A[r][c]/Piv;
+	    for (uint32_t k=c; k<P+kNAxis; k++) A[r][k] -= t*A[c][k];
+	}
+    }
+    for (uint32_t a=0; a<kNAxis; a++)
+    {
+	t = fYY[a];
+	for (uint32_t j=0; j<P; j++)
+	{
+	    Coef[a][j] = A[j][P+a]/A[j][j];
+	    t -= Coef[a][j]*fXY[a][j];
+	}
+	if (RMS) RMS[a] = (t > 0.0) ? sqrt(t/fN) : 0.0;
+    }
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Pack
+ *
+ * Description : N, X'X, X'y, y'y. 
+ *
+ * Inputs : v - appended to
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TempFit::Pack(vector<double> &v) const
+{
+    v.push_back(fN);
+    v.insert(v.end(), &fXX[0][0], &fXX[0][0] + kNPar*kNPar);
+    v.insert(v.end(), &fXY[0][0], &fXY[0][0] + kNAxis*kNPar);
+    v.insert(v.end(), fYY, fYY + kNAxis);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Unpack
+ *
+ * Description : Merge packed sums into this fit. 
+ *
+ * Inputs : p   - packed data, advanced past it
+ *          End - end of the data
+ *
+ * Returns : false if the data ran out
+ *
+ * Error Conditions : short data
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool TempFit::Unpack(const double *&p, const double *End)
+{
+    const size_t N = 1 + kNPar*kNPar + kNAxis*kNPar + kNAxis;
+    TempFit f(fRate, fRef);
+
+    if (p + N > End) return false;
+    f.fN = *p++;
+    memcpy(f.fXX, p, sizeof(fXX)); p += kNPar*kNPar;
+    memcpy(f.fXY, p, sizeof(fXY)); p += kNAxis*kNPar;
+    memcpy(f.fYY, p, sizeof(fYY)); p += kNAxis;
+    Merge(f);
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Rate
+ *
+ * Description : Centered difference over +-Span rows, per row, so
+ *               per second at 1 Hz. The temperature is coarsely 
+ *               quantized and a one row difference is mostly 0. 
+ *
+ * Inputs : T    - temperature
+ *          n    - rows
+ *          Span - rows each side
+ *          dT   - returned
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void TempFit::Rate(const Sample_t *T, size_t n, uint32_t Span, 
+		   Sample_t *dT)
+{
+    size_t Lo, Hi;
+
+    for (size_t i=0; i<n; i++)
+    {
+	Lo = (i > Span) ? i - Span : 0;
+	Hi = (i + Span < n) ? i + Span : n - 1;
+	dT[i] = (Hi > Lo) ? (T[Hi] - T[Lo])/(double)(Hi - Lo) : 0.0;
+    }
+}
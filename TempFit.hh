@@ -0,0 +1,95 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : TempFit.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Streaming least squares fit of the temperature 
+ * coefficient of Mx, My, Mz, 
+ *
+ *     M = a + b (T - Ref) [+ c dT/dt]
+ *
+ * Only the normal equations are kept, the sums of x x' and x y 
+ * over the rows, so one pass over any amount of data does, and two
+ * fits over different rows, files or threads merge by adding. The 
+ * dT/dt term is a first order thermal lag made linear, the sensor 
+ * sits at T - tau dT/dt, and needs no state from one block to the 
+ * next. 
+ *
+ * Restrictions/Limitations : dT/dt assumes 1 sample per second. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Sample_t columns, the sums stay double. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __TEMPFIT_hh_
+#define __TEMPFIT_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <vector>
+#  include "RowBlock.hh"
+
+class TempFit
+{
+public:
+    enum {kNAxis=3, kNPar=3};     // Mx, My, Mz; offset, T, dT/dt
+
+    /*!
+     * Rate - fit the dT/dt term too
+     * Ref  - reference temperature
+     */
+    TempFit(bool Rate=false, double Ref=25.0);
+
+    /*!
+     * Description: 
+     *   Add n rows. Rows with a NaN are skipped. 
+     *
+     * Arguments:
+     *   T, dT      - temperature and its rate, dT unused without Rate
+     *   MX, MY, MZ - field
+     */
+    void Add(const Sample_t *T, const Sample_t *dT, const Sample_t *MX, 
+	     const Sample_t *MY, const Sample_t *MZ, size_t n);
+    /// Add all of another fit, made with the same Rate and Ref. 
+    void Merge(const TempFit &f);
+
+    /*!
+     * Description: 
+     *   Solve the normal equations. Coef[axis][par], the dT/dt 
+     *   term 0 without Rate. RMS of the residual per axis. 
+     *
+     * Returns:
+     *   false if there are too few rows or the temperature did 
+     *   not vary
+     */
+    bool Solve(double Coef[kNAxis][kNPar], double *RMS=NULL) const;
+
+    inline double Rows(void) const {return fN;};
+
+    /// Append to v, and merge back from p, advanced past it. 
+    void Pack(std::vector<double> &v) const;
+    bool Unpack(const double *&p, const double *End);
+
+    /*!
+     * Description: 
+     *   dT/dt at each row, difference over +-Span rows, less at the
+     *   ends of the block. 
+     */
+    static void Rate(const Sample_t *T, size_t n, uint32_t Span, 
+		     Sample_t *dT);
+
+private:
+    bool   fRate;
+    double fRef;
+    double fN;
+    double fXX[kNPar][kNPar];
+    double fXY[kNAxis][kNPar];
+    double fYY[kNAxis];
+};
+#endif
@@ -0,0 +1,167 @@
+/********************************************************************
+ *
+ * Module Name : Tilt.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Tilt compensation of the magnetometer. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Block gravity skips non-finite rows, identity when
+ *               there is none. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <cmath>
+using namespace std;
+
+// Local Includes.
+#include "Tilt.hh"
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Level
+ *
+ * Description : With g the gravity direction, 
+ *      sin(roll)  = gy/|gyz|   cos(roll)  = gz/|gyz|
+ *      sin(pitch) = -gx/|g|    cos(pitch) = |gyz|/|g|
+ *      X = mx cp + (my sr + mz cr) sp
+ *      Y = my cr - mz sr
+ *      Z = -mx sp + (my sr + mz cr) cp
+ *   Level and upright is the identity. In block mode rows with a 
+ *   NaN or infinite gravity component are left out of the mean, 
+ *   and a block with no usable gravity, none left or a zero sum, is
+ *   passed through as level. The previous block's rotation is not
+ *   used, scheduler workers share this object. 
+ *
+ * Inputs : AX, AY, AZ - accelerometer
+ *          MX, MY, MZ - magnetometer
+ *          n          - rows
+ *          X, Y, Z    - level frame, returned
+ *
+ * Returns : none
+ *
+ * Error Conditions : zero gravity gives NaN, per sample only
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Tilt::Level(const Sample_t *__restrict AX, 
+		 const Sample_t *__restrict AY, 
+		 const Sample_t *__restrict AZ, 
+		 const Sample_t *__restrict MX, 
+		 const Sample_t *__restrict MY, 
+		 const Sample_t *__restrict MZ,
+		 size_t n, Sample_t *__restrict X, Sample_t *__restrict Y, 
+		 Sample_t *__restrict Z) const
+{
+    // Same type as the columns, so float runs twice as wide. 
+    Sample_t gx, gy, gz, nyz, ng, sr, cr, sp, cp, t;
+
+    if (!fPerSample)
+    {
+	// One rotation for the whole block, summed in double. 
+	double Sx = 0.0, Sy = 0.0, Sz = 0.0, Nyz, Ng;
+	for (size_t i=0; i<n; i++)
+	{
+	    if (!std::isfinite(AX[i]) || !std::isfinite(AY[i]) || 
+		!std::isfinite(AZ[i])) continue;
+	    Sx += AX[i];
+	    Sy += AY[i];
+	    Sz += AZ[i];
+	}
+	Nyz = sqrt(Sy*Sy + Sz*Sz);
+	Ng  = sqrt(Sx*Sx + Sy*Sy + Sz*Sz);
+	// No gravity to go on is taken as level. 
+	sr = 0.0;
+	cr = 1.0;
+	sp = 0.0;
+	cp = 1.0;
+	if ((Ng > 0.0) && std::isfinite(Ng))
+	{
+	    sp = -Sx/Ng;
+	    cp = Nyz/Ng;
+	    // Straight along X, any roll will do. 
+	    if (Nyz > 0.0)
+	    {
+		sr = Sy/Nyz;
+		cr = Sz/Nyz;
+	    }
+	}
+	for (size_t i=0; i<n; i++)
+	{
+	    t    = MY[i]*sr + MZ[i]*cr;
+	    X[i] = MX[i]*cp + t*sp;
+	    Y[i] = MY[i]*cr - MZ[i]*sr;
+	    Z[i] = t*cp - MX[i]*sp;
+	}
+	return;
+    }
+    for (size_t i=0; i<n; i++)
+    {
+	gx   = AX[i];
+	gy   = AY[i];
+	gz   = AZ[i];
+	nyz  = sqrt(gy*gy + gz*gz);
+	ng   = sqrt(gx*gx + gy*gy + gz*gz);
+	sr   = gy/nyz;
+	cr   = gz/nyz;
+	sp   = -gx/ng;
+	cp   = nyz/ng;
+	t    = MY[i]*sr + MZ[i]*cr;
+	X[i] = MX[i]*cp + t*sp;
+	Y[i] = MY[i]*cr - MZ[i]*sr;
+	Z[i] = t*cp - MX[i]*sp;
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : HDI
+ *
+ * Description : H = sqrt(X^2 + Y^2), D = atan2(Y, X), 
+ *               I = atan2(Z, H), angles in degrees. 
+ *
+ * Inputs : X, Y, Z - level frame
+ *          n       - rows
+ *          H, D, I - returned
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void Tilt::HDI(const Sample_t *__restrict X, const Sample_t *__restrict Y, 
+	       const Sample_t *__restrict Z, size_t n, 
+	       Sample_t *__restrict H, Sample_t *__restrict D, 
+	       Sample_t *__restrict I)
+{
+    const Sample_t Deg = 180.0/M_PI;
+
+    for (size_t i=0; i<n; i++)
+    {
+	H[i] = sqrt(X[i]*X[i] + Y[i]*Y[i]);
+    }
+    for (size_t i=0; i<n; i++)
+    {
+	D[i] = atan2(Y[i], X[i]) * Deg;
+	I[i] = atan2(Z[i], H[i]) * Deg;
+    }
+}
@@ -0,0 +1,78 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Tilt.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Tilt compensation. The accelerometer gives the 
+ * direction of gravity, Mx, My, Mz are rotated into a local level
+ * frame with Z along it, then H, D and I are derived. Roll and 
+ * pitch are never formed as angles, their sines and cosines come 
+ * straight from the gravity components, so the rotation loop is 
+ * only multiplies, adds and square roots over whole columns and
+ * the compiler can vectorize it. 
+ *
+ * Gravity is either the mean of the block, which smooths out 
+ * vibration and still follows the slow drift of the mounts, or 
+ * each sample's own. 
+ *
+ * Restrictions/Limitations : D and I use atan2 and are done in a 
+ * second loop. 
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Sample_t columns, float with FLOAT32. The block mean
+ *               gravity is still summed in double. 
+ * 19-Oct-26 CBL Block mean over the finite rows only. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ * Freescale AN4248, "Implementing a Tilt-Compensated eCompass 
+ * using Accelerometer and Magnetometer Sensors". 
+ *
+ *******************************************************************
+ */
+#ifndef __TILT_hh_
+#define __TILT_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include "RowBlock.hh"
+
+class Tilt
+{
+public:
+    /*!
+     * PerSample - gravity from each row, else the block mean
+     */
+    Tilt(bool PerSample=false) : fPerSample(PerSample) {};
+
+    /*!
+     * Description: 
+     *   Rotate n rows of M into the level frame. Per sample, rows
+     *   where gravity is zero come out NaN. Block mode leaves rows 
+     *   with non-finite gravity out of the mean, and a block with 
+     *   no usable gravity is passed through unrotated. 
+     *
+     * Arguments:
+     *   AX, AY, AZ - accelerometer, any units
+     *   MX, MY, MZ - magnetometer
+     *   X, Y, Z    - level frame, returned
+     */
+    void Level(const Sample_t *AX, const Sample_t *AY, const Sample_t *AZ,
+	       const Sample_t *MX, const Sample_t *MY, const Sample_t *MZ,
+	       size_t n, Sample_t *X, Sample_t *Y, Sample_t *Z) const;
+
+    /*!
+     * Description: 
+     *   Horizontal intensity, declination and inclination (degrees)
+     *   from level frame components. 
+     */
+    static void HDI(const Sample_t *X, const Sample_t *Y, 
+		    const Sample_t *Z, size_t n, Sample_t *H, Sample_t *D,
+		    Sample_t *I);
+
+private:
+    bool fPerSample;
+};
+#endif
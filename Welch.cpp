@@ -0,0 +1,161 @@
+/********************************************************************
+ *
+ * Module Name : Welch.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Welch power spectral density with FFTW. 
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <cmath>
+#include <mutex>
+using namespace std;
+
+// Local Includes.
+#include "Welch.hh"
+
+/// FFTW planning is not thread safe, execution is. 
+static std::mutex PlanLock;
+
+/**
+ ******************************************************************
+ *
+ * Function Name : Welch constructor
+ *
+ * Description : Window and plan. FFTW_MEASURE takes a moment once
+ *               and pays back over a year of segments. 
+ *
+ * Inputs : Length     - samples per segment
+ *          Overlap    - fraction, 0 to 0.9
+ *          SampleRate - Hz
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Welch::Welch(uint32_t Length, double Overlap, double SampleRate)
+{
+    double U = 0.0;
+
+    fLength = (Length >= 16) ? Length : 16;
+    if (Overlap < 0.0) Overlap = 0.0;
+    if (Overlap > 0.9) Overlap = 0.9;
+    fStep   = (uint32_t) (fLength * (1.0 - Overlap));
+    if (fStep == 0) fStep = 1;
+    fRate   = (SampleRate > 0.0) ? SampleRate : 1.0;
+
+    fWindow.resize(fLength);
+    for (uint32_t i=0; i<fLength; i++)
+    {
+	fWindow[i] = 0.5 - 0.5*cos(2.0*M_PI*i/fLength);   // Hann
+	U += fWindow[i]*fWindow[i];
+    }
+    fNorm = 1.0/(fRate * U);
+
+    std::lock_guard<std::mutex> Lock(PlanLock);
+    double       *in  = (double *) fftw_malloc(sizeof(double)*fLength);
+    fftw_complex *out = (fftw_complex *) 
+	fftw_malloc(sizeof(fftw_complex)*NBins());
+    fPlan = fftw_plan_dft_r2c_1d(fLength, in, out, FFTW_MEASURE);
+    fftw_free(in);
+    fftw_free(out);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Welch destructor
+ *
+ * Description : 
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+Welch::~Welch(void)
+{
+    std::lock_guard<std::mutex> Lock(PlanLock);
+    fftw_destroy_plan(fPlan);
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Accumulate
+ *
+ * Description : Buffers come from fftw_malloc so they have the 
+ *               alignment the plan was made with. 
+ *
+ * Inputs : x   - series
+ *          n   - samples
+ *          Sum - NBins() values, added to
+ *
+ * Returns : segments used
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+uint32_t Welch::Accumulate(const double *x, size_t n, double *Sum) const
+{
+    const uint32_t NB  = NBins();
+    double       *in   = (double *) fftw_malloc(sizeof(double)*fLength);
+    fftw_complex *out  = (fftw_complex *) fftw_malloc(sizeof(fftw_complex)*NB);
+    uint32_t      NSeg = 0;
+    double        Mean, P;
+
+    for (size_t s=0; s+fLength <= n; s+=fStep)
+    {
+	Mean = 0.0;
+	for (uint32_t i=0; i<fLength; i++)
+	{
+	    Mean += x[s+i];
+	}
+	if (std::isnan(Mean)) continue;
+	Mean /= fLength;
+	for (uint32_t i=0; i<fLength; i++)
+	{
+	    in[i] = (x[s+i] - Mean) * fWindow[i];
+	}
+	fftw_execute_dft_r2c(fPlan, in, out);
+	for (uint32_t k=0; k<NB; k++)
+	{
+	    P = (out[k][0]*out[k][0] + out[k][1]*out[k][1]) * fNorm;
+	    // One sided, DC and Nyquist are not doubled. 
+	    if ((k > 0) && (2*k != fLength)) P *= 2.0;
+	    Sum[k] += P;
+	}
+	NSeg++;
+    }
+    fftw_free(in);
+    fftw_free(out);
+    return NSeg;
+}
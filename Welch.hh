@@ -0,0 +1,74 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : Welch.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Welch power spectral density. The series is cut 
+ * into Length sample segments with the given overlap, each is 
+ * mean removed, Hann windowed and transformed with one FFTW real
+ * to complex plan, and the periodograms are summed. The plan is 
+ * made once and used with the new array interface, so one Welch
+ * may be used from several threads at once, each with its own 
+ * output. 
+ *
+ * Restrictions/Limitations : Segments with a NaN are skipped. 
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ * P. Welch, "The use of fast Fourier transform for the estimation 
+ * of power spectra", IEEE Trans. Audio Electroacoustics 15, 1967.
+ *
+ *******************************************************************
+ */
+#ifndef __WELCH_hh_
+#define __WELCH_hh_
+#  include <stdint.h>
+#  include <stddef.h>
+#  include <vector>
+#  include <fftw3.h>
+
+class Welch
+{
+public:
+    /*!
+     * Length     - samples per segment
+     * Overlap    - fraction of a segment shared with the next
+     * SampleRate - Hz
+     */
+    Welch(uint32_t Length=4096, double Overlap=0.5, double SampleRate=1.0);
+    ~Welch(void);
+
+    /*!
+     * Description: 
+     *   Sum of the one sided periodograms of the segments of x, 
+     *   units^2/Hz. Divide by the count returned for the PSD. 
+     *   Thread safe. 
+     *
+     * Arguments:
+     *   x    - series
+     *   n    - samples in x
+     *   Sum  - NBins() values, added to
+     *
+     * Returns:
+     *   segments used
+     */
+    uint32_t Accumulate(const double *x, size_t n, double *Sum) const;
+
+    inline uint32_t Length(void)     const {return fLength;};
+    inline uint32_t NBins(void)      const {return fLength/2 + 1;};
+    inline double   Resolution(void) const {return fRate/fLength;};
+
+private:
+    uint32_t   fLength;
+    uint32_t   fStep;        // Samples between segment starts
+    double     fRate;
+    double     fNorm;        // 1/(fs * sum w^2)
+    std::vector<double> fWindow;
+    fftw_plan  fPlan;
+};
+#endif
@@ -0,0 +1,391 @@
+/********************************************************************
+ *
+ * Module Name : ZoneMap.cpp
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Per cluster min and max of IMUTuple columns.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ ********************************************************************/
+// System includes.
+#include <iostream>
+using namespace std;
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+// CERN root includes
+#include <TDirectory.h>
+#include <TFile.h>
+#include <TTree.h>
+#include <TLeaf.h>
+#include <TEntryList.h>
+#include <TString.h>
+
+// Local Includes.
+#include "debug.h"
+#include "CLogger.hh"
+#include "RowBlock.hh"
+#include "ZoneMap.hh"
+
+static const char *kZoneName[ZoneMap::kNZone] =
+{"JD", "DSEC", "MX", "MY", "MZ", "Temp", "MAG"};
+/// IMUTuple column of each zone column, MAG has none.
+static const uint32_t kZoneCol[ZoneMap::kNZone - 1] =
+{RowBlock::kJD, RowBlock::kDSEC, RowBlock::kMX, RowBlock::kMY,
+ RowBlock::kMZ, RowBlock::kTemp};
+
+/**
+ ******************************************************************
+ *
+ * Function Name : ZoneMap constructor
+ *
+ * Description : 
+ *
+ * Inputs : Cluster - entries per zone
+ *
+ * Returns : none
+ *
+ * Error Conditions : Cluster 0 is taken as 1
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+ZoneMap::ZoneMap(uint32_t Cluster)
+{
+    fCluster = (Cluster > 0) ? Cluster : 1;
+    Reset();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Reset
+ *
+ * Description : No zones, the next Fill is entry 0.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ZoneMap::Reset(void)
+{
+    fZone.clear();
+    fEntries    = 0;
+    fOutOfOrder = 0;
+    fLastJD     = -numeric_limits<double>::infinity();
+    Open();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Open
+ *
+ * Description : Start a zone at the next entry. The limits start
+ *               empty, Min above Max, which no cut overlaps.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ZoneMap::Open(void)
+{
+    fOpen.fFirst = fEntries;
+    fOpen.fN     = 0;
+    for (uint32_t c=0; c<kNZone; c++)
+    {
+	fOpen.fMin[c] =  numeric_limits<double>::infinity();
+	fOpen.fMax[c] = -numeric_limits<double>::infinity();
+    }
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Close
+ *
+ * Description : Keep the open zone and start the next one.
+ *
+ * Inputs : none
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ZoneMap::Close(void)
+{
+    fZone.push_back(fOpen);
+    Open();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Fill
+ *
+ * Description : Widen the open zone to take the row, close it when
+ *               it has Cluster entries.
+ *
+ * Inputs : row - IMUTuple row
+ *
+ * Returns : none
+ *
+ * Error Conditions : NaN columns are left out
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ZoneMap::Fill(const double *row)
+{
+    double V[kNZone];
+
+    for (uint32_t c=0; c<kMAG; c++) V[c] = row[kZoneCol[c]];
+    V[kMAG] = sqrt(V[kMX]*V[kMX] + V[kMY]*V[kMY] + V[kMZ]*V[kMZ]);
+    for (uint32_t c=0; c<kNZone; c++)
+    {
+	// False for NaN.
+	if (V[c] < fOpen.fMin[c]) fOpen.fMin[c] = V[c];
+	if (V[c] > fOpen.fMax[c]) fOpen.fMax[c] = V[c];
+    }
+    if (V[kJD] < fLastJD) fOutOfOrder++;
+    if (!std::isnan(V[kJD])) fLastJD = V[kJD];
+
+    fEntries++;
+    if (++fOpen.fN >= (int64_t) fCluster) Close();
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Rebuild
+ *
+ * Description : Zones of an ntuple already on disk. One pass over
+ *               the key columns only, read through the leaves so a
+ *               FLOAT32 tuple, float branches, reads the same.
+ *
+ * Inputs : Ntuple - IMUTuple
+ *
+ * Returns : none
+ *
+ * Error Conditions : none
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+void ZoneMap::Rebuild(TTree *Ntuple)
+{
+    SET_DEBUG_STACK;
+    double row[RowBlock::kNTupleCol];
+    TLeaf  *Leaf[kMAG];
+
+    Reset();
+    if (Ntuple == NULL) return;
+    memset(row, 0, sizeof(row));
+    Ntuple->SetBranchStatus("*", 0);
+    for (uint32_t c=0; c<kMAG; c++)
+    {
+	Ntuple->SetBranchStatus(kZoneName[c], 1);
+	Leaf[c] = Ntuple->GetLeaf(kZoneName[c]);
+	if (Leaf[c] == NULL)
+	{
+	    CLogger::GetThis()->Log("# Zones: no %s in %s.\n",
+				    kZoneName[c], Ntuple->GetName());
+	    Ntuple->SetBranchStatus("*", 1);
+	    return;
+	}
+    }
+    for (Long64_t i=0; i<Ntuple->GetEntries(); i++)
+    {
+	Ntuple->GetEntry(i);
+	for (uint32_t c=0; c<kMAG; c++)
+	    row[kZoneCol[c]] = Leaf[c]->GetValue();
+	Fill(row);
+    }
+    Ntuple->SetBranchStatus("*", 1);
+    CLogger::GetThis()->Log("# Zones rebuilt, %ld entries, %ld zones.\n",
+			    (long) fEntries, (long) fZone.size());
+    SET_DEBUG_STACK;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Write
+ *
+ * Description : IMUZones, the closed zones and the open one if it
+ *               has entries.
+ *
+ * Inputs : Dir - directory of the ntuple
+ *
+ * Returns : true if written
+ *
+ * Error Conditions : no directory
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+bool ZoneMap::Write(TDirectory *Dir)
+{
+    SET_DEBUG_STACK;
+    TDirectory *Save = gDirectory;
+    Zone        Z;
+    Long64_t    First, N;
+
+    if (Dir == NULL) return false;
+    Dir->cd();
+    Dir->Delete("IMUZones;*");
+    TTree *T = new TTree("IMUZones", "IMUTuple zone map");
+    T->Branch("First", &First, "First/L");
+    T->Branch("N"    , &N    , "N/L");
+    T->Branch("Min"  , Z.fMin, Form("Min[%d]/D", kNZone));
+    T->Branch("Max"  , Z.fMax, Form("Max[%d]/D", kNZone));
+    for (size_t i=0; i<=fZone.size(); i++)
+    {
+	Z = (i < fZone.size()) ? fZone[i] : fOpen;
+	if (Z.fN == 0) continue;
+	First = Z.fFirst;
+	N     = Z.fN;
+	T->Fill();
+    }
+    T->Write(0, TObject::kOverwrite);
+    CLogger::GetThis()->LogTime("Zones: %ld entries in %ld zones of %d, "
+				"%ld out of day order.\n", (long) fEntries,
+				(long) T->GetEntries(), fCluster,
+				(long) fOutOfOrder);
+    // Written, so the file Write does not add another cycle.
+    delete T;
+    Save->cd();
+    SET_DEBUG_STACK;
+    return true;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Column
+ *
+ * Description : 
+ *
+ * Inputs : Name - JD, DSEC, MX, MY, MZ, Temp or MAG
+ *
+ * Returns : zone column, or -1
+ *
+ * Error Conditions : case matters, as for the ntuple
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+int32_t ZoneMap::Column(const char *Name)
+{
+    for (int32_t c=0; c<kNZone; c++)
+    {
+	if (strcmp(Name, kZoneName[c]) == 0) return c;
+    }
+    return -1;
+}
+/**
+ ******************************************************************
+ *
+ * Function Name : Select
+ *
+ * Description : Every entry of each zone whose limits overlap all
+ *               of the cuts. The list is for IMUTuple in the file
+ *               Zones came from.
+ *
+ * Inputs : Zones - IMUZones
+ *          Cuts  - ranges
+ *          NPass - returned zones passed, if not NULL
+ *
+ * Returns : entry list
+ *
+ * Error Conditions : a cut on a column out of range is ignored
+ * 
+ * Unit Tested on: 
+ *
+ * Unit Tested by: CBL
+ *
+ *
+ *******************************************************************
+ */
+TEntryList* ZoneMap::Select(TTree *Zones, const vector<Cut> &Cuts,
+			    size_t *NPass)
+{
+    SET_DEBUG_STACK;
+    Long64_t First, N;
+    double   Min[kNZone], Max[kNZone];
+    size_t   Pass = 0;
+    bool     In;
+
+    TFile *f = Zones->GetCurrentFile();
+    TEntryList *List = new TEntryList("IMUZoneList", "Zones passed",
+				      "IMUTuple", f ? f->GetName() : "");
+    Zones->SetBranchAddress("First", &First);
+    Zones->SetBranchAddress("N"    , &N);
+    Zones->SetBranchAddress("Min"  , Min);
+    Zones->SetBranchAddress("Max"  , Max);
+    for (Long64_t i=0; i<Zones->GetEntries(); i++)
+    {
+	Zones->GetEntry(i);
+	In = true;
+	for (size_t k=0; In && (k<Cuts.size()); k++)
+	{
+	    const Cut &C = Cuts[k];
+	    if (C.fColumn >= kNZone) continue;
+	    In = (Min[C.fColumn] <= C.fMax) && (Max[C.fColumn] >= C.fMin);
+	}
+	if (!In) continue;
+	for (Long64_t j=First; j<First+N; j++) List->Enter(j);
+	Pass++;
+    }
+    Zones->ResetBranchAddresses();
+    if (NPass) *NPass = Pass;
+    SET_DEBUG_STACK;
+    return List;
+}
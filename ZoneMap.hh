@@ -0,0 +1,122 @@
+/**
+ ******************************************************************
+ *
+ * Module Name : ZoneMap.hh
+ *
+ * Author/Date : C.B. Lirakis / 19-Oct-26
+ *
+ * Description : Min and max of the key IMUTuple columns for each
+ * cluster of rows, so a selection on JD, DSEC, the field or Temp
+ * only reads the clusters that can pass it. IMUTuple is flushed
+ * every Cluster entries to match, so a zone is a cluster on disk.
+ *
+ * The zones are kept with the ntuple in IMUZones, one entry a zone,
+ *
+ *   First, N     first IMUTuple entry and the number of entries
+ *   Min, Max     kNZone each, JD DSEC MX MY MZ Temp MAG
+ *
+ * MAG, |M|, is not an IMUTuple column and is computed from MX, MY
+ * and MZ. NaN is left out of the limits.
+ *
+ * A zone spans only a few hours of time if the rows go in day
+ * order, which the date sorted manifest gives. Analysis runs the 
+ * files by date when Zones is on, LargestFirst is ignored. Rows 
+ * whose JD goes back, files that overlap, are counted so an out of
+ * order run shows up in the log.
+ *
+ * Restrictions/Limitations :
+ *
+ * Change Descriptions :
+ * 19-Oct-26 CBL Run by date with Zones on. 
+ *
+ * Classification : Unclassified
+ *
+ * References :
+ *
+ *******************************************************************
+ */
+#ifndef __ZONEMAP_hh_
+#define __ZONEMAP_hh_
+#  include <stdint.h>
+#  include <vector>
+
+class TTree;
+class TDirectory;
+class TEntryList;
+
+class ZoneMap {
+public:
+    enum {kJD=0, kDSEC, kMX, kMY, kMZ, kTemp, kMAG, kNZone};
+
+    /// One cluster of entries.
+    struct Zone {
+	int64_t fFirst, fN;
+	double  fMin[kNZone], fMax[kNZone];
+    };
+    /// Column in [Min, Max].
+    struct Cut {
+	uint32_t fColumn;
+	double   fMin, fMax;
+    };
+
+    /*!
+     * Cluster - entries in a zone, and the ntuple AutoFlush
+     */
+    ZoneMap(uint32_t Cluster=21600);
+
+    /// Empty, next entry is 0.
+    void Reset(void);
+    /*!
+     * Description:
+     *   Add the next ntuple entry.
+     *
+     * Arguments:
+     *   row - IMUTuple row, RowBlock::kNTupleCol columns
+     */
+    void Fill(const double *row);
+    /*!
+     * Description:
+     *   Zones for an ntuple that is already written, on resume.
+     *   Later Fills carry on from its last entry.
+     */
+    void Rebuild(TTree *Ntuple);
+    /*!
+     * Description:
+     *   Write IMUZones into Dir, replacing any there.
+     */
+    bool Write(TDirectory *Dir);
+
+    inline uint32_t Cluster(void)    const {return fCluster;};
+    inline size_t   NZones(void)     const {return fZone.size();};
+    inline int64_t  OutOfOrder(void) const {return fOutOfOrder;};
+
+    /// Zone column by name, JD etc, -1 if there is none.
+    static int32_t Column(const char *Name);
+    /*!
+     * Description:
+     *   Entries of the zones that could pass every cut. Set it on
+     *   IMUTuple before the Draw that applies the real selection.
+     *
+     * Arguments:
+     *   Zones - IMUZones tree
+     *   Cuts  - column ranges, all must overlap the zone
+     *   NPass - returned, zones that passed, or NULL
+     *
+     * Returns:
+     *   new entry list, owned by the caller
+     */
+    static TEntryList* Select(TTree *Zones, const std::vector<Cut> &Cuts,
+			      size_t *NPass=NULL);
+
+private:
+    void   Open(void);
+    void   Close(void);
+
+    uint32_t          fCluster;
+    int64_t           fEntries;      // Entries filled
+    int64_t           fOutOfOrder;   // Rows with JD before the last
+    double            fLastJD;
+    Zone              fOpen;         // Zone being filled
+    std::vector<Zone> fZone;         // Complete zones
+};
+#endif
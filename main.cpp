@@ -10,6 +10,7 @@
  * Restrictions/Limitations :
  *
  * Change Descriptions :
+ * 19-Oct-26 CBL -r/--resume, continue from the last checkpoint. 
  *
  * Classification : Unclassified
  *
@@ -24,6 +25,7 @@ using namespace std;
 #include <cmath>
 #include <csignal>
 #include <unistd.h>
+#include <getopt.h>
 #include <time.h>
 #include <fstream>
 #include <cstdlib>
@@ -39,6 +41,9 @@ using namespace std;
 /** Control the verbosity of the program output via the bits shown. */
 static unsigned int VerboseLevel = 0;
 
+/** Continue from the last checkpoint. */
+static bool Resume = false;
+
 /** Pointer to the logger structure. */
 static CLogger   *logger;
 
@@ -64,6 +69,7 @@ static void Help(void)
     cout << "* Test file for text Logging.              *" << endl;
     cout << "* Built on "<< __DATE__ << " " << __TIME__ << "*" << endl;
     cout << "* Available options are :                  *" << endl;
+    cout << "*  -r, --resume  continue from checkpoint  *" << endl;
     cout << "*                                          *" << endl;
     cout << "********************************************" << endl;
 }
@@ -92,10 +98,15 @@ static void
 ProcessCommandLineArgs(int argc, char **argv)
 {
     int option;
+    static struct option LongOptions[] = {
+	{"resume", no_argument, NULL, 'r'},
+	{"help"  , no_argument, NULL, 'h'},
+	{NULL    , 0          , NULL,  0 }
+    };
     SET_DEBUG_STACK;
     do
     {
-        option = getopt( argc, argv, "hHnv");
+        option = getopt_long( argc, argv, "hHnrv", LongOptions, NULL);
 //        option = getopt( argc, argv, "f:hHnv");
         switch(option)
         {
@@ -106,6 +117,9 @@ ProcessCommandLineArgs(int argc, char **argv)
             Help();
         Terminate(0);
         break;
+	case 'r':
+	    Resume = true;
+	    break;
 	case 'v':
 	    VerboseLevel = atoi(optarg);
             break;
@@ -181,7 +195,7 @@ int main(int argc, char **argv)
     ProcessCommandLineArgs(argc, argv);
     if (Initialize())
     {
-	Analysis *pModule = new Analysis("Analysis.cfg");
+	Analysis *pModule = new Analysis("Analysis.cfg", Resume);
 	if (pModule->Error() == 0)
 	{
 	    pModule->Do();